@@ -3,9 +3,14 @@
 #include "Engine/Window/Window.hpp"
 #include "Game.hpp"
 #include "Player.hpp"
+#include "Core/AllocationTracker.hpp"
+#include "Core/JobSystem.hpp"
 #include "Core/LoggerSubsystem.hpp"
+#include "Core/ProfilerSubsystem.hpp"
 #include "Core/WidgetSubsystem.hpp"
 #include "Core/Render/RenderSubsystem.hpp"
+#include "Module/Lib/BenchmarkCommon.hpp"
+#include "Module/Lib/DebugCommon.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/EngineCommon.hpp"
@@ -26,9 +31,11 @@ InputSystem*           g_theInput            = nullptr;
 AudioSystem*           g_theAudio            = nullptr;
 Game*                  g_theGame             = nullptr;
 RenderSubsystem*       g_theRenderSubsystem  = nullptr;
-LoggerSubsystem*       g_theLoggerSubsystem  = nullptr;
-WidgetSubsystem*       g_theWidgetSubsystem  = nullptr;
-NetworkSubsystem*      g_theNetworkSubsystem = nullptr;
+LoggerSubsystem*       g_theLoggerSubsystem   = nullptr;
+ProfilerSubsystem*     g_theProfilerSubsystem = nullptr;
+JobSystem*             g_theJobSystem         = nullptr;
+WidgetSubsystem*       g_theWidgetSubsystem   = nullptr;
+NetworkSubsystem*      g_theNetworkSubsystem  = nullptr;
 
 App::App()
 {
@@ -53,7 +60,16 @@ void App::Startup(char* commandLineString)
     m_consoleSpace.m_maxs = Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", 1600.f), g_gameConfigBlackboard.GetValue("screenSizeY", 800.f));
 
     LoggerConfig loggerConfig;
-    g_theLoggerSubsystem = new LoggerSubsystem(loggerConfig);
+    loggerConfig.m_binaryLogPath = g_gameConfigBlackboard.GetValue("binaryLogPath", std::string(""));
+    loggerConfig.m_textOutput    = g_gameConfigBlackboard.GetValue("logTextOutput", loggerConfig.m_textOutput);
+    g_theLoggerSubsystem         = new LoggerSubsystem(loggerConfig);
+
+    ProfilerConfig profilerConfig;
+    g_theProfilerSubsystem = new ProfilerSubsystem(profilerConfig);
+
+    JobSystemConfig jobSystemConfig;
+    jobSystemConfig.m_workerCount = g_gameConfigBlackboard.GetValue("jobWorkers", jobSystemConfig.m_workerCount);
+    g_theJobSystem                = new JobSystem(jobSystemConfig);
 
     EventSystemConfig eventSystemConfig;
     g_theEventSystem = new EventSystem(eventSystemConfig);
@@ -107,6 +123,8 @@ void App::Startup(char* commandLineString)
     g_theNetworkSubsystem = new NetworkSubsystem(networkConfig);
 
     g_theLoggerSubsystem->Startup();
+    g_theProfilerSubsystem->Startup();
+    g_theJobSystem->Startup();
     g_theEventSystem->Startup();
     g_theDevConsole->Startup();
     g_theInput->Startup();
@@ -120,6 +138,23 @@ void App::Startup(char* commandLineString)
 
     g_theGame = new Game();
     g_rng     = new RandomNumberGenerator();
+
+    // Headless benchmark run, "Benchmark name=all baseline=..." on the command line or benchmarkArgs in the game config
+    std::string commandLine   = commandLineString == nullptr ? "" : commandLineString;
+    std::string benchmarkArgs = g_gameConfigBlackboard.GetValue("benchmarkArgs", std::string(""));
+    if (commandLine.rfind("Benchmark", 0) == 0 && (commandLine.size() == 9 || commandLine[9] == ' '))
+    {
+        size_t first  = commandLine.find_first_not_of(' ', 9);
+        size_t last   = commandLine.find_last_not_of(' ');
+        benchmarkArgs = first == std::string::npos ? "name=all" : commandLine.substr(first, last - first + 1);
+    }
+    if (!benchmarkArgs.empty())
+    {
+        EventArgs args;
+        args.SetValue("args", benchmarkArgs);
+        m_exitCode   = BenchmarkCommon::Command_Benchmark(args) ? 0 : 1;
+        m_isQuitting = true;
+    }
 }
 
 void App::Shutdown()
@@ -142,6 +177,8 @@ void App::Shutdown()
     g_theWindow->Shutdown();
     g_theInput->Shutdown();
     g_theEventSystem->Shutdown();
+    g_theJobSystem->Shutdown();
+    g_theProfilerSubsystem->Shutdown();
     g_theLoggerSubsystem->Shutdown();
     // Destroy all Engine Subsystem
     delete g_theAudio;
@@ -168,12 +205,21 @@ void App::Shutdown()
     delete g_theEventSystem;
     g_theEventSystem = nullptr;
 
+    delete g_theJobSystem;
+    g_theJobSystem = nullptr;
+
+    delete g_theProfilerSubsystem;
+    g_theProfilerSubsystem = nullptr;
+
     delete g_theLoggerSubsystem;
     g_theLoggerSubsystem = nullptr;
 }
 
 void App::RunFrame()
 {
+    g_theProfilerSubsystem->BeginFrame(); // Captures start and end on frame boundaries
+    AllocationTracker::BeginFrame();
+    PROFILE_SCOPE("App::RunFrame");
     BeginFrame(); //Engine pre-frame stuff
     Update(); // Game updates / moves / spawns / hurts
     Render(); // Game draws current state of things
@@ -214,6 +260,11 @@ void App::HandleKeyBoardEvent()
     {
         m_isDebug = !m_isDebug;
     }
+    if (g_theInput->WasKeyJustPressed(0x72))
+    {
+        EventArgs args;
+        DebugCommon::Command_PerfHUD(args);
+    }
     if (g_theInput->WasKeyJustPressed(0x77))
     {
         m_isPendingRestart = true;
@@ -250,6 +301,7 @@ bool App::Event_ConsoleStartup(EventArgs& args)
                              "P       - Pause the Game\n"
                              "O       - Step single frame\n"
                              "T       - Toggle time scale between 0.1 and 1.0\n"
+                             "F3      - Toggle performance HUD\n"
                              "~       - Toggle Develop Console");
 
     return true;
@@ -336,6 +388,8 @@ void App::Render() const
 
 void App::EndFrame()
 {
+    g_theGame->EndFrame(); // Destroyed actors are freed once nothing of this frame can reach them
+    g_theRenderSubsystem->EndFrame();
     g_theWindow->EndFrame();
     g_theRenderer->EndFrame();
     g_theWidgetSubsystem->EndFrame();
@@ -45,6 +45,7 @@ public:
     bool  m_isSlowMo         = false;
     bool  m_isDebug          = false;
     bool  m_isPendingRestart = false;
+    int   m_exitCode         = 0; // Non zero when a headless benchmark run regressed
     Rgba8 m_backgroundColor  = Rgba8(0, 0, 0, 255);
 
     AABB2 m_consoleSpace;
@@ -0,0 +1,309 @@
+﻿#include "AABB3Packets.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define RAY_KERNEL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define RAY_KERNEL_AVX_TARGET
+#else
+#define RAY_KERNEL_AVX_TARGET __attribute__((target("avx")))
+#endif
+#else
+#define RAY_KERNEL_X86 0
+#endif
+
+namespace
+{
+    constexpr int CHUNK_PACKETS = 32; // RaycastNearest works through the packets with this many on the stack
+
+    /// Origin and inverse direction, an axis the ray runs parallel to gets a huge finite inverse instead of inf so the
+    /// slabs never compute 0 * inf
+    struct RaySetup
+    {
+        float m_origin[3];
+        float m_inverse[3];
+
+        RaySetup(const Vec3& origin, const Vec3& direction)
+        {
+            const float o[3] = {origin.x, origin.y, origin.z};
+            const float d[3] = {direction.x, direction.y, direction.z};
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                float component = d[axis] != 0.f ? d[axis] : 1e-30f;
+                m_origin[axis]  = o[axis];
+                m_inverse[axis] = 1.f / component;
+            }
+        }
+    };
+
+    ERaySimdLevel DetectSimdLevel()
+    {
+#if RAY_KERNEL_X86
+#if defined(_MSC_VER)
+        int info[4] = {};
+        __cpuid(info, 1);
+        bool hasAvx     = (info[2] & (1 << 28)) != 0;
+        bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6; // XSAVE enabled for the upper halves
+        return hasAvx && osSavesYmm ? ERaySimdLevel::AVX : ERaySimdLevel::SSE;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx") ? ERaySimdLevel::AVX : ERaySimdLevel::SSE;
+#endif
+#else
+        return ERaySimdLevel::SCALAR;
+#endif
+    }
+
+    const ERaySimdLevel        s_supportedLevel = DetectSimdLevel();
+    std::atomic<ERaySimdLevel> s_level{s_supportedLevel};
+
+    /// Slab test of one ray against one box, every kernel below is this lane by lane
+    float SlabScalar(const float* mins, const float* maxs, const float* origin, const float* inverse, float maxDistance)
+    {
+        float enter = 0.f;
+        float exit  = maxDistance;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float t0 = (mins[axis] - origin[axis]) * inverse[axis];
+            float t1 = (maxs[axis] - origin[axis]) * inverse[axis];
+            enter    = std::max(enter, std::min(t0, t1));
+            exit     = std::min(exit, std::max(t0, t1));
+        }
+        return enter <= exit ? enter : AABB3Packets::MISS;
+    }
+
+#if RAY_KERNEL_X86
+    inline __m128 SlabSse(const __m128 mins[3], const __m128 maxs[3], const __m128 origin[3], const __m128 inverse[3], __m128 maxDistance)
+    {
+        __m128 enter = _mm_setzero_ps();
+        __m128 exit  = maxDistance;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            __m128 t0 = _mm_mul_ps(_mm_sub_ps(mins[axis], origin[axis]), inverse[axis]);
+            __m128 t1 = _mm_mul_ps(_mm_sub_ps(maxs[axis], origin[axis]), inverse[axis]);
+            enter     = _mm_max_ps(enter, _mm_min_ps(t0, t1));
+            exit      = _mm_min_ps(exit, _mm_max_ps(t0, t1));
+        }
+        __m128 hit = _mm_cmple_ps(enter, exit);
+        return _mm_or_ps(_mm_and_ps(hit, enter), _mm_andnot_ps(hit, _mm_set1_ps(AABB3Packets::MISS)));
+    }
+
+    RAY_KERNEL_AVX_TARGET inline __m256 SlabAvx(const __m256 mins[3], const __m256 maxs[3], const __m256 origin[3], const __m256 inverse[3], __m256 maxDistance)
+    {
+        __m256 enter = _mm256_setzero_ps();
+        __m256 exit  = maxDistance;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            __m256 t0 = _mm256_mul_ps(_mm256_sub_ps(mins[axis], origin[axis]), inverse[axis]);
+            __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(maxs[axis], origin[axis]), inverse[axis]);
+            enter     = _mm256_max_ps(enter, _mm256_min_ps(t0, t1));
+            exit      = _mm256_min_ps(exit, _mm256_max_ps(t0, t1));
+        }
+        __m256 hit = _mm256_cmp_ps(enter, exit, _CMP_LE_OQ);
+        return _mm256_blendv_ps(_mm256_set1_ps(AABB3Packets::MISS), enter, hit);
+    }
+
+    void RaycastPacketsSse(const float* const planes[6], int firstLane, int laneCount, const RaySetup& ray, float maxDistance, float* outDistances)
+    {
+        const __m128 origin[3]  = {_mm_set1_ps(ray.m_origin[0]), _mm_set1_ps(ray.m_origin[1]), _mm_set1_ps(ray.m_origin[2])};
+        const __m128 inverse[3] = {_mm_set1_ps(ray.m_inverse[0]), _mm_set1_ps(ray.m_inverse[1]), _mm_set1_ps(ray.m_inverse[2])};
+        const __m128 distance   = _mm_set1_ps(maxDistance);
+        for (int lane = 0; lane < laneCount; lane += 4)
+        {
+            int    i       = firstLane + lane;
+            __m128 mins[3] = {_mm_loadu_ps(planes[0] + i), _mm_loadu_ps(planes[1] + i), _mm_loadu_ps(planes[2] + i)};
+            __m128 maxs[3] = {_mm_loadu_ps(planes[3] + i), _mm_loadu_ps(planes[4] + i), _mm_loadu_ps(planes[5] + i)};
+            _mm_storeu_ps(outDistances + lane, SlabSse(mins, maxs, origin, inverse, distance));
+        }
+    }
+
+    RAY_KERNEL_AVX_TARGET void RaycastPacketsAvx(const float* const planes[6], int firstLane, int laneCount, const RaySetup& ray, float maxDistance, float* outDistances)
+    {
+        const __m256 origin[3]  = {_mm256_set1_ps(ray.m_origin[0]), _mm256_set1_ps(ray.m_origin[1]), _mm256_set1_ps(ray.m_origin[2])};
+        const __m256 inverse[3] = {_mm256_set1_ps(ray.m_inverse[0]), _mm256_set1_ps(ray.m_inverse[1]), _mm256_set1_ps(ray.m_inverse[2])};
+        const __m256 distance   = _mm256_set1_ps(maxDistance);
+        for (int lane = 0; lane < laneCount; lane += 8)
+        {
+            int    i       = firstLane + lane;
+            __m256 mins[3] = {_mm256_loadu_ps(planes[0] + i), _mm256_loadu_ps(planes[1] + i), _mm256_loadu_ps(planes[2] + i)};
+            __m256 maxs[3] = {_mm256_loadu_ps(planes[3] + i), _mm256_loadu_ps(planes[4] + i), _mm256_loadu_ps(planes[5] + i)};
+            _mm256_storeu_ps(outDistances + lane, SlabAvx(mins, maxs, origin, inverse, distance));
+        }
+    }
+
+    /// Eight rays transposed into lanes, the box broadcast
+    void RaycastRaysSse(const float box[6], const float rays[6][AABB3Packets::LANES], float maxDistance, float* outDistances)
+    {
+        const __m128 mins[3]  = {_mm_set1_ps(box[0]), _mm_set1_ps(box[1]), _mm_set1_ps(box[2])};
+        const __m128 maxs[3]  = {_mm_set1_ps(box[3]), _mm_set1_ps(box[4]), _mm_set1_ps(box[5])};
+        const __m128 distance = _mm_set1_ps(maxDistance);
+        for (int lane = 0; lane < AABB3Packets::LANES; lane += 4)
+        {
+            __m128 origin[3]  = {_mm_loadu_ps(rays[0] + lane), _mm_loadu_ps(rays[1] + lane), _mm_loadu_ps(rays[2] + lane)};
+            __m128 inverse[3] = {_mm_loadu_ps(rays[3] + lane), _mm_loadu_ps(rays[4] + lane), _mm_loadu_ps(rays[5] + lane)};
+            _mm_storeu_ps(outDistances + lane, SlabSse(mins, maxs, origin, inverse, distance));
+        }
+    }
+
+    RAY_KERNEL_AVX_TARGET void RaycastRaysAvx(const float box[6], const float rays[6][AABB3Packets::LANES], float maxDistance, float* outDistances)
+    {
+        const __m256 mins[3]    = {_mm256_set1_ps(box[0]), _mm256_set1_ps(box[1]), _mm256_set1_ps(box[2])};
+        const __m256 maxs[3]    = {_mm256_set1_ps(box[3]), _mm256_set1_ps(box[4]), _mm256_set1_ps(box[5])};
+        const __m256 origin[3]  = {_mm256_loadu_ps(rays[0]), _mm256_loadu_ps(rays[1]), _mm256_loadu_ps(rays[2])};
+        const __m256 inverse[3] = {_mm256_loadu_ps(rays[3]), _mm256_loadu_ps(rays[4]), _mm256_loadu_ps(rays[5])};
+        _mm256_storeu_ps(outDistances, SlabAvx(mins, maxs, origin, inverse, _mm256_set1_ps(maxDistance)));
+    }
+#endif
+}
+
+void AABB3Packets::Clear()
+{
+    for (std::vector<float>* plane : {&m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ})
+    {
+        plane->clear();
+    }
+    m_count = 0;
+}
+
+void AABB3Packets::Resize(int count)
+{
+    int padded = (count + LANES - 1) / LANES * LANES;
+    for (std::vector<float>* plane : {&m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ})
+    {
+        plane->resize(padded, MISS);
+        std::fill(plane->begin() + count, plane->end(), MISS); // Lanes dropped by a shrink must not hit again
+    }
+    m_count = count;
+}
+
+void AABB3Packets::Set(int index, const AABB3& box)
+{
+    m_minX[index] = box.m_mins.x;
+    m_minY[index] = box.m_mins.y;
+    m_minZ[index] = box.m_mins.z;
+    m_maxX[index] = box.m_maxs.x;
+    m_maxY[index] = box.m_maxs.y;
+    m_maxZ[index] = box.m_maxs.z;
+}
+
+int AABB3Packets::Add(const AABB3& box)
+{
+    int index = m_count;
+    Resize(m_count + 1);
+    Set(index, box);
+    return index;
+}
+
+void AABB3Packets::Raycast(const Vec3& origin, const Vec3& direction, float maxDistance, float* outDistances, int firstPacket, int packetCount) const
+{
+    if (packetCount < 0) packetCount = GetPacketCount() - firstPacket;
+    if (packetCount <= 0) return;
+
+    RaySetup           ray(origin, direction);
+    const float* const planes[6] = {m_minX.data(), m_minY.data(), m_minZ.data(), m_maxX.data(), m_maxY.data(), m_maxZ.data()};
+    int                firstLane = firstPacket * LANES;
+    int                laneCount = packetCount * LANES;
+    switch (s_level.load(std::memory_order_relaxed))
+    {
+#if RAY_KERNEL_X86
+    case ERaySimdLevel::AVX:
+        RaycastPacketsAvx(planes, firstLane, laneCount, ray, maxDistance, outDistances);
+        return;
+    case ERaySimdLevel::SSE:
+        RaycastPacketsSse(planes, firstLane, laneCount, ray, maxDistance, outDistances);
+        return;
+#endif
+    default:
+        for (int lane = 0; lane < laneCount; ++lane)
+        {
+            int   i            = firstLane + lane;
+            float mins[3]      = {m_minX[i], m_minY[i], m_minZ[i]};
+            float maxs[3]      = {m_maxX[i], m_maxY[i], m_maxZ[i]};
+            outDistances[lane] = SlabScalar(mins, maxs, ray.m_origin, ray.m_inverse, maxDistance);
+        }
+        return;
+    }
+}
+
+int AABB3Packets::RaycastNearest(const Vec3& origin, const Vec3& direction, float maxDistance, float& outDistance) const
+{
+    float distances[CHUNK_PACKETS * LANES];
+    int   nearest = -1;
+    outDistance   = maxDistance;
+    for (int first = 0; first < GetPacketCount(); first += CHUNK_PACKETS)
+    {
+        int count = std::min(CHUNK_PACKETS, GetPacketCount() - first);
+        Raycast(origin, direction, outDistance, distances, first, count); // Each chunk only looks nearer than the last hit
+        for (int lane = 0; lane < count * LANES; ++lane)
+        {
+            if (distances[lane] < outDistance)
+            {
+                outDistance = distances[lane];
+                nearest     = first * LANES + lane;
+            }
+        }
+    }
+    return nearest;
+}
+
+void AABB3Packets::RaycastBox(const AABB3& box, const Vec3* origins, const Vec3* directions, int rayCount, float maxDistance, float* outDistances)
+{
+    const float   planes[6] = {box.m_mins.x, box.m_mins.y, box.m_mins.z, box.m_maxs.x, box.m_maxs.y, box.m_maxs.z};
+    ERaySimdLevel level     = s_level.load(std::memory_order_relaxed);
+    for (int first = 0; first < rayCount; first += LANES)
+    {
+        // Transposed eight rays at a time, a short last group repeats its final ray
+        float rays[6][LANES];
+        float distances[LANES];
+        int   count = std::min(LANES, rayCount - first);
+        for (int lane = 0; lane < LANES; ++lane)
+        {
+            RaySetup ray(origins[first + std::min(lane, count - 1)], directions[first + std::min(lane, count - 1)]);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                rays[axis][lane]     = ray.m_origin[axis];
+                rays[axis + 3][lane] = ray.m_inverse[axis];
+            }
+        }
+
+        switch (level)
+        {
+#if RAY_KERNEL_X86
+        case ERaySimdLevel::AVX:
+            RaycastRaysAvx(planes, rays, maxDistance, distances);
+            break;
+        case ERaySimdLevel::SSE:
+            RaycastRaysSse(planes, rays, maxDistance, distances);
+            break;
+#endif
+        default:
+            for (int lane = 0; lane < count; ++lane)
+            {
+                float origin[3]  = {rays[0][lane], rays[1][lane], rays[2][lane]};
+                float inverse[3] = {rays[3][lane], rays[4][lane], rays[5][lane]};
+                distances[lane]  = SlabScalar(planes, planes + 3, origin, inverse, maxDistance);
+            }
+            break;
+        }
+        std::copy(distances, distances + count, outDistances + first);
+    }
+}
+
+ERaySimdLevel AABB3Packets::GetSimdLevel()
+{
+    return s_level.load(std::memory_order_relaxed);
+}
+
+ERaySimdLevel AABB3Packets::GetSupportedSimdLevel()
+{
+    return s_supportedLevel;
+}
+
+void AABB3Packets::SetSimdLevel(ERaySimdLevel level)
+{
+    s_level.store(level > s_supportedLevel ? s_supportedLevel : level, std::memory_order_relaxed);
+}
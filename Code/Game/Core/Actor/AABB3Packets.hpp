@@ -0,0 +1,56 @@
+﻿#pragma once
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+/// Widest ray kernel the CPU runs, picked once at startup
+enum class ERaySimdLevel : uint8_t
+{
+    SCALAR,
+    SSE,
+    AVX
+};
+
+/// AABB3Packets ― Boxes packed eight to a packet with separate min and max arrays per axis, the layout the ray kernels
+/// load straight into SIMD registers. A ray is tested against a whole packet at once, AVX takes it in one pass and SSE
+/// in two. Unused lanes hold a box out at FLT_MAX that no ray reaches.
+class AABB3Packets
+{
+public:
+    static constexpr int   LANES = 8;
+    static constexpr float MISS  = FLT_MAX;
+
+    void Clear();
+    void Resize(int count); // New boxes are unused lanes until Set
+    void Set(int index, const AABB3& box);
+    int  Add(const AABB3& box);
+
+    int Size() const { return m_count; }
+    int GetPacketCount() const { return static_cast<int>(m_minX.size()) / LANES; }
+
+    /// Distance where the ray enters each box of packetCount packets from firstPacket, MISS for the boxes it misses
+    /// within maxDistance. outDistances holds LANES floats per packet, -1 tests every packet.
+    void Raycast(const Vec3& origin, const Vec3& direction, float maxDistance, float* outDistances, int firstPacket = 0, int packetCount = -1) const;
+
+    /// Index of the nearest box, -1 when the ray misses all of them
+    int RaycastNearest(const Vec3& origin, const Vec3& direction, float maxDistance, float& outDistance) const;
+
+    /// The other way round, rayCount rays against one box, outDistances[i] for ray i
+    static void RaycastBox(const AABB3& box, const Vec3* origins, const Vec3* directions, int rayCount, float maxDistance, float* outDistances);
+
+    static ERaySimdLevel GetSimdLevel();
+    static ERaySimdLevel GetSupportedSimdLevel();
+    static void          SetSimdLevel(ERaySimdLevel level); // Clamped to the supported level, for benchmarks
+
+private:
+    std::vector<float> m_minX;
+    std::vector<float> m_minY;
+    std::vector<float> m_minZ;
+    std::vector<float> m_maxX;
+    std::vector<float> m_maxY;
+    std::vector<float> m_maxZ;
+    int                m_count = 0;
+};
@@ -2,6 +2,7 @@
 
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Math/Mat44.hpp"
+#include "TransformPool.hpp"
 #include "Game/Core/Component/Component.hpp"
 Actor::ActorID Actor::s_nextID = 0;
 
@@ -60,6 +61,21 @@ void Actor::SetParent(Actor* newParent)
     // Logic such as updating the level Transform can be handled here
 }
 
+void Actor::RefillComponentSlot(int typeID)
+{
+    m_componentSlots[typeID] = nullptr;
+    m_componentMask &= ~(1u << typeID);
+    for (const ComponentPtr& comp : m_components)
+    {
+        if (comp->GetTypeID() == typeID)
+        {
+            m_componentSlots[typeID] = comp.get();
+            m_componentMask |= 1u << typeID;
+            return;
+        }
+    }
+}
+
 Actor* Actor::CreateChild()
 {
     auto child = std::make_unique<Actor>();
@@ -81,6 +97,26 @@ Actor* Actor::FromXML(const XmlElement& element)
 }
 
 Mat44 Actor::GetModelToWorldTransform()
+{
+    if (m_transformPool && m_transformPool->IsCurrent(m_transformIndex))
+    {
+        return m_transformPool->GetWorldTransform(m_transformIndex);
+    }
+    Mat44 transform = m_parent ? m_parent->GetModelToWorldTransform() : Mat44();
+    transform.Append(GetLocalTransform());
+    return transform;
+}
+
+Mat44 Actor::GetRenderTransform()
+{
+    if (m_transformPool)
+    {
+        return m_transformPool->GetWorldTransform(m_transformIndex); // The match updates its pool after the last actor moved
+    }
+    return GetModelToWorldTransform();
+}
+
+Mat44 Actor::GetLocalTransform() const
 {
     Mat44 matTranslation = Mat44::MakeTranslation3D(m_position);
     matTranslation.Append(m_orientation.GetAsMatrix_IFwd_JLeft_KUp());
@@ -1,26 +1,55 @@
 ﻿#pragma once
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/XmlUtils.hpp"
 #include "Engine/Math/EulerAngles.hpp"
 #include "Engine/Math/Vec3.hpp"
+#include "Game/Core/ObjectArena.hpp"
 
 struct Mat44;
 class IComponent;
+class TransformPool;
+
+/// One bit per Actor class that ActorCast can query, a class sets its own bit on top of the ones of its bases
+enum class EActorKind : uint8_t
+{
+    ACTOR,
+    CHESS_OBJECT,
+    CHESS_PIECE,
+    CHESS_BOARD,
+    CHESS_PLAYER,
+    TEST_MODEL,
+};
 
 ///  Actor ― The entity that owns a set of Components
 class Actor
 {
+    friend class TransformPool;
+
 public:
+    static constexpr EActorKind KIND = EActorKind::ACTOR;
+
     Actor();
     virtual ~Actor();
 
+    /// From the ObjectArena of the current scope, the heap outside of one
+    static void* operator new(size_t size) { return ObjectArena::AllocateObject(size); }
+    static void  operator delete(void* memory) { ObjectArena::FreeObject(memory); }
+
+    /// Component type ids index m_componentSlots, one bit of m_componentMask each
+    static constexpr int MAX_COMPONENT_TYPES = 32;
+
     /// Component management
     template <typename T, typename... Args>
     T* AddComponent(Args&&... args)
     {
         static_assert(std::is_base_of_v<IComponent, T>, "T must derive from IComponent");
+        const auto id = T::TypeID();
+        GUARANTEE_OR_DIE(id < MAX_COMPONENT_TYPES, "Actor::AddComponent, raise MAX_COMPONENT_TYPES for more component classes");
 
         // TODO: uniqueness check
         // if constexpr (T::IsUnique) { ... }
@@ -32,35 +61,46 @@ public:
         raw->OnAttach(*this);
         m_components.emplace_back(std::move(comp));
 
+        // The slot keeps the first component of a type, the one a linear scan would find
+        if (!m_componentSlots[id])
+        {
+            m_componentSlots[id] = raw;
+            m_componentMask |= 1u << id;
+        }
         return raw;
     }
 
     template <typename T>
     T* GetComponent() const
     {
-        for (const auto& c : m_components)
-            if (c->GetTypeID() == T::TypeID())
-                return static_cast<T*>(c.get());
-        return nullptr;
+        const auto id = T::TypeID();
+        if (id >= MAX_COMPONENT_TYPES) return nullptr; // Never added, AddComponent dies on such ids
+        return static_cast<T*>(m_componentSlots[id]);
     }
 
     template <typename T>
     bool HasComponent() const
     {
-        return GetComponent<T>() != nullptr;
+        const auto id = T::TypeID();
+        if (id >= MAX_COMPONENT_TYPES) return false;
+        return (m_componentMask >> id) & 1u;
     }
 
+    uint32_t GetComponentMask() const { return m_componentMask; }
 
     template <typename T>
     bool RemoveComponent()
     {
         const auto id = T::TypeID();
-        auto       it = std::find_if(m_components.begin(), m_components.end(),
-                               [id](const auto& p) { return p->GetTypeID() == id; });
-        if (it == m_components.end()) return false;
+        if (id >= MAX_COMPONENT_TYPES) return false;
+
+        IComponent* slot = m_componentSlots[id];
+        if (!slot) return false;
 
+        auto it = std::find_if(m_components.begin(), m_components.end(), [slot](const auto& p) { return p.get() == slot; });
         (*it)->OnDetach();
         m_components.erase(it);
+        RefillComponentSlot(id);
         return true;
     }
 
@@ -85,20 +125,31 @@ public:
     /// Identity
     using ActorID = unsigned int;
     ActorID GetID() const { return m_id; }
+    bool    IsKind(EActorKind kind) const { return (m_kindMask >> static_cast<int>(kind)) & 1u; }
 
     /// Serialization
     virtual XmlElement* ToXML() const;
     virtual Actor*      FromXML(const XmlElement& element);
 
     /// Transform
-    Mat44 GetModelToWorldTransform();
+    Mat44 GetModelToWorldTransform(); // Cached by the TransformPool holding the actor, composed with the parents
+    Mat44 GetRenderTransform(); // Render submission, the pool's matrix as of its last Update without any check
+    Mat44 GetLocalTransform() const;
 
     Vec3        m_position;
     EulerAngles m_orientation;
 
+protected:
+    void AddKind(EActorKind kind) { m_kindMask |= 1u << static_cast<int>(kind); } // Called by the constructor of every kind
+
 private:
     using ComponentPtr = std::unique_ptr<IComponent>;
     std::vector<ComponentPtr> m_components;
+    IComponent*               m_componentSlots[MAX_COMPONENT_TYPES] = {}; // First component of each type, owned by m_components
+    uint32_t                  m_componentMask                       = 0;
+
+    /// Points the slot at the next component of the type after a removal, only actors holding duplicates find one
+    void RefillComponentSlot(int typeID);
 
     // Transform can also be split into separate components; placeholders are reserved here
     // TransformComponent* m_transform = nullptr;
@@ -106,9 +157,28 @@ private:
     std::vector<std::unique_ptr<Actor>> m_children;
     Actor*                              m_parent = nullptr;
 
+    TransformPool* m_transformPool  = nullptr;
+    int            m_transformIndex = -1;
+
     ActorID        m_id;
     static ActorID s_nextID;
+    uint32_t       m_kindMask = 1u << static_cast<int>(EActorKind::ACTOR);
     bool           m_isInitialized = false;
     bool           m_isGarbage     = false;
     bool           m_isEnable      = true;
 };
+
+/// dynamic_cast for the Actor hierarchy as a bit test, T declares its KIND and sets it with AddKind
+template <typename T>
+T* ActorCast(Actor* actor)
+{
+    static_assert(std::is_base_of_v<Actor, T>, "T must derive from Actor");
+    return actor && actor->IsKind(T::KIND) ? static_cast<T*>(actor) : nullptr;
+}
+
+template <typename T>
+const T* ActorCast(const Actor* actor)
+{
+    static_assert(std::is_base_of_v<Actor, T>, "T must derive from Actor");
+    return actor && actor->IsKind(T::KIND) ? static_cast<const T*>(actor) : nullptr;
+}
@@ -0,0 +1,149 @@
+﻿#include "BoundingVolumeHierarchy.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    void Enclose(AABB3& bounds, const AABB3& box)
+    {
+        bounds.m_mins = Vec3(std::min(bounds.m_mins.x, box.m_mins.x), std::min(bounds.m_mins.y, box.m_mins.y), std::min(bounds.m_mins.z, box.m_mins.z));
+        bounds.m_maxs = Vec3(std::max(bounds.m_maxs.x, box.m_maxs.x), std::max(bounds.m_maxs.y, box.m_maxs.y), std::max(bounds.m_maxs.z, box.m_maxs.z));
+    }
+}
+
+void BoundingVolumeHierarchy::Build(const AABB3* boxes, int count)
+{
+    Clear();
+    if (count <= 0) return;
+
+    m_boxes.assign(boxes, boxes + count);
+    m_items.resize(count);
+    m_centers.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        m_items[i]   = i;
+        m_centers[i] = (boxes[i].m_mins + boxes[i].m_maxs) * 0.5f;
+    }
+    m_nodes.reserve(2 * (count / LEAF_SIZE + 1));
+    m_nodes.emplace_back();
+    BuildNode(0, 0, count, 0);
+
+    int leaves = 0;
+    for (Node& node : m_nodes)
+    {
+        if (node.m_count > 0) node.m_packet = leaves++;
+    }
+    m_leafPackets.Resize(leaves * AABB3Packets::LANES);
+    PackLeaves();
+}
+
+void BoundingVolumeHierarchy::Refit(const AABB3* boxes)
+{
+    m_boxes.assign(boxes, boxes + m_boxes.size());
+    PackLeaves();
+    for (int i = GetNodeCount() - 1; i >= 0; --i)
+    {
+        GrowBounds(m_nodes[i]);
+    }
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+    m_nodes.clear();
+    m_items.clear();
+    m_boxes.clear();
+    m_centers.clear();
+    m_leafPackets.Clear();
+}
+
+void BoundingVolumeHierarchy::BuildNode(int nodeIndex, int first, int count, int depth)
+{
+    if (count <= LEAF_SIZE || depth >= MAX_DEPTH - 1)
+    {
+        m_nodes[nodeIndex].m_first = first;
+        m_nodes[nodeIndex].m_count = count;
+        GrowBounds(m_nodes[nodeIndex]);
+        return;
+    }
+
+    // Split the item range at the median center along the axis the centers spread the most
+    Vec3 mins = m_centers[m_items[first]];
+    Vec3 maxs = mins;
+    for (int i = first + 1; i < first + count; ++i)
+    {
+        const Vec3& center = m_centers[m_items[i]];
+        mins               = Vec3(std::min(mins.x, center.x), std::min(mins.y, center.y), std::min(mins.z, center.z));
+        maxs               = Vec3(std::max(maxs.x, center.x), std::max(maxs.y, center.y), std::max(maxs.z, center.z));
+    }
+    Vec3 extent = maxs - mins;
+    int  axis   = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    int  half   = count / 2;
+    std::nth_element(m_items.begin() + first, m_items.begin() + first + half, m_items.begin() + first + count, [this, axis](int lhs, int rhs)
+    {
+        const Vec3& a = m_centers[lhs];
+        const Vec3& b = m_centers[rhs];
+        return axis == 0 ? a.x < b.x : (axis == 1 ? a.y < b.y : a.z < b.z);
+    });
+
+    // Siblings are added together, m_nodes may grow so only indices are kept across the recursion
+    int left                   = GetNodeCount();
+    m_nodes[nodeIndex].m_first = left;
+    m_nodes[nodeIndex].m_count = 0;
+    m_nodes.emplace_back();
+    m_nodes.emplace_back();
+    BuildNode(left, first, half, depth + 1);
+    BuildNode(left + 1, first + half, count - half, depth + 1);
+    GrowBounds(m_nodes[nodeIndex]);
+}
+
+void BoundingVolumeHierarchy::GrowBounds(Node& node) const
+{
+    if (node.m_count > 0)
+    {
+        node.m_bounds = m_boxes[m_items[node.m_first]];
+        for (int i = node.m_first + 1; i < node.m_first + node.m_count; ++i)
+        {
+            Enclose(node.m_bounds, m_boxes[m_items[i]]);
+        }
+        return;
+    }
+    node.m_bounds = m_nodes[node.m_first].m_bounds;
+    Enclose(node.m_bounds, m_nodes[node.m_first + 1].m_bounds);
+}
+
+void BoundingVolumeHierarchy::PackLeaves()
+{
+    for (const Node& node : m_nodes)
+    {
+        for (int lane = 0; lane < node.m_count; ++lane)
+        {
+            m_leafPackets.Set(node.m_packet * AABB3Packets::LANES + lane, m_boxes[m_items[node.m_first + lane]]);
+        }
+    }
+}
+
+bool BoundingVolumeHierarchy::EnterDistance(const AABB3& box, const Vec3& origin, const Vec3& inverseDirection, float maxDistance, float& outEnter)
+{
+    float enter  = 0.f;
+    float exit   = maxDistance;
+    float o[3]   = {origin.x, origin.y, origin.z};
+    float inv[3] = {inverseDirection.x, inverseDirection.y, inverseDirection.z};
+    float lo[3]  = {box.m_mins.x, box.m_mins.y, box.m_mins.z};
+    float hi[3]  = {box.m_maxs.x, box.m_maxs.y, box.m_maxs.z};
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float t0 = (lo[axis] - o[axis]) * inv[axis];
+        float t1 = (hi[axis] - o[axis]) * inv[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 != t0 || t1 != t1) // Parallel to the slab with the origin on its plane, 0 * inf
+        {
+            if (o[axis] < lo[axis] || o[axis] > hi[axis]) return false;
+            continue;
+        }
+        enter = std::max(enter, t0);
+        exit  = std::min(exit, t1);
+        if (enter > exit) return false;
+    }
+    outEnter = enter;
+    return true;
+}
@@ -0,0 +1,114 @@
+﻿#pragma once
+#include <vector>
+
+#include "AABB3Packets.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+/// BoundingVolumeHierarchy ― Binary tree of bounds over a set of boxes for ray queries in arbitrary scenes. Build splits
+/// at the median of the longest axis, Refit only grows the bounds again after the same boxes moved. Items are the
+/// indices of the boxes given to Build. A leaf holds one packet of boxes the ray kernel tests at once.
+class BoundingVolumeHierarchy
+{
+public:
+    static constexpr int LEAF_SIZE = AABB3Packets::LANES;
+
+    void Build(const AABB3* boxes, int count);
+    void Refit(const AABB3* boxes); // Same count and order as the last Build
+    void Clear();
+
+    int          GetItemCount() const { return static_cast<int>(m_boxes.size()); }
+    int          GetNodeCount() const { return static_cast<int>(m_nodes.size()); }
+    const AABB3& GetBox(int item) const { return m_boxes[item]; }
+
+    /// Nearest item the ray hits within maxDistance that accept(item) allows, -1 for none
+    template <typename Accept>
+    int Raycast(const Vec3& origin, const Vec3& direction, float maxDistance, RaycastResult3D& outResult, Accept&& accept) const;
+
+private:
+    struct Node
+    {
+        AABB3 m_bounds;
+        int   m_first  = 0; // First of m_items for a leaf, the left child otherwise, the right one follows it
+        int   m_count  = 0; // 0 for an inner node
+        int   m_packet = -1; // Of m_leafPackets, lane i is item m_items[m_first + i]
+    };
+
+    static constexpr int MAX_DEPTH = 64;
+
+    std::vector<Node>  m_nodes; // Children always after their parent
+    std::vector<int>   m_items; // Leaf ranges point in here
+    std::vector<AABB3> m_boxes;
+    std::vector<Vec3>  m_centers; // Only used by Build
+    AABB3Packets       m_leafPackets;
+
+    void BuildNode(int nodeIndex, int first, int count, int depth);
+    void GrowBounds(Node& node) const;
+    void PackLeaves();
+
+    /// Slab test, the distance where the ray enters the box or false
+    static bool EnterDistance(const AABB3& box, const Vec3& origin, const Vec3& inverseDirection, float maxDistance, float& outEnter);
+};
+
+template <typename Accept>
+int BoundingVolumeHierarchy::Raycast(const Vec3& origin, const Vec3& direction, float maxDistance, RaycastResult3D& outResult, Accept&& accept) const
+{
+    if (m_nodes.empty()) return -1;
+
+    Vec3  inverseDirection(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+    int   stack[MAX_DEPTH * 2];
+    int   stackSize = 0;
+    int   hitItem   = -1;
+    float enter     = 0.f;
+    if (!EnterDistance(m_nodes[0].m_bounds, origin, inverseDirection, maxDistance, enter)) return -1;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const Node& node = m_nodes[stack[--stackSize]];
+        if (!EnterDistance(node.m_bounds, origin, inverseDirection, maxDistance, enter)) continue; // maxDistance shrank since the push
+
+        if (node.m_count > 0)
+        {
+            // The kernel culls the whole packet, only the boxes it enters get the exact test
+            float distances[AABB3Packets::LANES];
+            m_leafPackets.Raycast(origin, direction, maxDistance, distances, node.m_packet, 1);
+            for (int lane = 0; lane < node.m_count; ++lane)
+            {
+                if (distances[lane] == AABB3Packets::MISS) continue;
+                int item = m_items[node.m_first + lane];
+                if (!accept(item)) continue;
+                AABB3           box    = m_boxes[item];
+                RaycastResult3D result = box.Raycast(origin, direction, maxDistance);
+                if (result.m_didImpact && result.m_impactDist < maxDistance)
+                {
+                    maxDistance = result.m_impactDist;
+                    outResult   = result;
+                    hitItem     = item;
+                }
+            }
+            continue;
+        }
+
+        // The nearer child is popped first so it can shorten the ray for the other one
+        float enterLeft  = 0.f;
+        float enterRight = 0.f;
+        bool  hitLeft    = EnterDistance(m_nodes[node.m_first].m_bounds, origin, inverseDirection, maxDistance, enterLeft);
+        bool  hitRight   = EnterDistance(m_nodes[node.m_first + 1].m_bounds, origin, inverseDirection, maxDistance, enterRight);
+        if (hitLeft && hitRight)
+        {
+            bool leftFirst     = enterLeft <= enterRight;
+            stack[stackSize++] = leftFirst ? node.m_first + 1 : node.m_first;
+            stack[stackSize++] = leftFirst ? node.m_first : node.m_first + 1;
+        }
+        else if (hitLeft)
+        {
+            stack[stackSize++] = node.m_first;
+        }
+        else if (hitRight)
+        {
+            stack[stackSize++] = node.m_first + 1;
+        }
+    }
+    return hitItem;
+}
@@ -0,0 +1,23 @@
+﻿#include "EntityRegistry.hpp"
+
+void EntityRegistry::RemoveEntity(Actor::ActorID id)
+{
+    for (const std::unique_ptr<IEntityStorage>& storage : m_storages)
+    {
+        if (storage)
+        {
+            storage->Remove(id);
+        }
+    }
+}
+
+void EntityRegistry::Clear()
+{
+    for (const std::unique_ptr<IEntityStorage>& storage : m_storages)
+    {
+        if (storage)
+        {
+            storage->Clear();
+        }
+    }
+}
@@ -0,0 +1,197 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Actor.hpp"
+
+/// IEntityStorage ― Type erased face of a ComponentStorage, lets the registry drop an entity from every storage
+class IEntityStorage
+{
+public:
+    virtual ~IEntityStorage() = default;
+
+    virtual bool   Remove(Actor::ActorID id) = 0;
+    virtual size_t Size() const = 0;
+    virtual void   Clear() = 0;
+};
+
+/// ComponentStorage ― Sparse set of plain data keyed by ActorID. The data and the id owning each element are packed in
+/// two parallel arrays that systems walk front to back, a removal moves the last element into the hole.
+/// The sparse side is paged, actor ids only ever grow and a match reset must not leave a huge flat index behind.
+template <typename T>
+class ComponentStorage final : public IEntityStorage
+{
+public:
+    template <typename... Args>
+    T& Emplace(Actor::ActorID id, Args&&... args)
+    {
+        uint32_t& slot = GetOrCreateSlot(id);
+        if (slot != INVALID_INDEX)
+        {
+            m_dense[slot] = T{std::forward<Args>(args)...};
+            return m_dense[slot];
+        }
+        slot = static_cast<uint32_t>(m_dense.size());
+        m_entities.push_back(id);
+        m_dense.push_back(T{std::forward<Args>(args)...});
+        return m_dense.back();
+    }
+
+    T* Get(Actor::ActorID id)
+    {
+        uint32_t index = FindIndex(id);
+        return index == INVALID_INDEX ? nullptr : &m_dense[index];
+    }
+
+    const T* Get(Actor::ActorID id) const
+    {
+        uint32_t index = FindIndex(id);
+        return index == INVALID_INDEX ? nullptr : &m_dense[index];
+    }
+
+    bool Has(Actor::ActorID id) const { return FindIndex(id) != INVALID_INDEX; }
+
+    bool Remove(Actor::ActorID id) override
+    {
+        uint32_t index = FindIndex(id);
+        if (index == INVALID_INDEX)
+        {
+            return false;
+        }
+        uint32_t last = static_cast<uint32_t>(m_dense.size()) - 1;
+        if (index != last)
+        {
+            m_dense[index]              = std::move(m_dense[last]);
+            m_entities[index]           = m_entities[last];
+            *GetSlot(m_entities[index]) = index;
+        }
+        m_dense.pop_back();
+        m_entities.pop_back();
+        *GetSlot(id) = INVALID_INDEX;
+        return true;
+    }
+
+    size_t Size() const override { return m_dense.size(); }
+
+    void Clear() override
+    {
+        m_dense.clear();
+        m_entities.clear();
+        m_pages.clear();
+    }
+
+    void Reserve(size_t count)
+    {
+        m_dense.reserve(count);
+        m_entities.reserve(count);
+    }
+
+    /// Dense views for systems, element i belongs to GetEntities()[i]
+    T*                    GetData() { return m_dense.data(); }
+    const T*              GetData() const { return m_dense.data(); }
+    const Actor::ActorID* GetEntities() const { return m_entities.data(); }
+    T*                    begin() { return m_dense.data(); }
+    T*                    end() { return m_dense.data() + m_dense.size(); }
+    const T*              begin() const { return m_dense.data(); }
+    const T*              end() const { return m_dense.data() + m_dense.size(); }
+
+private:
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+    static constexpr uint32_t PAGE_BITS     = 10;
+    static constexpr uint32_t PAGE_SIZE     = 1u << PAGE_BITS;
+
+    std::vector<T>                           m_dense;
+    std::vector<Actor::ActorID>              m_entities;
+    std::vector<std::unique_ptr<uint32_t[]>> m_pages; // ActorID -> dense index, a page is only allocated once used
+
+    uint32_t* GetSlot(Actor::ActorID id) const
+    {
+        size_t page = id >> PAGE_BITS;
+        return page < m_pages.size() && m_pages[page] ? &m_pages[page][id & (PAGE_SIZE - 1)] : nullptr;
+    }
+
+    uint32_t FindIndex(Actor::ActorID id) const
+    {
+        const uint32_t* slot = GetSlot(id);
+        return slot ? *slot : INVALID_INDEX;
+    }
+
+    uint32_t& GetOrCreateSlot(Actor::ActorID id)
+    {
+        size_t page = id >> PAGE_BITS;
+        if (page >= m_pages.size())
+        {
+            m_pages.resize(page + 1);
+        }
+        if (!m_pages[page])
+        {
+            m_pages[page] = std::make_unique<uint32_t[]>(PAGE_SIZE);
+            std::fill_n(m_pages[page].get(), PAGE_SIZE, INVALID_INDEX);
+        }
+        return m_pages[page][id & (PAGE_SIZE - 1)];
+    }
+};
+
+/// EntityRegistry ― Optional data oriented storage next to the Actor components. Actors stay the handles, their id keys
+/// one ComponentStorage per data type and systems iterate those instead of ticking every actor through virtual calls.
+class EntityRegistry
+{
+public:
+    template <typename T>
+    ComponentStorage<T>& GetStorage()
+    {
+        int id = StaticStorageID<T>();
+        if (id >= static_cast<int>(m_storages.size()))
+        {
+            m_storages.resize(id + 1);
+        }
+        if (!m_storages[id])
+        {
+            m_storages[id] = std::make_unique<ComponentStorage<T>>();
+        }
+        return static_cast<ComponentStorage<T>&>(*m_storages[id]);
+    }
+
+    /// Null when nothing of that type was ever stored
+    template <typename T>
+    const ComponentStorage<T>* FindStorage() const
+    {
+        int id = StaticStorageID<T>();
+        return id < static_cast<int>(m_storages.size()) ? static_cast<const ComponentStorage<T>*>(m_storages[id].get()) : nullptr;
+    }
+
+    template <typename T, typename... Args>
+    T& Emplace(Actor::ActorID id, Args&&... args)
+    {
+        return GetStorage<T>().Emplace(id, std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    T* Get(Actor::ActorID id)
+    {
+        return GetStorage<T>().Get(id);
+    }
+
+    template <typename T>
+    bool Remove(Actor::ActorID id)
+    {
+        return GetStorage<T>().Remove(id);
+    }
+
+    void RemoveEntity(Actor::ActorID id); // From every storage
+    void Clear();
+
+private:
+    template <typename T>
+    static int StaticStorageID()
+    {
+        static int s_storageID = s_nextStorageID++;
+        return s_storageID;
+    }
+
+    inline static int                            s_nextStorageID = 0;
+    std::vector<std::unique_ptr<IEntityStorage>> m_storages;
+};
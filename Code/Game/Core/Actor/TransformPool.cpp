@@ -0,0 +1,144 @@
+﻿#include "TransformPool.hpp"
+
+#include "Actor.hpp"
+
+namespace
+{
+    bool IsSameTransform(const Vec3& position, const EulerAngles& orientation, const Actor& actor)
+    {
+        return position.x == actor.m_position.x && position.y == actor.m_position.y && position.z == actor.m_position.z &&
+            orientation.m_yawDegrees == actor.m_orientation.m_yawDegrees &&
+            orientation.m_pitchDegrees == actor.m_orientation.m_pitchDegrees &&
+            orientation.m_rollDegrees == actor.m_orientation.m_rollDegrees;
+    }
+}
+
+void TransformPool::Add(Actor* actor)
+{
+    if (actor->m_transformPool) return;
+    int parent = actor->GetParent() && actor->GetParent()->m_transformPool == this ? actor->GetParent()->m_transformIndex : -1;
+    AddNode(actor, parent);
+}
+
+void TransformPool::Remove(Actor* actor)
+{
+    if (actor->m_transformPool != this) return;
+
+    // Parents come first, one pass finds the whole subtree
+    int count = Size();
+    m_remap.assign(count, 0);
+    m_remap[actor->m_transformIndex] = -1;
+    for (int i = actor->m_transformIndex + 1; i < count; ++i)
+    {
+        if (m_parents[i] >= 0 && m_remap[m_parents[i]] == -1)
+            m_remap[i] = -1;
+    }
+
+    int write = 0;
+    for (int read = 0; read < count; ++read)
+    {
+        Actor* node = m_actors[read];
+        if (m_remap[read] == -1)
+        {
+            node->m_transformPool  = nullptr;
+            node->m_transformIndex = -1;
+            continue;
+        }
+        m_remap[read]          = write;
+        m_actors[write]        = node;
+        m_parents[write]       = m_parents[read] >= 0 ? m_remap[m_parents[read]] : -1;
+        m_local[write]         = m_local[read];
+        m_world[write]         = m_world[read];
+        m_positions[write]     = m_positions[read];
+        m_orientations[write]  = m_orientations[read];
+        m_worldChanged[write]  = m_worldChanged[read];
+        node->m_transformIndex = write;
+        write++;
+    }
+    m_actors.resize(write);
+    m_parents.resize(write);
+    m_local.resize(write);
+    m_world.resize(write);
+    m_positions.resize(write);
+    m_orientations.resize(write);
+    m_worldChanged.resize(write);
+}
+
+void TransformPool::Clear()
+{
+    for (Actor* actor : m_actors)
+    {
+        actor->m_transformPool  = nullptr;
+        actor->m_transformIndex = -1;
+    }
+    m_actors.clear();
+    m_parents.clear();
+    m_local.clear();
+    m_world.clear();
+    m_positions.clear();
+    m_orientations.clear();
+    m_worldChanged.clear();
+}
+
+void TransformPool::Update()
+{
+    int count = Size();
+    for (int i = 0; i < count; ++i)
+    {
+        bool localChanged = !IsSameTransform(m_positions[i], m_orientations[i], *m_actors[i]);
+        if (localChanged)
+        {
+            BuildLocal(i);
+        }
+
+        int parent        = m_parents[i];
+        m_worldChanged[i] = localChanged || (parent >= 0 && m_worldChanged[parent]);
+        if (!m_worldChanged[i]) continue;
+
+        if (parent < 0)
+        {
+            m_world[i] = m_local[i];
+        }
+        else
+        {
+            m_world[i] = m_world[parent];
+            m_world[i].Append(m_local[i]);
+        }
+    }
+}
+
+bool TransformPool::IsCurrent(int index) const
+{
+    return index >= 0 && index < Size() && IsSameTransform(m_positions[index], m_orientations[index], *m_actors[index]);
+}
+
+void TransformPool::AddNode(Actor* actor, int parent)
+{
+    int index               = Size();
+    actor->m_transformPool  = this;
+    actor->m_transformIndex = index;
+    m_actors.push_back(actor);
+    m_parents.push_back(parent);
+    m_local.emplace_back();
+    m_world.emplace_back();
+    m_positions.push_back(actor->m_position);
+    m_orientations.push_back(actor->m_orientation);
+    m_worldChanged.push_back(1);
+
+    BuildLocal(index);
+    m_world[index] = parent >= 0 ? m_world[parent] : Mat44();
+    m_world[index].Append(m_local[index]);
+
+    for (const std::unique_ptr<Actor>& child : actor->GetChildren())
+    {
+        if (!child->m_transformPool)
+            AddNode(child.get(), index);
+    }
+}
+
+void TransformPool::BuildLocal(int index)
+{
+    m_positions[index]    = m_actors[index]->m_position;
+    m_orientations[index] = m_actors[index]->m_orientation;
+    m_local[index]        = m_actors[index]->GetLocalTransform();
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+class Actor;
+
+/// TransformPool ― Cached local and world matrices of a set of actors in flat arrays, parents always before their
+/// children. Update compares every actor against the position and orientation its matrices were built from, rebuilds
+/// only what changed and carries a changed world matrix down to the children in the same front to back pass.
+class TransformPool
+{
+public:
+    void Add(Actor* actor); // And its children, right behind it
+    void Remove(Actor* actor); // And its children, keeps the order of the rest
+    void Clear();
+    void Update();
+
+    /// True while the actor still sits where its cached matrices were built, an ancestor moved since is not seen
+    bool IsCurrent(int index) const;
+
+    int          Size() const { return static_cast<int>(m_actors.size()); }
+    const Mat44& GetWorldTransform(int index) const { return m_world[index]; } // Render submission reads it through Actor::m_transformIndex
+
+private:
+    std::vector<Actor*>      m_actors;
+    std::vector<int>         m_parents; // Index into the pool, -1 for a root
+    std::vector<Mat44>       m_local;
+    std::vector<Mat44>       m_world;
+    std::vector<Vec3>        m_positions; // What m_local was built from
+    std::vector<EulerAngles> m_orientations;
+    std::vector<uint8_t>     m_worldChanged; // Set by Update for the children that follow
+    std::vector<int>         m_remap; // Kept for Remove
+
+    void AddNode(Actor* actor, int parent);
+    void BuildLocal(int index);
+};
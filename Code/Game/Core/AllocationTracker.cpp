@@ -0,0 +1,345 @@
+﻿#include "AllocationTracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "Engine/Core/StringUtils.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <dbghelp.h>
+#pragma comment(lib, "dbghelp.lib")
+#endif
+
+namespace
+{
+    constexpr uint32_t SITE_CAPACITY = 2048; // Distinct call stacks per frame, power of two
+    constexpr uint32_t SITE_PROBES   = 64;
+
+    struct SiteSlot
+    {
+        uint64_t       m_hash       = 0;
+        uint32_t       m_generation = 0; // Empty unless it matches the generation of the frame its table belongs to
+        AllocationSite m_site;
+    };
+
+    // Everything here is constant initialized, operator new can run before any dynamic initializer
+    std::atomic<EAllocationTrackMode> s_mode{EAllocationTrackMode::OFF};
+    std::atomic<uint64_t>             s_frameAllocs{0};
+    std::atomic<uint64_t>             s_frameFrees{0};
+    std::atomic<uint64_t>             s_frameBytes{0};
+    std::atomic<uint64_t>             s_totalAllocs{0};
+    std::atomic<uint64_t>             s_totalFrees{0};
+    std::atomic<uint64_t>             s_totalBytes{0};
+    AllocationFrameStats              s_lastFrame;
+
+    SiteSlot         s_siteTables[2][SITE_CAPACITY];
+    uint32_t         s_generation     = 1; // Table s_generation & 1 collects the current frame
+    uint32_t         s_lastGeneration = 0;
+    uint64_t         s_droppedSites   = 0;
+    std::atomic_flag s_sitesLock      = ATOMIC_FLAG_INIT; // Only contended in CALL_SITES mode
+
+    thread_local int      t_scopeDepth = 0;
+    thread_local uint64_t t_allocs     = 0;
+    thread_local uint64_t t_bytes      = 0;
+    thread_local bool     t_recording  = false; // Stack capture may allocate on first use
+
+    int CaptureFrames(void** frames)
+    {
+#ifdef _WIN32
+        return static_cast<int>(RtlCaptureStackBackTrace(1, AllocationSite::MAX_FRAMES, frames, nullptr));
+#else
+        frames[0] = __builtin_return_address(0);
+        return 1;
+#endif
+    }
+
+    void RecordSite(size_t size)
+    {
+        void*    frames[AllocationSite::MAX_FRAMES];
+        int      frameCount = CaptureFrames(frames);
+        uint64_t hash       = 14695981039346656037ull;
+        for (int i = 0; i < frameCount; ++i)
+        {
+            hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ull;
+        }
+
+        while (s_sitesLock.test_and_set(std::memory_order_acquire))
+        {
+        }
+        SiteSlot* table = s_siteTables[s_generation & 1];
+        uint32_t  probe = 0;
+        for (; probe < SITE_PROBES; ++probe)
+        {
+            SiteSlot& slot = table[(hash + probe) & (SITE_CAPACITY - 1)];
+            if (slot.m_generation != s_generation)
+            {
+                slot.m_generation        = s_generation;
+                slot.m_hash              = hash;
+                slot.m_site.m_frameCount = frameCount;
+                slot.m_site.m_allocs     = 0;
+                slot.m_site.m_bytes      = 0;
+                memcpy(slot.m_site.m_frames, frames, sizeof(void*) * frameCount);
+            }
+            if (slot.m_hash == hash && slot.m_site.m_frameCount == frameCount && memcmp(slot.m_site.m_frames, frames, sizeof(void*) * frameCount) == 0)
+            {
+                slot.m_site.m_allocs++;
+                slot.m_site.m_bytes += size;
+                break;
+            }
+        }
+        if (probe == SITE_PROBES)
+        {
+            s_droppedSites++;
+        }
+        s_sitesLock.clear(std::memory_order_release);
+    }
+
+#ifdef _WIN32
+    bool IsAllocatorFrame(const char* name)
+    {
+        static const char* PREFIXES[] = {"operator new", "std::", "AllocationTracker::", "`anonymous namespace'::", "malloc", "_malloc"};
+        for (const char* prefix : PREFIXES)
+        {
+            if (strncmp(name, prefix, strlen(prefix)) == 0) return true;
+        }
+        return false;
+    }
+#endif
+}
+
+void AllocationTracker::SetMode(EAllocationTrackMode mode)
+{
+    if (s_mode.load() == EAllocationTrackMode::OFF && mode != EAllocationTrackMode::OFF)
+    {
+        s_frameAllocs.store(0);
+        s_frameFrees.store(0);
+        s_frameBytes.store(0);
+        s_totalAllocs.store(0);
+        s_totalFrees.store(0);
+        s_totalBytes.store(0);
+    }
+    s_mode.store(mode);
+}
+
+EAllocationTrackMode AllocationTracker::GetMode()
+{
+    return s_mode.load();
+}
+
+void AllocationTracker::BeginFrame()
+{
+    s_lastFrame.m_allocs = s_frameAllocs.exchange(0, std::memory_order_relaxed);
+    s_lastFrame.m_frees  = s_frameFrees.exchange(0, std::memory_order_relaxed);
+    s_lastFrame.m_bytes  = s_frameBytes.exchange(0, std::memory_order_relaxed);
+
+    while (s_sitesLock.test_and_set(std::memory_order_acquire))
+    {
+    }
+    s_lastGeneration = s_generation;
+    s_generation++; // Empties the other table without touching it
+    s_sitesLock.clear(std::memory_order_release);
+}
+
+const AllocationFrameStats& AllocationTracker::GetLastFrameStats()
+{
+    return s_lastFrame;
+}
+
+AllocationFrameStats AllocationTracker::GetTotalStats()
+{
+    return {s_totalAllocs.load(), s_totalFrees.load(), s_totalBytes.load()};
+}
+
+uint64_t AllocationTracker::GetDroppedSiteCount()
+{
+    return s_droppedSites;
+}
+
+void AllocationTracker::GetLastFrameTopSites(int count, std::vector<AllocationSite>& outSites)
+{
+    // Allocating threads only write the current table, BeginFrame runs on this thread
+    outSites.clear();
+    const SiteSlot* table = s_siteTables[s_lastGeneration & 1];
+    for (uint32_t i = 0; i < SITE_CAPACITY; ++i)
+    {
+        if (table[i].m_generation == s_lastGeneration)
+        {
+            outSites.push_back(table[i].m_site);
+        }
+    }
+    std::sort(outSites.begin(), outSites.end(), [](const AllocationSite& lhs, const AllocationSite& rhs) { return lhs.m_allocs > rhs.m_allocs; });
+    if (static_cast<int>(outSites.size()) > count)
+    {
+        outSites.resize(count);
+    }
+}
+
+std::string AllocationTracker::DescribeSite(const AllocationSite& site)
+{
+    if (site.m_frameCount == 0)
+    {
+        return "unknown";
+    }
+#ifdef _WIN32
+    static bool s_symbolsReady = false;
+    HANDLE      process        = GetCurrentProcess();
+    if (!s_symbolsReady)
+    {
+        SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+        s_symbolsReady = SymInitialize(process, nullptr, TRUE) == TRUE;
+    }
+
+    alignas(SYMBOL_INFO) char symbolBuffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+    SYMBOL_INFO*               symbol = reinterpret_cast<SYMBOL_INFO*>(symbolBuffer);
+    for (int i = 0; s_symbolsReady && i < site.m_frameCount; ++i)
+    {
+        memset(symbolBuffer, 0, sizeof(symbolBuffer));
+        symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+        symbol->MaxNameLen   = MAX_SYM_NAME;
+        DWORD64 address      = reinterpret_cast<DWORD64>(site.m_frames[i]);
+        if (!SymFromAddr(process, address, nullptr, symbol) || IsAllocatorFrame(symbol->Name))
+        {
+            continue;
+        }
+
+        IMAGEHLP_LINE64 line = {};
+        line.SizeOfStruct    = sizeof(IMAGEHLP_LINE64);
+        DWORD displacement   = 0;
+        if (SymGetLineFromAddr64(process, address, &displacement, &line))
+        {
+            const char* fileName = strrchr(line.FileName, '\\');
+            return Stringf("%s (%s:%lu)", symbol->Name, fileName ? fileName + 1 : line.FileName, line.LineNumber);
+        }
+        return symbol->Name;
+    }
+#endif
+    return Stringf("%p", site.m_frames[0]);
+}
+
+void AllocationTracker::OnAllocate(size_t size)
+{
+    if (t_scopeDepth > 0)
+    {
+        t_allocs++;
+        t_bytes += size;
+    }
+    EAllocationTrackMode mode = s_mode.load(std::memory_order_relaxed);
+    if (mode == EAllocationTrackMode::OFF)
+    {
+        return;
+    }
+    s_frameAllocs.fetch_add(1, std::memory_order_relaxed);
+    s_frameBytes.fetch_add(size, std::memory_order_relaxed);
+    s_totalAllocs.fetch_add(1, std::memory_order_relaxed);
+    s_totalBytes.fetch_add(size, std::memory_order_relaxed);
+    if (mode == EAllocationTrackMode::CALL_SITES && !t_recording)
+    {
+        t_recording = true;
+        RecordSite(size);
+        t_recording = false;
+    }
+}
+
+void AllocationTracker::OnFree()
+{
+    if (s_mode.load(std::memory_order_relaxed) == EAllocationTrackMode::OFF)
+    {
+        return;
+    }
+    s_frameFrees.fetch_add(1, std::memory_order_relaxed);
+    s_totalFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocationScope::AllocationScope()
+{
+    t_scopeDepth++;
+    m_startAllocs = t_allocs;
+    m_startBytes  = t_bytes;
+}
+
+AllocationScope::~AllocationScope()
+{
+    t_scopeDepth--;
+}
+
+uint64_t AllocationScope::GetAllocationCount() const
+{
+    return t_allocs - m_startAllocs;
+}
+
+uint64_t AllocationScope::GetAllocatedBytes() const
+{
+    return t_bytes - m_startBytes;
+}
+
+#ifndef ALLOCATION_TRACKER_DISABLED
+void* operator new(size_t size)
+{
+    void* memory = malloc(size > 0 ? size : 1);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    AllocationTracker::OnAllocate(size);
+    return memory;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    void* memory = malloc(size > 0 ? size : 1);
+    if (memory)
+    {
+        AllocationTracker::OnAllocate(size);
+    }
+    return memory;
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept
+{
+    if (memory)
+    {
+        AllocationTracker::OnFree();
+        free(memory);
+    }
+}
+
+void operator delete[](void* memory) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    operator delete(memory);
+}
+#endif
@@ -0,0 +1,76 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Define ALLOCATION_TRACKER_DISABLED to keep the default global operator new / delete.
+/// Aligned (align_val_t) allocations are not routed through the tracker.
+
+enum class EAllocationTrackMode : uint8_t
+{
+    OFF, // A thread local check and a relaxed load per allocation
+    COUNT, // Allocations, frees and bytes per frame
+    CALL_SITES, // COUNT and a short call stack per allocation, slow
+};
+
+struct AllocationFrameStats
+{
+    uint64_t m_allocs = 0;
+    uint64_t m_frees  = 0;
+    uint64_t m_bytes  = 0; // Requested bytes, frees are not sized
+};
+
+/// One distinct call stack of the last frame, only filled in CALL_SITES mode
+struct AllocationSite
+{
+    static constexpr int MAX_FRAMES = 12;
+
+    void*    m_frames[MAX_FRAMES] = {};
+    int      m_frameCount         = 0;
+    uint64_t m_allocs             = 0;
+    uint64_t m_bytes              = 0;
+};
+
+/// AllocationTracker ― Opt-in counters behind the global operator new / delete, swapped into the last frame
+/// stats on BeginFrame. Static because allocations happen before and after every subsystem lifetime.
+class AllocationTracker
+{
+public:
+    static void                 SetMode(EAllocationTrackMode mode);
+    static EAllocationTrackMode GetMode();
+
+    /// Called first thing every frame on the main thread, publishes the counts of the frame that just ended
+    static void                        BeginFrame();
+    static const AllocationFrameStats& GetLastFrameStats();
+    static AllocationFrameStats        GetTotalStats(); // Since the tracker was last switched on
+
+    /// Call sites of the last frame sorted by allocation count, main thread only
+    static void     GetLastFrameTopSites(int count, std::vector<AllocationSite>& outSites);
+    static uint64_t GetDroppedSiteCount(); // Allocations whose stack found no free slot
+
+    /// First frame of the stack outside the allocator and the standard library, "Function (file:line)" when symbols load
+    static std::string DescribeSite(const AllocationSite& site);
+
+    /// Called by the global operators
+    static void OnAllocate(size_t size);
+    static void OnFree();
+};
+
+/// AllocationScope ― Counts the allocations of the calling thread while alive, works with the tracker OFF.
+/// e.g. the headless ChessScript runner expects 0 from every replay after the first.
+class AllocationScope
+{
+public:
+    AllocationScope();
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope&)            = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+    uint64_t GetAllocationCount() const;
+    uint64_t GetAllocatedBytes() const;
+
+private:
+    uint64_t m_startAllocs = 0;
+    uint64_t m_startBytes  = 0;
+};
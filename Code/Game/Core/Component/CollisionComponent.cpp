@@ -9,6 +9,7 @@
 
 CollisionComponent::CollisionComponent()
 {
+    m_owningComponent = this;
     m_debugVertexes.reserve(1024);
 }
 
@@ -83,6 +84,16 @@ RaycastResult3D CollisionComponent::Raycast(const Vec3& origin, const Vec3& dire
     return worldBox.Raycast(origin, direction, maxDistance);
 }
 
+CollisionBoxData CollisionComponent::GetCollisionBoxData()
+{
+    CollisionBoxData data;
+    data.m_localBox = m_collisionBox;
+    data.m_worldBox = GetCollisionBox();
+    data.m_offset   = m_position;
+    data.m_owner    = GetOwner();
+    return data;
+}
+
 AABB3 CollisionComponent::GetCollisionBox(bool worldSpace)
 {
     if (worldSpace)
@@ -5,6 +5,16 @@
 
 struct Vertex_PCU;
 
+/// World space box of a CollisionComponent kept in an EntityRegistry, systems refresh and raycast them without touching
+/// the component
+struct CollisionBoxData
+{
+    AABB3  m_localBox; // Centered on the origin
+    AABB3  m_worldBox;
+    Vec3   m_offset; // Component position relative to the owner
+    Actor* m_owner = nullptr;
+};
+
 /// Simple collision box component
 class CollisionComponent : public IComponent, public IRenderable
 {
@@ -30,6 +40,7 @@ class CollisionComponent : public IComponent, public IRenderable
     CollisionComponent* SetCollisionBox(AABB3& collisionBox); // This method will automatically set the local space of aabb3
     RaycastResult3D     Raycast(const Vec3& origin, const Vec3& direction, float maxDistance);
     AABB3               GetCollisionBox(bool worldSpace = true);
+    CollisionBoxData    GetCollisionBoxData();
 
 private:
     AABB3                   m_collisionBox;
@@ -2,6 +2,7 @@
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/XmlUtils.hpp"
 #include "Engine/Math/Vec3.hpp"
+#include "Game/Core/ObjectArena.hpp"
 
 ///
 /// IComponent ― Every concrete component derives from this pure-virtual base
@@ -14,6 +15,11 @@ class IComponent
 public:
     /// Life-Cycle Hook
     virtual      ~IComponent() = default;
+
+    /// From the ObjectArena of the current scope like the owning Actor
+    static void* operator new(size_t size) { return ObjectArena::AllocateObject(size); }
+    static void  operator delete(void* memory) { ObjectArena::FreeObject(memory); }
+
     virtual void OnInit();
     virtual void OnAttach(Actor& owner);
     virtual void OnDetach();
@@ -12,6 +12,7 @@
 
 MeshComponent::MeshComponent()
 {
+    m_owningComponent = this;
     m_vertexesPCUTBN.reserve(1024);
     m_vertexesPCU.reserve(1024);
     m_indices.reserve(1024);
@@ -80,8 +81,7 @@ void MeshComponent::Render(const RenderContext& ctx)
         ctx.renderer.BindTexture(m_diffuseTexture, 0);
     }
 
-    Mat44 matrix;
-    matrix = GetOwner()->GetModelToWorldTransform();
+    Mat44 matrix = GetOwner()->GetRenderTransform();
     matrix.AppendTranslation3D(m_position);
     ctx.SetModel(matrix, m_color); // TODO: Consider to Move into Transform Component (additional matrix mul)
     ctx.renderer.BindTexture(m_diffuseTexture, 0);
@@ -206,8 +206,8 @@ MeshComponent* MeshComponent::ApplyMaterialByIndex(size_t materialIndex)
 {
     if (!m_mesh || materialIndex >= m_mesh->GetMaterialCount())
     {
-        LOG(LogResource, Warning, Stringf("Invalid material index: %d (available: %d)",
-                materialIndex, m_mesh ? m_mesh->GetMaterialCount() : 0).c_str());
+        LOG(LogResource, Warning, "Invalid material index: %zu (available: %zu)",
+            materialIndex, m_mesh ? m_mesh->GetMaterialCount() : 0);
         return this;
     }
 
@@ -217,8 +217,8 @@ MeshComponent* MeshComponent::ApplyMaterialByIndex(size_t materialIndex)
         m_currentMaterialIndex = materialIndex;
         ApplyMaterial(*material);
 
-        LOG(LogResource, Info, Stringf("Switched to material %d: %s",
-                materialIndex, material->name.c_str()).c_str());
+        LOG(LogResource, Info, "Switched to material %zu: %s",
+            materialIndex, material->name.c_str());
     }
 
     return this;
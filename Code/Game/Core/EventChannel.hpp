@@ -0,0 +1,101 @@
+﻿#pragma once
+#include <cstdint>
+#include <type_traits>
+
+/// Ids of the typed event channels, one per channel the game fires every frame
+enum class EEventChannel : uint16_t
+{
+    HIGHLIGHT_CHANGED,
+    COUNT
+};
+
+inline const char* GetEventChannelName(EEventChannel id)
+{
+    switch (id)
+    {
+    case EEventChannel::HIGHLIGHT_CHANGED:
+        return "HighlightChanged";
+    default:
+        return "Unknown";
+    }
+}
+
+/// EventChannel ― The fast path next to the string keyed EventSystem, for events fired every frame. A channel has an
+/// integer id, a fixed payload struct passed by reference and a fixed subscriber list, so firing neither allocates
+/// nor hashes. FireOnChange is edge triggered, it only delivers a payload that differs from the last one delivered.
+template <typename TPayload>
+class EventChannel
+{
+    static_assert(std::is_trivially_copyable<TPayload>::value, "EventChannel payloads are plain structs");
+
+public:
+    using Callback = void (*)(const TPayload& payload, void* listener);
+
+    static constexpr int MAX_SUBSCRIBERS = 8;
+
+    explicit EventChannel(EEventChannel id) : m_id(id)
+    {
+    }
+
+    EEventChannel GetId() const { return m_id; }
+    const char*   GetName() const { return GetEventChannelName(m_id); }
+    int           GetSubscriberCount() const { return m_subscriberCount; }
+    uint64_t      GetDeliveredCount() const { return m_deliveredCount; }
+
+    /// False when the list is full, listener is handed back to the callback untouched
+    bool Subscribe(Callback callback, void* listener)
+    {
+        if (m_subscriberCount == MAX_SUBSCRIBERS) return false;
+        m_subscribers[m_subscriberCount++] = {callback, listener};
+        return true;
+    }
+
+    void Unsubscribe(void* listener)
+    {
+        for (int i = m_subscriberCount - 1; i >= 0; --i)
+        {
+            if (m_subscribers[i].m_listener != listener) continue;
+            for (int j = i + 1; j < m_subscriberCount; ++j)
+            {
+                m_subscribers[j - 1] = m_subscribers[j]; // Keeps the delivery order
+            }
+            m_subscriberCount--;
+        }
+    }
+
+    void Fire(const TPayload& payload)
+    {
+        m_last    = payload;
+        m_hasLast = true;
+        m_deliveredCount++;
+        for (int i = 0; i < m_subscriberCount; ++i)
+        {
+            m_subscribers[i].m_callback(payload, m_subscribers[i].m_listener);
+        }
+    }
+
+    /// Returns whether the payload was delivered
+    bool FireOnChange(const TPayload& payload)
+    {
+        if (m_hasLast && m_last == payload) return false;
+        Fire(payload);
+        return true;
+    }
+
+    /// The next FireOnChange delivers whatever it gets, for subscribers that need the current state again
+    void ResetLast() { m_hasLast = false; }
+
+private:
+    struct Subscriber
+    {
+        Callback m_callback = nullptr;
+        void*    m_listener = nullptr;
+    };
+
+    EEventChannel m_id;
+    Subscriber    m_subscribers[MAX_SUBSCRIBERS];
+    int           m_subscriberCount = 0;
+    TPayload      m_last            = {};
+    bool          m_hasLast         = false;
+    uint64_t      m_deliveredCount  = 0;
+};
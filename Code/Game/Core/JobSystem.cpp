@@ -0,0 +1,197 @@
+﻿#include "JobSystem.hpp"
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Core/LoggerSubsystem.hpp"
+#include "Game/Core/ProfilerSubsystem.hpp"
+
+namespace
+{
+    thread_local const JobSystem* t_owner      = nullptr;
+    thread_local int              t_queueIndex = 0;
+}
+
+JobSystem::JobSystem(const JobSystemConfig& config) : m_config(config)
+{
+}
+
+JobSystem::~JobSystem()
+{
+    Shutdown();
+}
+
+void JobSystem::Startup()
+{
+    int workerCount = m_config.m_workerCount;
+    if (workerCount < 0)
+    {
+        workerCount = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    }
+    workerCount = workerCount > 0 ? workerCount : 0;
+
+    m_quit.store(false);
+    for (int i = 0; i <= workerCount; ++i)
+    {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+        m_queues.back()->m_jobs.resize(m_config.m_queueCapacity > 0 ? m_config.m_queueCapacity : 1);
+    }
+    for (int i = 1; i <= workerCount; ++i)
+    {
+        m_workers.emplace_back(&JobSystem::WorkerMain, this, i);
+    }
+    LOG(LogSystem, Info, "Start up Job system with %d workers...", workerCount);
+}
+
+void JobSystem::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_sleepMutex);
+        m_quit.store(true);
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+
+    // Nothing may be left behind, a waiter would hang on its counter
+    Job job;
+    for (int i = 0; i < static_cast<int>(m_queues.size()); ++i)
+    {
+        while (PopBack(i, job))
+        {
+            Execute(job);
+        }
+    }
+    m_queues.clear();
+}
+
+void JobSystem::Submit(const Job& job)
+{
+    job.m_counter->m_pending.fetch_add(1);
+    if (m_queues.empty() || !Push(GetQueueIndex(), job))
+    {
+        Execute(job);
+        return;
+    }
+    m_queuedJobs.fetch_add(1);
+    if (m_sleepers.load() > 0)
+    {
+        std::lock_guard<std::mutex> guard(m_sleepMutex);
+        m_wake.notify_one();
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    int queueIndex = GetQueueIndex();
+    Job job;
+    while (!counter.IsDone())
+    {
+        if (FindJob(queueIndex, job))
+        {
+            Execute(job);
+        }
+        else
+        {
+            std::this_thread::yield(); // The last jobs run on other threads
+        }
+    }
+}
+
+void JobSystem::WorkerMain(int queueIndex)
+{
+    t_owner      = this;
+    t_queueIndex = queueIndex;
+    if (!m_config.m_threadName.empty() && g_theProfilerSubsystem)
+    {
+        g_theProfilerSubsystem->SetThreadName(Stringf("%s %d", m_config.m_threadName.c_str(), queueIndex));
+    }
+
+    Job job;
+    while (true)
+    {
+        if (FindJob(queueIndex, job))
+        {
+            Execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepers.fetch_add(1);
+        m_wake.wait(lock, [this]() { return m_queuedJobs.load() > 0 || m_quit.load(); });
+        m_sleepers.fetch_sub(1);
+        if (m_quit.load())
+        {
+            return;
+        }
+    }
+}
+
+int JobSystem::GetQueueIndex() const
+{
+    return t_owner == this ? t_queueIndex : 0;
+}
+
+bool JobSystem::Push(int queueIndex, const Job& job)
+{
+    WorkQueue&                  queue = *m_queues[queueIndex];
+    std::lock_guard<std::mutex> guard(queue.m_mutex);
+    if (queue.m_size == queue.m_jobs.size())
+    {
+        return false;
+    }
+    queue.m_jobs[(queue.m_head + queue.m_size) % queue.m_jobs.size()] = job;
+    queue.m_size++;
+    return true;
+}
+
+bool JobSystem::PopBack(int queueIndex, Job& outJob)
+{
+    WorkQueue&                  queue = *m_queues[queueIndex];
+    std::lock_guard<std::mutex> guard(queue.m_mutex);
+    if (queue.m_size == 0)
+    {
+        return false;
+    }
+    queue.m_size--;
+    outJob = queue.m_jobs[(queue.m_head + queue.m_size) % queue.m_jobs.size()];
+    return true;
+}
+
+bool JobSystem::StealFront(int queueIndex, Job& outJob)
+{
+    WorkQueue&                  queue = *m_queues[queueIndex];
+    std::lock_guard<std::mutex> guard(queue.m_mutex);
+    if (queue.m_size == 0)
+    {
+        return false;
+    }
+    outJob       = queue.m_jobs[queue.m_head];
+    queue.m_head = (queue.m_head + 1) % queue.m_jobs.size();
+    queue.m_size--;
+    return true;
+}
+
+bool JobSystem::FindJob(int queueIndex, Job& outJob)
+{
+    // The own back is the most recently pushed and still warm, steal the oldest of the others
+    int  queueCount = static_cast<int>(m_queues.size());
+    bool found      = PopBack(queueIndex, outJob);
+    for (int i = 1; !found && i < queueCount; ++i)
+    {
+        found = StealFront((queueIndex + i) % queueCount, outJob);
+    }
+    if (found)
+    {
+        m_queuedJobs.fetch_sub(1);
+    }
+    return found;
+}
+
+void JobSystem::Execute(const Job& job)
+{
+    job.m_func(job.m_context, job.m_begin, job.m_end);
+    job.m_counter->m_pending.fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,111 @@
+﻿#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+struct JobSystemConfig
+{
+    int         m_workerCount   = -1; // -1 uses every hardware thread but the main one
+    int         m_queueCapacity = 1024; // Jobs per deque, a full deque runs the job inline
+    std::string m_threadName    = "Job Worker"; // Profiler name of the workers, empty leaves them unnamed
+};
+
+/// Fork / join counter, incremented per submitted job and decremented once it ran
+struct JobCounter
+{
+    std::atomic<int> m_pending{0};
+
+    bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+};
+
+/// A range of work, plain values so submitting never allocates
+struct Job
+{
+    void (*m_func)(void* context, int begin, int end) = nullptr;
+    void*       m_context = nullptr;
+    int         m_begin   = 0;
+    int         m_end     = 0;
+    JobCounter* m_counter = nullptr;
+};
+
+/// JobSystem ― Fixed worker pool with one deque per thread. Owners push and pop at the back, idle threads steal from the
+/// front of the others. Queue 0 belongs to every thread outside the pool, the main thread included, and whoever waits
+/// on a counter runs jobs until it reaches zero.
+class JobSystem
+{
+public:
+    JobSystem()                 = delete;
+    JobSystem(const JobSystem&) = delete;
+    explicit JobSystem(const JobSystemConfig& config);
+    ~JobSystem();
+
+    void Startup();
+    void Shutdown();
+
+    int GetWorkerCount() const { return static_cast<int>(m_workers.size()); }
+
+    void Submit(const Job& job);
+    void Wait(JobCounter& counter);
+
+    /// Calls func(index) for every index in [0, count), batchSize indices per job, returns once all of them ran
+    template <typename Func>
+    void ParallelFor(int count, int batchSize, Func&& func);
+
+private:
+    struct WorkQueue
+    {
+        std::mutex       m_mutex;
+        std::vector<Job> m_jobs; // Ring buffer
+        size_t           m_head = 0; // Stolen from here
+        size_t           m_size = 0;
+    };
+
+    JobSystemConfig                         m_config;
+    std::vector<std::unique_ptr<WorkQueue>> m_queues; // [0] outside the pool, [i] worker i - 1
+    std::vector<std::thread>                m_workers;
+    std::atomic<bool>                       m_quit{false};
+    std::atomic<int>                        m_queuedJobs{0};
+    std::atomic<int>                        m_sleepers{0};
+    std::mutex                              m_sleepMutex;
+    std::condition_variable                 m_wake;
+
+    void WorkerMain(int queueIndex);
+    int  GetQueueIndex() const; // Of the calling thread
+    bool Push(int queueIndex, const Job& job);
+    bool PopBack(int queueIndex, Job& outJob);
+    bool StealFront(int queueIndex, Job& outJob);
+    bool FindJob(int queueIndex, Job& outJob);
+
+    static void Execute(const Job& job);
+};
+
+template <typename Func>
+void JobSystem::ParallelFor(int count, int batchSize, Func&& func)
+{
+    using FuncType = std::remove_reference_t<Func>;
+    JobCounter counter;
+    Job        job;
+    job.m_func = [](void* context, int begin, int end)
+    {
+        FuncType& body = *static_cast<FuncType*>(context);
+        for (int i = begin; i < end; ++i)
+        {
+            body(i);
+        }
+    };
+    job.m_context = const_cast<void*>(static_cast<const void*>(&func));
+    job.m_counter = &counter;
+    batchSize     = batchSize > 0 ? batchSize : 1;
+    for (int begin = 0; begin < count; begin += batchSize)
+    {
+        job.m_begin = begin;
+        job.m_end   = begin + batchSize < count ? begin + batchSize : count;
+        Submit(job);
+    }
+    Wait(counter);
+}
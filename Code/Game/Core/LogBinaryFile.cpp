@@ -0,0 +1,317 @@
+﻿#include "LogBinaryFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#include "LoggerSubsystem.hpp"
+
+namespace
+{
+    struct DecodedSite
+    {
+        int           m_line      = 0;
+        ELogCategory  m_category  = ELogCategory::LogTemp;
+        ELogVerbosity m_verbosity = ELogVerbosity::Info;
+        std::string   m_file;
+        std::string   m_format;
+    };
+
+    /// Bounds checked cursor over the whole file
+    struct ByteReader
+    {
+        const uint8_t* m_cursor;
+        const uint8_t* m_end;
+
+        template <typename T>
+        bool Read(T& outValue)
+        {
+            if (static_cast<size_t>(m_end - m_cursor) < sizeof(T)) return false;
+            memcpy(&outValue, m_cursor, sizeof(T));
+            m_cursor += sizeof(T);
+            return true;
+        }
+
+        bool ReadString(std::string& outText)
+        {
+            uint16_t length;
+            if (!Read(length) || static_cast<size_t>(m_end - m_cursor) < length) return false;
+            outText.assign(reinterpret_cast<const char*>(m_cursor), length);
+            m_cursor += length;
+            return true;
+        }
+    };
+
+    void AppendJsonString(std::string& out, const std::string& text)
+    {
+        out += '"';
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"': out += "\\\"";
+                break;
+            case '\\': out += "\\\\";
+                break;
+            case '\n': out += "\\n";
+                break;
+            case '\r': out += "\\r";
+                break;
+            case '\t': out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+    }
+
+    const char* BaseName(const std::string& path)
+    {
+        size_t slash = path.find_last_of("/\\");
+        return path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+    }
+}
+
+LogBinaryWriter::~LogBinaryWriter()
+{
+    Close();
+}
+
+bool LogBinaryWriter::Open(const std::string& path)
+{
+    Close();
+    m_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        return false;
+    }
+    m_pending.insert(m_pending.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    Put(VERSION);
+    Flush();
+    return true;
+}
+
+void LogBinaryWriter::Close()
+{
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    Flush();
+    m_file.close();
+    m_file.clear();
+    m_sites.clear(); // Ids are only meaningful inside one file
+}
+
+size_t LogBinaryWriter::SiteKeyHash::operator()(const SiteKey& key) const
+{
+    size_t hash = std::hash<const void*>()(key.m_format);
+    hash ^= std::hash<const void*>()(key.m_file) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(key.m_line) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+void LogBinaryWriter::WriteRecord(const uint8_t* record, size_t size)
+{
+    if (!m_file.is_open() || size < sizeof(LogRecordHeader))
+    {
+        return;
+    }
+    LogRecordHeader header;
+    memcpy(&header, record, sizeof(header));
+
+    SiteKey  key{header.m_file, header.m_format, header.m_line};
+    auto     found  = m_sites.find(key);
+    uint32_t siteId = 0;
+    if (found == m_sites.end())
+    {
+        siteId = static_cast<uint32_t>(m_sites.size());
+        m_sites.emplace(key, siteId);
+        Put(ELogBinaryChunk::SITE);
+        Put(siteId);
+        Put(static_cast<int32_t>(header.m_line));
+        Put(static_cast<uint32_t>(header.m_category));
+        Put(static_cast<uint8_t>(header.m_verbosity));
+        PutString(header.m_file);
+        PutString(header.m_format);
+    }
+    else
+    {
+        siteId = found->second;
+    }
+
+    uint16_t argBytes = static_cast<uint16_t>(size - sizeof(LogRecordHeader));
+    Put(ELogBinaryChunk::RECORD);
+    Put(siteId);
+    Put(header.m_timestampNs);
+    Put(header.m_threadId);
+    Put(header.m_argCount);
+    Put(argBytes);
+    m_pending.insert(m_pending.end(), record + sizeof(LogRecordHeader), record + size);
+}
+
+void LogBinaryWriter::WriteDropped(uint64_t count)
+{
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    Put(ELogBinaryChunk::DROPPED);
+    Put(count);
+}
+
+void LogBinaryWriter::Flush()
+{
+    if (!m_file.is_open() || m_pending.empty())
+    {
+        return;
+    }
+    m_file.write(reinterpret_cast<const char*>(m_pending.data()), static_cast<std::streamsize>(m_pending.size()));
+    m_file.flush();
+    m_bytesWritten += m_pending.size();
+    m_pending.clear();
+}
+
+template <typename T>
+void LogBinaryWriter::Put(const T& value)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    m_pending.insert(m_pending.end(), bytes, bytes + sizeof(T));
+}
+
+void LogBinaryWriter::PutString(const char* text)
+{
+    size_t   length  = text ? strlen(text) : 0;
+    uint16_t clamped = static_cast<uint16_t>(length < UINT16_MAX ? length : UINT16_MAX);
+    Put(clamped);
+    m_pending.insert(m_pending.end(), text, text + clamped);
+}
+
+bool DecodeLogBinary(const std::string& path, ELogDecodeFormat format, std::string& out, std::string& outError)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        outError = "Could not open " + path;
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    ByteReader reader{bytes.data(), bytes.data() + bytes.size()};
+    char       magic[4];
+    uint32_t   version = 0;
+    if (!reader.Read(magic) || memcmp(magic, LogBinaryWriter::MAGIC, sizeof(magic)) != 0 || !reader.Read(version))
+    {
+        outError = path + " is not a binary log";
+        return false;
+    }
+    if (version != LogBinaryWriter::VERSION)
+    {
+        outError = "Unsupported binary log version " + std::to_string(version);
+        return false;
+    }
+
+    std::vector<DecodedSite> sites;
+    std::string              message;
+    char                     prefix[64];
+    while (reader.m_cursor < reader.m_end)
+    {
+        size_t          offset = static_cast<size_t>(reader.m_cursor - bytes.data());
+        ELogBinaryChunk chunk;
+        reader.Read(chunk);
+        if (chunk == ELogBinaryChunk::SITE)
+        {
+            uint32_t    siteId;
+            int32_t     line;
+            uint32_t    category;
+            uint8_t     verbosity;
+            DecodedSite site;
+            if (!reader.Read(siteId) || !reader.Read(line) || !reader.Read(category) || !reader.Read(verbosity) ||
+                !reader.ReadString(site.m_file) || !reader.ReadString(site.m_format) || siteId != sites.size())
+            {
+                outError = "Malformed site at byte " + std::to_string(offset);
+                return false;
+            }
+            site.m_line      = line;
+            site.m_category  = static_cast<ELogCategory>(category);
+            site.m_verbosity = static_cast<ELogVerbosity>(verbosity);
+            sites.push_back(std::move(site));
+        }
+        else if (chunk == ELogBinaryChunk::RECORD)
+        {
+            uint32_t siteId;
+            uint64_t timestampNs;
+            uint32_t threadId;
+            uint8_t  argCount;
+            uint16_t argBytes;
+            if (!reader.Read(siteId) || !reader.Read(timestampNs) || !reader.Read(threadId) || !reader.Read(argCount) || !reader.Read(argBytes) ||
+                siteId >= sites.size() || static_cast<size_t>(reader.m_end - reader.m_cursor) < argBytes)
+            {
+                outError = "Malformed record at byte " + std::to_string(offset);
+                return false;
+            }
+            const DecodedSite& site = sites[siteId];
+            message.clear();
+            FormatLogMessage(site.m_format.c_str(), reader.m_cursor, reader.m_cursor + argBytes, message);
+            reader.m_cursor += argBytes;
+
+            if (format == ELogDecodeFormat::JSON)
+            {
+                snprintf(prefix, sizeof(prefix), "{\"timeNs\":%llu,\"thread\":%u,\"category\":", static_cast<unsigned long long>(timestampNs), threadId);
+                out += prefix;
+                AppendJsonString(out, LoggerSubsystem::GetCategoryName(site.m_category));
+                out += ",\"verbosity\":";
+                AppendJsonString(out, LoggerSubsystem::GetVerbosityName(site.m_verbosity));
+                out += ",\"file\":";
+                AppendJsonString(out, BaseName(site.m_file));
+                out += ",\"line\":" + std::to_string(site.m_line) + ",\"message\":";
+                AppendJsonString(out, message);
+                out += "}\n";
+            }
+            else
+            {
+                snprintf(prefix, sizeof(prefix), "[%12.6f][T%u] Log", static_cast<double>(timestampNs) * 1e-9, threadId);
+                out += prefix;
+                out += LoggerSubsystem::GetCategoryName(site.m_category);
+                out += ' ';
+                out += LoggerSubsystem::GetVerbosityName(site.m_verbosity);
+                out += ": @(";
+                out += BaseName(site.m_file);
+                out += ':';
+                out += std::to_string(site.m_line);
+                out += ") ";
+                out += message;
+                out += '\n';
+            }
+        }
+        else if (chunk == ELogBinaryChunk::DROPPED)
+        {
+            uint64_t count;
+            if (!reader.Read(count))
+            {
+                outError = "Malformed drop count at byte " + std::to_string(offset);
+                return false;
+            }
+            snprintf(prefix, sizeof(prefix), format == ELogDecodeFormat::JSON ? "{\"dropped\":%llu}\n" : "LogSystem WARNING: %llu log records dropped\n",
+                     static_cast<unsigned long long>(count));
+            out += prefix;
+        }
+        else
+        {
+            outError = "Unknown chunk at byte " + std::to_string(offset);
+            return false;
+        }
+    }
+    return true;
+}
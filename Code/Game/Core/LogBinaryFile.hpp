@@ -0,0 +1,76 @@
+﻿#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Binary log layout, little endian, every chunk after the file header starts with a uint8 ELogBinaryChunk.
+///   SITE    : uint32 siteId, int32 line, uint32 category, uint8 verbosity, uint16 fileLength, file, uint16 formatLength, format
+///   RECORD  : uint32 siteId, uint64 timestampNs, uint32 threadId, uint8 argCount, uint16 argBytes, raw arguments
+///   DROPPED : uint64 count
+/// A site is written once, before its first record, so a record costs its arguments plus 20 bytes.
+enum class ELogBinaryChunk : uint8_t
+{
+    SITE    = 1,
+    RECORD  = 2,
+    DROPPED = 3
+};
+
+enum class ELogDecodeFormat : uint8_t
+{
+    TEXT,
+    JSON ///< One object per line
+};
+
+/// LogBinaryWriter ― Interns the file:line:format of every call site and appends records with their raw argument bytes.
+/// Only the logger's consumer side touches it, it is not thread safe.
+class LogBinaryWriter
+{
+public:
+    static constexpr char     MAGIC[4] = {'E', 'L', 'O', 'G'};
+    static constexpr uint32_t VERSION  = 1;
+
+    LogBinaryWriter() = default;
+    LogBinaryWriter(const LogBinaryWriter&) = delete;
+    ~LogBinaryWriter();
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_file.is_open(); }
+
+    /// record is a LogRecordHeader followed by its raw arguments, as produced by LogRecordWriter
+    void WriteRecord(const uint8_t* record, size_t size);
+    void WriteDropped(uint64_t count);
+    void Flush();
+
+    uint64_t GetBytesWritten() const { return m_bytesWritten; }
+
+private:
+    struct SiteKey
+    {
+        const char* m_file;
+        const char* m_format;
+        int         m_line;
+
+        bool operator==(const SiteKey& other) const { return m_file == other.m_file && m_format == other.m_format && m_line == other.m_line; }
+    };
+
+    struct SiteKeyHash
+    {
+        size_t operator()(const SiteKey& key) const;
+    };
+
+    std::ofstream                                      m_file;
+    std::vector<uint8_t>                               m_pending;
+    std::unordered_map<SiteKey, uint32_t, SiteKeyHash> m_sites;
+    uint64_t                                           m_bytesWritten = 0;
+
+    template <typename T>
+    void Put(const T& value);
+    void PutString(const char* text);
+};
+
+/// Renders a binary log back to text or JSON lines, false with outError when the file is missing or malformed.
+/// Records decoded before a malformed chunk are kept in out.
+bool DecodeLogBinary(const std::string& path, ELogDecodeFormat format, std::string& out, std::string& outError);
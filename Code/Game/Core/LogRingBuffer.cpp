@@ -0,0 +1,282 @@
+﻿#include "LogRingBuffer.hpp"
+
+#include <cstdio>
+
+namespace
+{
+    bool IsIntegerConversion(char conversion)
+    {
+        return conversion == 'd' || conversion == 'i' || conversion == 'u' || conversion == 'o' || conversion == 'x' || conversion == 'X';
+    }
+
+    bool IsFloatConversion(char conversion)
+    {
+        return conversion == 'f' || conversion == 'F' || conversion == 'e' || conversion == 'E' || conversion == 'g' || conversion == 'G' ||
+            conversion == 'a' || conversion == 'A';
+    }
+
+    template <typename T>
+    void AppendFormatted(std::string& out, const char* spec, T value)
+    {
+        char buffer[256];
+        int  length = snprintf(buffer, sizeof(buffer), spec, value);
+        if (length < 0) return;
+        if (static_cast<size_t>(length) < sizeof(buffer))
+        {
+            out.append(buffer, static_cast<size_t>(length));
+            return;
+        }
+        size_t start = out.size();
+        out.resize(start + static_cast<size_t>(length) + 1);
+        snprintf(&out[start], static_cast<size_t>(length) + 1, spec, value);
+        out.resize(start + static_cast<size_t>(length));
+    }
+
+    /// One decoded argument, the string points into the record
+    struct LogArg
+    {
+        ELogArgType m_type   = ELogArgType::INT64;
+        uint64_t    m_bits   = 0;
+        const char* m_string = nullptr;
+
+        int64_t  AsInt() const;
+        uint64_t AsUInt() const { return m_type == ELogArgType::DOUBLE ? static_cast<uint64_t>(AsInt()) : m_bits; }
+        double   AsDouble() const;
+    };
+
+    int64_t LogArg::AsInt() const
+    {
+        if (m_type == ELogArgType::DOUBLE)
+        {
+            double value;
+            memcpy(&value, &m_bits, sizeof(value));
+            return static_cast<int64_t>(value);
+        }
+        return static_cast<int64_t>(m_bits);
+    }
+
+    double LogArg::AsDouble() const
+    {
+        if (m_type == ELogArgType::DOUBLE)
+        {
+            double value;
+            memcpy(&value, &m_bits, sizeof(value));
+            return value;
+        }
+        return m_type == ELogArgType::INT64 ? static_cast<double>(static_cast<int64_t>(m_bits)) : static_cast<double>(m_bits);
+    }
+
+    bool ReadArg(const uint8_t*& cursor, const uint8_t* end, LogArg& outArg)
+    {
+        if (cursor >= end) return false;
+        outArg.m_type = static_cast<ELogArgType>(*cursor++);
+        if (outArg.m_type == ELogArgType::STRING)
+        {
+            uint16_t length;
+            if (cursor + sizeof(length) > end) return false;
+            memcpy(&length, cursor, sizeof(length));
+            cursor += sizeof(length);
+            if (cursor + length + 1 > end) return false;
+            outArg.m_string = reinterpret_cast<const char*>(cursor);
+            outArg.m_bits   = length;
+            cursor += length + 1;
+            return true;
+        }
+        if (cursor + sizeof(outArg.m_bits) > end) return false;
+        memcpy(&outArg.m_bits, cursor, sizeof(outArg.m_bits));
+        cursor += sizeof(outArg.m_bits);
+        return true;
+    }
+}
+
+LogRecordWriter::LogRecordWriter(const LogRecordHeader& header)
+{
+    memcpy(m_data, &header, sizeof(LogRecordHeader));
+    m_size = sizeof(LogRecordHeader);
+}
+
+void LogRecordWriter::AppendNumber(ELogArgType type, const void* value)
+{
+    constexpr size_t SIZE = 1 + sizeof(uint64_t);
+    if (m_size + SIZE > MAX_RECORD_BYTES) return;
+    m_data[m_size] = static_cast<uint8_t>(type);
+    memcpy(m_data + m_size + 1, value, sizeof(uint64_t));
+    m_size += SIZE;
+    GetHeader().m_argCount++;
+}
+
+void LogRecordWriter::AppendString(const char* text, size_t length)
+{
+    constexpr size_t OVERHEAD = 1 + sizeof(uint16_t) + 1;
+    if (m_size + OVERHEAD > MAX_RECORD_BYTES) return;
+    size_t   room    = MAX_RECORD_BYTES - m_size - OVERHEAD;
+    uint16_t clamped = static_cast<uint16_t>(length < room ? length : room);
+
+    m_data[m_size] = static_cast<uint8_t>(ELogArgType::STRING);
+    memcpy(m_data + m_size + 1, &clamped, sizeof(clamped));
+    memcpy(m_data + m_size + 1 + sizeof(clamped), text, clamped);
+    m_data[m_size + 1 + sizeof(clamped) + clamped] = '\0';
+    m_size += OVERHEAD + clamped;
+    GetHeader().m_argCount++;
+}
+
+void FormatLogMessage(const char* format, const uint8_t* args, const uint8_t* argsEnd, std::string& out)
+{
+    const uint8_t* cursor = args;
+    const char*    c      = format;
+    while (*c)
+    {
+        if (*c != '%')
+        {
+            const char* next = strchr(c, '%');
+            size_t      run  = next ? static_cast<size_t>(next - c) : strlen(c);
+            out.append(c, run);
+            c += run;
+            continue;
+        }
+        if (c[1] == '%')
+        {
+            out.push_back('%');
+            c += 2;
+            continue;
+        }
+
+        // Rebuild the conversion spec without its length modifier, * widths take their value from the arguments
+        const char* specStart = c++;
+        std::string spec      = "%";
+        while (*c && strchr("-+ #0", *c)) spec.push_back(*c++);
+        for (int part = 0; part < 2; ++part)
+        {
+            if (part == 1)
+            {
+                if (*c != '.') break;
+                spec.push_back(*c++);
+            }
+            if (*c == '*')
+            {
+                LogArg width;
+                if (ReadArg(cursor, argsEnd, width)) spec += std::to_string(width.AsInt());
+                ++c;
+            }
+            while (*c >= '0' && *c <= '9') spec.push_back(*c++);
+        }
+        while (*c && strchr("hlLqjzt", *c)) ++c;
+        char conversion = *c;
+        if (!conversion)
+        {
+            out.append(specStart);
+            break;
+        }
+        ++c;
+
+        LogArg arg;
+        if (!ReadArg(cursor, argsEnd, arg))
+        {
+            out.append(specStart, static_cast<size_t>(c - specStart)); // Missing argument, keep the spec visible
+            continue;
+        }
+
+        if (conversion == 's')
+        {
+            if (arg.m_type == ELogArgType::STRING && spec.size() == 1)
+            {
+                out.append(arg.m_string, static_cast<size_t>(arg.m_bits));
+            }
+            else if (arg.m_type == ELogArgType::STRING)
+            {
+                AppendFormatted(out, (spec + 's').c_str(), arg.m_string);
+            }
+            else
+            {
+                AppendFormatted(out, (spec + 's').c_str(), arg.m_type == ELogArgType::DOUBLE ? std::to_string(arg.AsDouble()).c_str() : std::to_string(arg.AsInt()).c_str());
+            }
+        }
+        else if (arg.m_type == ELogArgType::STRING)
+        {
+            out.append(arg.m_string, static_cast<size_t>(arg.m_bits));
+        }
+        else if (IsIntegerConversion(conversion))
+        {
+            spec += "ll";
+            spec.push_back(conversion);
+            if (conversion == 'd' || conversion == 'i')
+                AppendFormatted(out, spec.c_str(), static_cast<long long>(arg.AsInt()));
+            else
+                AppendFormatted(out, spec.c_str(), static_cast<unsigned long long>(arg.AsUInt()));
+        }
+        else if (IsFloatConversion(conversion))
+        {
+            spec.push_back(conversion);
+            AppendFormatted(out, spec.c_str(), arg.AsDouble());
+        }
+        else if (conversion == 'c')
+        {
+            spec.push_back('c');
+            AppendFormatted(out, spec.c_str(), static_cast<int>(arg.AsInt()));
+        }
+        else if (conversion == 'p')
+        {
+            spec.push_back('p');
+            AppendFormatted(out, spec.c_str(), reinterpret_cast<const void*>(static_cast<uintptr_t>(arg.m_bits)));
+        }
+        else
+        {
+            out.append(specStart, static_cast<size_t>(c - specStart));
+        }
+    }
+}
+
+LogRingBuffer::LogRingBuffer(size_t capacity, uint32_t threadId) : m_threadId(threadId)
+{
+    size_t size = 1024;
+    while (size < capacity) size <<= 1;
+    m_buffer.resize(size);
+    m_mask = size - 1;
+}
+
+bool LogRingBuffer::Push(const uint8_t* data, size_t size)
+{
+    uint32_t recordSize = static_cast<uint32_t>(size);
+    size_t   head       = m_head.load(std::memory_order_relaxed);
+    size_t   tail       = m_tail.load(std::memory_order_acquire);
+    if (m_buffer.size() - (head - tail) < sizeof(recordSize) + size)
+    {
+        return false;
+    }
+    CopyIn(head, reinterpret_cast<const uint8_t*>(&recordSize), sizeof(recordSize));
+    CopyIn(head + sizeof(recordSize), data, size);
+    m_head.store(head + sizeof(recordSize) + size, std::memory_order_release);
+    return true;
+}
+
+size_t LogRingBuffer::Pop(uint8_t* out, size_t maxSize)
+{
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t head = m_head.load(std::memory_order_acquire);
+    if (head == tail)
+    {
+        return 0;
+    }
+    uint32_t recordSize;
+    CopyOut(tail, reinterpret_cast<uint8_t*>(&recordSize), sizeof(recordSize));
+    size_t copied = recordSize < maxSize ? recordSize : maxSize;
+    CopyOut(tail + sizeof(recordSize), out, copied);
+    m_tail.store(tail + sizeof(recordSize) + recordSize, std::memory_order_release);
+    return copied;
+}
+
+void LogRingBuffer::CopyIn(size_t position, const uint8_t* data, size_t size)
+{
+    size_t offset = position & m_mask;
+    size_t first  = size < m_buffer.size() - offset ? size : m_buffer.size() - offset;
+    memcpy(m_buffer.data() + offset, data, first);
+    memcpy(m_buffer.data(), data + first, size - first);
+}
+
+void LogRingBuffer::CopyOut(size_t position, uint8_t* out, size_t size) const
+{
+    size_t offset = position & m_mask;
+    size_t first  = size < m_buffer.size() - offset ? size : m_buffer.size() - offset;
+    memcpy(out, m_buffer.data() + offset, first);
+    memcpy(out + first, m_buffer.data(), size - first);
+}
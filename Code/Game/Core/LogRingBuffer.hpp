@@ -0,0 +1,134 @@
+﻿#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+enum class ELogCategory : uint32_t;
+enum class ELogVerbosity : uint8_t;
+
+enum class ELogArgType : uint8_t
+{
+    INT64,
+    UINT64,
+    DOUBLE,
+    POINTER,
+    STRING // uint16 length, bytes, '\0'
+};
+
+/// Fixed part of every log record, the raw arguments follow it
+struct LogRecordHeader
+{
+    uint64_t      m_timestampNs = 0; // Since the logger was constructed
+    const char*   m_file        = nullptr; // __FILE__, lives as long as the program
+    const char*   m_format      = nullptr; // String literal, enforced by LOG
+    int           m_line        = 0;
+    uint32_t      m_threadId    = 0;
+    ELogCategory  m_category{};
+    ELogVerbosity m_verbosity{};
+    uint8_t       m_argCount = 0;
+};
+
+/// LogRecordWriter ― Encodes a header and the raw LOG arguments on the stack, nothing is formatted on the calling thread.
+class LogRecordWriter
+{
+public:
+    static constexpr size_t MAX_RECORD_BYTES = 1024; // Long strings are truncated to fit
+
+    explicit LogRecordWriter(const LogRecordHeader& header);
+
+    template <typename T>
+    void Append(const T& value);
+
+    void           SetThreadId(uint32_t threadId) { GetHeader().m_threadId = threadId; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t         GetSize() const { return m_size; }
+
+private:
+    alignas(8) uint8_t m_data[MAX_RECORD_BYTES];
+    size_t m_size = 0;
+
+    LogRecordHeader& GetHeader() { return *reinterpret_cast<LogRecordHeader*>(m_data); }
+    void             AppendNumber(ELogArgType type, const void* value);
+    void             AppendString(const char* text, size_t length);
+};
+
+template <typename T>
+void LogRecordWriter::Append(const T& value)
+{
+    using Decayed = std::decay_t<T>;
+    if constexpr (std::is_same_v<Decayed, std::string> || std::is_same_v<Decayed, std::string_view>)
+    {
+        AppendString(value.data(), value.size());
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        AppendString(value, strlen(value)); // String literal
+    }
+    else if constexpr (std::is_same_v<Decayed, const char*> || std::is_same_v<Decayed, char*>)
+    {
+        const char* text = value ? value : "(null)";
+        AppendString(text, strlen(text));
+    }
+    else if constexpr (std::is_enum_v<Decayed>)
+    {
+        int64_t number = static_cast<int64_t>(value);
+        AppendNumber(ELogArgType::INT64, &number);
+    }
+    else if constexpr (std::is_floating_point_v<Decayed>)
+    {
+        double number = static_cast<double>(value);
+        AppendNumber(ELogArgType::DOUBLE, &number);
+    }
+    else if constexpr (std::is_integral_v<Decayed> && std::is_signed_v<Decayed>)
+    {
+        int64_t number = static_cast<int64_t>(value);
+        AppendNumber(ELogArgType::INT64, &number);
+    }
+    else if constexpr (std::is_integral_v<Decayed>)
+    {
+        uint64_t number = static_cast<uint64_t>(value);
+        AppendNumber(ELogArgType::UINT64, &number);
+    }
+    else if constexpr (std::is_pointer_v<Decayed>)
+    {
+        const void* pointer = static_cast<const void*>(value);
+        AppendNumber(ELogArgType::POINTER, &pointer);
+    }
+    else
+    {
+        static_assert(std::is_pointer_v<Decayed>, "LOG argument type is not supported");
+    }
+}
+
+/// Renders the printf style format of a record against its raw arguments. Length modifiers in the format are ignored,
+/// every integer is formatted as 64 bit so %d, %ld or %zu all print the value that was passed.
+void FormatLogMessage(const char* format, const uint8_t* args, const uint8_t* argsEnd, std::string& out);
+
+/// LogRingBuffer ― Single producer single consumer byte ring of length prefixed records, one per logging thread.
+class LogRingBuffer
+{
+public:
+    LogRingBuffer(size_t capacity, uint32_t threadId); // Capacity is rounded up to a power of two
+
+    /// Producer side, false when the record does not fit, the caller counts it as dropped
+    bool Push(const uint8_t* data, size_t size);
+    /// Consumer side, copies the oldest record into out and returns its size, 0 when empty
+    size_t Pop(uint8_t* out, size_t maxSize);
+
+    uint32_t GetThreadId() const { return m_threadId; }
+
+private:
+    std::vector<uint8_t> m_buffer;
+    size_t               m_mask     = 0;
+    uint32_t             m_threadId = 0;
+
+    alignas(64) std::atomic<size_t> m_head{0}; // Written by the producer
+    alignas(64) std::atomic<size_t> m_tail{0}; // Written by the consumer
+
+    void CopyIn(size_t position, const uint8_t* data, size_t size);
+    void CopyOut(size_t position, uint8_t* out, size_t size) const;
+};
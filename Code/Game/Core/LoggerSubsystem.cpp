@@ -1,12 +1,55 @@
 ﻿#include "LoggerSubsystem.hpp"
 
-#include <cstdarg>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
 
 #include "Game/GameCommon.hpp"
 
+namespace
+{
+    /// Per thread ring, tagged with its owner so a thread never pushes into the ring of another logger instance
+    thread_local LogRingBuffer*         t_ring  = nullptr;
+    thread_local const LoggerSubsystem* t_owner = nullptr;
+
+    uint64_t GetSteadyTicks()
+    {
+        using namespace std::chrono;
+        return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+}
 
-LoggerSubsystem::LoggerSubsystem(LoggerConfig& config) : m_config(config)
+bool LogRateLimiter::Allow(uint32_t maxPerSecond, uint32_t& outSuppressed)
 {
+    constexpr uint64_t WINDOW_NS = 1000000000ull;
+
+    outSuppressed    = 0;
+    uint64_t now     = GetSteadyTicks();
+    uint64_t started = m_windowStartNs.load(std::memory_order_relaxed);
+    if (now - started >= WINDOW_NS && m_windowStartNs.compare_exchange_strong(started, now, std::memory_order_relaxed))
+    {
+        // Only the thread that opened the window resets it, the others count against the fresh budget
+        m_count.store(0, std::memory_order_relaxed);
+        outSuppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+    }
+    if (m_count.fetch_add(1, std::memory_order_relaxed) < maxPerSecond)
+    {
+        return true;
+    }
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+LoggerSubsystem::LoggerSubsystem(const LoggerConfig& config) : m_config(config), m_startTicks(GetSteadyTicks())
+{
+}
+
+LoggerSubsystem::~LoggerSubsystem()
+{
+    Shutdown();
 }
 
 void LoggerSubsystem::Startup()
@@ -14,11 +57,36 @@ void LoggerSubsystem::Startup()
     EnableCategory(ELogCategory::LogSystem);
     EnableCategory(ELogCategory::LogActor);
     SetMinVerbosity(ELogVerbosity::Info);
+    bool binaryLogFailed = false;
+    if (!m_config.m_binaryLogPath.empty())
+    {
+        std::lock_guard<std::mutex> guard(m_printMutex);
+        binaryLogFailed = !m_binaryLog.Open(m_config.m_binaryLogPath);
+    }
+    if (m_config.m_async && !m_running.exchange(true))
+    {
+        m_flusher = std::thread(&LoggerSubsystem::FlusherMain, this);
+    }
     LOG(LogSystem, Info, "Start up Logger subsystem...");
+    if (binaryLogFailed)
+    {
+        LOG(LogSystem, Warning, "Could not open binary log %s", m_config.m_binaryLogPath);
+    }
 }
 
 void LoggerSubsystem::Shutdown()
 {
+    if (m_running.exchange(false))
+    {
+        m_flusherWake.notify_all();
+        if (m_flusher.joinable())
+        {
+            m_flusher.join();
+        }
+    }
+    DrainRings(); // Anything pushed while the flusher was stopping
+    std::lock_guard<std::mutex> guard(m_printMutex);
+    m_binaryLog.Close();
 }
 
 void LoggerSubsystem::SetCategoryMask(uint32_t mask)
@@ -26,6 +94,26 @@ void LoggerSubsystem::SetCategoryMask(uint32_t mask)
     m_categoryMask.store(mask);
 }
 
+void LoggerSubsystem::Flush()
+{
+    DrainRings();
+}
+
+const char* LoggerSubsystem::GetCategoryName(ELogCategory cat)
+{
+    static const char* catStr[] = {"Temp", "Render", "Game", "Audio", "Network", "System", "Resource", "Widget", "Actor"};
+    uint32_t           bits     = static_cast<uint32_t>(cat);
+    int                index    = bits ? static_cast<int>(log2(bits)) : -1; // mapping
+    return index >= 0 && index < static_cast<int>(std::size(catStr)) ? catStr[index] : "Unknown";
+}
+
+const char* LoggerSubsystem::GetVerbosityName(ELogVerbosity v)
+{
+    static const char* verbStr[] = {"INFO", "WARNING", "ERROR"};
+    int                index     = static_cast<int>(v);
+    return index < static_cast<int>(std::size(verbStr)) ? verbStr[index] : "UNKNOWN";
+}
+
 static const char* BaseName(const char* path) noexcept
 {
     const char* s1 = strrchr(path, '/');
@@ -34,29 +122,166 @@ static const char* BaseName(const char* path) noexcept
     return s ? (s + 1) : path;
 }
 
-void LoggerSubsystem::Log(ELogCategory cat, ELogVerbosity v, const char* file, int line, const char* fmt, ...) noexcept
+uint64_t LoggerSubsystem::GetTimestampNs() const
 {
-    // filter
-    if ((m_categoryMask.load() & static_cast<uint32_t>(cat)) == 0) return;
-    if (v < m_minVerbosity.load()) return;
-
-    // varargs → string
-    char    buffer[2048];
-    va_list args;
-    va_start(args, fmt);
-    _vsnprintf_s(buffer, sizeof(buffer), _TRUNCATE, fmt, args);
-    va_end(args);
+    return GetSteadyTicks() - m_startTicks;
+}
 
-    // Added headers (Category, Verbosity, Thread, FileName:Line)
-    const char* catStr[]  = {"Temp", "Render", "Game", "Audio", "Network", "System", "Resource", "Widget", "Actor"};
-    const char* verbStr[] = {"INFO", "WARNING", "ERROR"};
+LogRingBuffer* LoggerSubsystem::GetThreadRing()
+{
+    if (t_owner == this)
+    {
+        return t_ring;
+    }
+    std::lock_guard<std::mutex> guard(m_ringsMutex);
+    m_rings.push_back(std::make_unique<LogRingBuffer>(m_config.m_ringBytesPerThread, static_cast<uint32_t>(m_rings.size())));
+    t_ring  = m_rings.back().get();
+    t_owner = this;
+    return t_ring;
+}
 
-    const char* fileName = BaseName(file); // Only File name not the whole path
+void LoggerSubsystem::Submit(LogRecordWriter& record, ELogVerbosity v) noexcept
+{
+    if (m_running.load(std::memory_order_relaxed))
+    {
+        LogRingBuffer* ring = GetThreadRing();
+        record.SetThreadId(ring->GetThreadId());
+        if (!ring->Push(record.GetData(), record.GetSize()))
+        {
+            m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (v >= ELogVerbosity::Error)
+        {
+            m_flusherWake.notify_one(); // Errors should not wait for the next tick
+        }
+        return;
+    }
 
+    // Before Startup, after Shutdown or with m_async off, print on the calling thread
+    std::string                 text;
     std::lock_guard<std::mutex> guard(m_printMutex); // thread safe
-    printf("Log%s %s: @(%s:%d) %s\n",
-           catStr[static_cast<int>(log2(static_cast<uint32_t>(cat)))], // mapping
-           verbStr[static_cast<int>(v)],
-           fileName, line,
-           buffer);
+    Output(record.GetData(), record.GetSize(), text);
+    fwrite(text.data(), 1, text.size(), stdout);
+    m_binaryLog.Flush();
+}
+
+void LoggerSubsystem::FlusherMain()
+{
+    while (m_running.load())
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_flusherMutex);
+            m_flusherWake.wait_for(lock, std::chrono::milliseconds(m_config.m_flushIntervalMs));
+        }
+        DrainRings();
+    }
+}
+
+size_t LoggerSubsystem::DrainRings()
+{
+    struct PendingRecord
+    {
+        uint64_t m_timestampNs;
+        size_t   m_begin;
+        size_t   m_end;
+    };
+
+    static thread_local std::vector<uint8_t>       s_bytes;
+    static thread_local std::vector<PendingRecord> s_records;
+    static thread_local std::string                s_text;
+    s_bytes.clear();
+    s_records.clear();
+    s_text.clear();
+
+    // One consumer at a time, Flush may be called from any thread while the flusher runs
+    std::lock_guard<std::mutex> guard(m_printMutex);
+
+    std::vector<LogRingBuffer*> rings;
+    {
+        std::lock_guard<std::mutex> ringsGuard(m_ringsMutex);
+        for (const std::unique_ptr<LogRingBuffer>& ring : m_rings)
+        {
+            rings.push_back(ring.get());
+        }
+    }
+
+    for (LogRingBuffer* ring : rings)
+    {
+        while (true)
+        {
+            size_t begin = s_bytes.size();
+            s_bytes.resize(begin + LogRecordWriter::MAX_RECORD_BYTES);
+            size_t size = ring->Pop(s_bytes.data() + begin, LogRecordWriter::MAX_RECORD_BYTES);
+            s_bytes.resize(begin + size);
+            if (size == 0) break;
+
+            PendingRecord pending;
+            memcpy(&pending.m_timestampNs, s_bytes.data() + begin + offsetof(LogRecordHeader, m_timestampNs), sizeof(pending.m_timestampNs));
+            pending.m_begin = begin;
+            pending.m_end   = begin + size;
+            s_records.push_back(pending);
+        }
+    }
+
+    uint64_t dropped = m_droppedRecords.load();
+    if (s_records.empty() && dropped == m_reportedDrops)
+    {
+        return 0;
+    }
+
+    // Each ring is in order, interleave the threads back by timestamp
+    std::stable_sort(s_records.begin(), s_records.end(), [](const PendingRecord& a, const PendingRecord& b) { return a.m_timestampNs < b.m_timestampNs; });
+    for (const PendingRecord& pending : s_records)
+    {
+        Output(s_bytes.data() + pending.m_begin, pending.m_end - pending.m_begin, s_text);
+    }
+    if (dropped != m_reportedDrops)
+    {
+        if (m_config.m_textOutput)
+        {
+            char buffer[128];
+            snprintf(buffer, sizeof(buffer), "LogSystem WARNING: %llu log records dropped, ring buffer full\n", static_cast<unsigned long long>(dropped - m_reportedDrops));
+            s_text += buffer;
+        }
+        m_binaryLog.WriteDropped(dropped - m_reportedDrops);
+        m_reportedDrops = dropped;
+    }
+    if (!s_text.empty())
+    {
+        fwrite(s_text.data(), 1, s_text.size(), stdout);
+        fflush(stdout);
+    }
+    m_binaryLog.Flush();
+    return s_records.size();
+}
+
+void LoggerSubsystem::Output(const uint8_t* record, size_t size, std::string& text)
+{
+    if (m_binaryLog.IsOpen())
+    {
+        m_binaryLog.WriteRecord(record, size);
+    }
+    if (m_config.m_textOutput)
+    {
+        AppendRecordText(record, size, text);
+    }
+}
+
+void LoggerSubsystem::AppendRecordText(const uint8_t* record, size_t size, std::string& out)
+{
+    LogRecordHeader header; // Records are packed back to back, copy instead of casting
+    memcpy(&header, record, sizeof(header));
+
+    // Added headers (Category, Verbosity, FileName:Line)
+    out += "Log";
+    out += GetCategoryName(header.m_category);
+    out += ' ';
+    out += GetVerbosityName(header.m_verbosity);
+    out += ": @(";
+    out += BaseName(header.m_file); // Only File name not the whole path
+    out += ':';
+    out += std::to_string(header.m_line);
+    out += ") ";
+    FormatLogMessage(header.m_format, record + sizeof(LogRecordHeader), record + size, out);
+    out += '\n';
 }
@@ -1,22 +1,133 @@
 ﻿#pragma once
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Game/Core/LogBinaryFile.hpp"
+#include "Game/Core/LogRingBuffer.hpp"
+
 #define INTERNAL_LOG_CATEGORY(cat)   ELogCategory::cat
 #define INTERNAL_LOG_VERBOSITY(verb) ELogVerbosity::verb
 
-#define LOG(Category, Verbosity, Format, ...)                                   \
-g_theLoggerSubsystem->Log(                                                        \
-INTERNAL_LOG_CATEGORY(Category),                                        \
-INTERNAL_LOG_VERBOSITY(Verbosity),                                      \
-__FILE__,                                                               \
-__LINE__,                                                               \
-Format,                                                                 \
-##__VA_ARGS__)                                                          \
+/// Build time filter, LOG calls below the minimum verbosity or outside the mask compile to nothing.
+/// e.g. /DLOG_COMPILE_MIN_VERBOSITY=1 keeps only Warning and Error
+#ifndef LOG_COMPILE_MIN_VERBOSITY
+#define LOG_COMPILE_MIN_VERBOSITY 0
+#endif
+#ifndef LOG_COMPILE_CATEGORY_MASK
+#define LOG_COMPILE_CATEGORY_MASK 0xFFFFFFFFu
+#endif
+
+/// The format is kept by pointer until the flusher prints it, "" Format rejects anything but a string literal.
+/// Category and verbosity are checked before any argument is evaluated.
+#define LOG(Category, Verbosity, Format, ...)                                                    \
+LOG_IF_COMPILED(LogIsCompiledIn(INTERNAL_LOG_CATEGORY(Category), INTERNAL_LOG_VERBOSITY(Verbosity)), \
+                Category, Verbosity, Format, ##__VA_ARGS__)                                      \
+/**/
+
+/// LOG with an explicit compile time switch, CompiledIn must be a constant expression
+#define LOG_IF_COMPILED(CompiledIn, Category, Verbosity, Format, ...)                             \
+do                                                                                               \
+{                                                                                                \
+    if constexpr (CompiledIn)                                                                    \
+    {                                                                                            \
+        if (g_theLoggerSubsystem->IsEnabled(INTERNAL_LOG_CATEGORY(Category), INTERNAL_LOG_VERBOSITY(Verbosity))) \
+        {                                                                                        \
+            g_theLoggerSubsystem->Log(                                                           \
+                INTERNAL_LOG_CATEGORY(Category),                                                 \
+                INTERNAL_LOG_VERBOSITY(Verbosity),                                               \
+                __FILE__,                                                                        \
+                __LINE__,                                                                        \
+                "" Format,                                                                       \
+                ##__VA_ARGS__);                                                                  \
+        }                                                                                        \
+    }                                                                                            \
+}                                                                                                \
+while (0)                                                                                        \
+/**/
+
+/// At most MaxPerSecond records per second from this call site, the first record of the next window is preceded by
+/// one summary line with the number of calls that were suppressed.
+#define LOG_RATE_LIMITED(Category, Verbosity, MaxPerSecond, Format, ...)                          \
+INTERNAL_LOG_SITE(LogRateLimiter, MaxPerSecond, Category, Verbosity, Format, ##__VA_ARGS__)      \
+/**/
+
+/// Logs only every Every-th call of this call site, e.g. per frame state that is still worth a glance
+#define LOG_SAMPLED(Category, Verbosity, Every, Format, ...)                                     \
+INTERNAL_LOG_SITE(LogSampler, Every, Category, Verbosity, Format, ##__VA_ARGS__)                 \
 /**/
 
+/// The call site state is a function local static, only touched once the category and verbosity are enabled
+#define INTERNAL_LOG_SITE(SiteState, SiteLimit, Category, Verbosity, Format, ...)                 \
+do                                                                                               \
+{                                                                                                \
+    if constexpr (LogIsCompiledIn(INTERNAL_LOG_CATEGORY(Category), INTERNAL_LOG_VERBOSITY(Verbosity))) \
+    {                                                                                            \
+        if (g_theLoggerSubsystem->IsEnabled(INTERNAL_LOG_CATEGORY(Category), INTERNAL_LOG_VERBOSITY(Verbosity))) \
+        {                                                                                        \
+            static SiteState s_logSite;                                                          \
+            uint32_t         logSuppressed = 0;                                                  \
+            if (s_logSite.Allow(SiteLimit, logSuppressed))                                       \
+            {                                                                                    \
+                if (logSuppressed > 0)                                                           \
+                {                                                                                \
+                    g_theLoggerSubsystem->Log(INTERNAL_LOG_CATEGORY(Category), INTERNAL_LOG_VERBOSITY(Verbosity), \
+                                              __FILE__, __LINE__, "%u messages suppressed by the rate limit", logSuppressed); \
+                }                                                                                \
+                g_theLoggerSubsystem->Log(                                                       \
+                    INTERNAL_LOG_CATEGORY(Category),                                             \
+                    INTERNAL_LOG_VERBOSITY(Verbosity),                                           \
+                    __FILE__,                                                                    \
+                    __LINE__,                                                                    \
+                    "" Format,                                                                   \
+                    ##__VA_ARGS__);                                                              \
+            }                                                                                    \
+        }                                                                                        \
+    }                                                                                            \
+}                                                                                                \
+while (0)                                                                                        \
+/**/
+
+/// LogRateLimiter ― Lock free per call site budget of LOG_RATE_LIMITED, one second windows.
+class LogRateLimiter
+{
+public:
+    /// outSuppressed is set on the first allowed call of a window to the calls refused in the window before it
+    bool Allow(uint32_t maxPerSecond, uint32_t& outSuppressed);
+
+private:
+    std::atomic<uint64_t> m_windowStartNs{0};
+    std::atomic<uint32_t> m_count{0};
+    std::atomic<uint32_t> m_suppressed{0};
+};
+
+/// LogSampler ― Lock free per call site counter of LOG_SAMPLED.
+class LogSampler
+{
+public:
+    bool Allow(uint32_t every, uint32_t& outSuppressed)
+    {
+        outSuppressed = 0; // Sampling is expected, there is nothing to report
+        return every <= 1 || m_calls.fetch_add(1, std::memory_order_relaxed) % every == 0;
+    }
+
+private:
+    std::atomic<uint32_t> m_calls{0};
+};
+
 struct LoggerConfig
 {
+    bool   m_async              = true; // Format and print on a background thread, false prints on the calling thread
+    size_t m_ringBytesPerThread = 64 * 1024; // Records that do not fit before the next flush are dropped and counted
+    int    m_flushIntervalMs    = 2;
+
+    std::string m_binaryLogPath; // Non empty also writes every record to this binary log, decode it with LogDecode
+    bool        m_textOutput = true; // Print records as text to stdout
 };
 
 enum class ELogCategory : uint32_t
@@ -40,12 +151,19 @@ enum class ELogVerbosity : uint8_t
     Error = 2,
 };
 
+constexpr bool LogIsCompiledIn(ELogCategory cat, ELogVerbosity v)
+{
+    return (static_cast<uint32_t>(LOG_COMPILE_CATEGORY_MASK) & static_cast<uint32_t>(cat)) != 0 &&
+        v >= static_cast<ELogVerbosity>(LOG_COMPILE_MIN_VERBOSITY);
+}
+
 class LoggerSubsystem
 {
 public:
     LoggerSubsystem()                       = delete;
     LoggerSubsystem(const LoggerSubsystem&) = delete;
-    LoggerSubsystem(LoggerConfig& config);
+    LoggerSubsystem(const LoggerConfig& config);
+    ~LoggerSubsystem();
 
     void Startup();
     void Shutdown();
@@ -55,14 +173,66 @@ public:
 
     void SetMinVerbosity(ELogVerbosity v) { m_minVerbosity.store(v); }
 
-    void Log(ELogCategory cat, ELogVerbosity v,
-             const char*  file, int          line,
-             const char*  fmt, ...) noexcept;
+    uint32_t GetCategoryMask() const { return m_categoryMask.load(); }
+
+    bool IsEnabled(ELogCategory cat, ELogVerbosity v) const
+    {
+        return (m_categoryMask.load(std::memory_order_relaxed) & static_cast<uint32_t>(cat)) != 0 && v >= m_minVerbosity.load(std::memory_order_relaxed);
+    }
+
+    /// Captures the format pointer and the raw arguments into the calling thread's ring, the flusher thread formats them.
+    /// Does not filter, LOG checks IsEnabled before the arguments are evaluated.
+    template <typename... Args>
+    void Log(ELogCategory cat, ELogVerbosity v, const char* file, int line, const char* fmt, const Args&... args) noexcept;
+
+    /// Blocks until every record pushed so far has been printed
+    void Flush();
+
+    uint64_t GetDroppedCount() const { return m_droppedRecords.load(); }
+
+    static const char* GetCategoryName(ELogCategory cat);
+    static const char* GetVerbosityName(ELogVerbosity v);
 
 private:
-    LoggerConfig& m_config;
+    LoggerConfig m_config; // By value, App hands in a stack local
 
     std::atomic<uint32_t>      m_categoryMask{static_cast<uint32_t>(ELogCategory::LogTemp)}; // By default, only LogTemp is enabled
     std::atomic<ELogVerbosity> m_minVerbosity{ELogVerbosity::Info};
-    std::mutex                 m_printMutex; // Simple thread safety; ring buffer can be used for high-frequency logs
+    std::mutex                 m_printMutex; // Serializes the flusher and the synchronous path
+    LogBinaryWriter            m_binaryLog; // Guarded by m_printMutex
+
+    /// Async backend
+    std::vector<std::unique_ptr<LogRingBuffer>> m_rings;
+    std::mutex                                  m_ringsMutex; // Only taken when a thread logs for the first time
+    std::thread                                 m_flusher;
+    std::mutex                                  m_flusherMutex;
+    std::condition_variable                     m_flusherWake;
+    std::atomic<bool>                           m_running{false};
+    std::atomic<uint64_t>                       m_droppedRecords{0};
+    uint64_t                                    m_reportedDrops = 0;
+    uint64_t                                    m_startTicks    = 0;
+
+    uint64_t       GetTimestampNs() const;
+    LogRingBuffer* GetThreadRing();
+    void           Submit(LogRecordWriter& record, ELogVerbosity v) noexcept;
+    void           FlusherMain();
+    size_t         DrainRings(); // Returns the number of records printed
+    void           Output(const uint8_t* record, size_t size, std::string& text); // Caller holds m_printMutex
+    static void    AppendRecordText(const uint8_t* record, size_t size, std::string& out);
 };
+
+template <typename... Args>
+void LoggerSubsystem::Log(ELogCategory cat, ELogVerbosity v, const char* file, int line, const char* fmt, const Args&... args) noexcept
+{
+    LogRecordHeader header;
+    header.m_timestampNs = GetTimestampNs();
+    header.m_file        = file;
+    header.m_format      = fmt;
+    header.m_line        = line;
+    header.m_category    = cat;
+    header.m_verbosity   = v;
+
+    LogRecordWriter record(header);
+    (record.Append(args), ...);
+    Submit(record, v);
+}
@@ -0,0 +1,179 @@
+﻿#include "LoopbackTransport.hpp"
+
+#include <algorithm>
+
+LoopbackTransport::LoopbackTransport(LoopbackNetwork* network, bool isServer, size_t clientIndex)
+    : m_network(network)
+    , m_isServer(isServer)
+    , m_clientIndex(clientIndex)
+{
+    if (!m_isServer)
+    {
+        m_inbound.resize(1);
+    }
+}
+
+bool LoopbackTransport::HasDataFromServer()
+{
+    return !m_isServer && !m_inbound[0].m_bytes.empty();
+}
+
+std::vector<uint8_t> LoopbackTransport::ReceiveFromServer()
+{
+    return m_isServer ? std::vector<uint8_t>() : Read(0);
+}
+
+bool LoopbackTransport::HasDataFromClient(size_t clientIndex)
+{
+    return m_isServer && clientIndex < m_inbound.size() && !m_inbound[clientIndex].m_bytes.empty();
+}
+
+std::vector<uint8_t> LoopbackTransport::ReceiveFromClient(size_t clientIndex)
+{
+    return m_isServer && clientIndex < m_inbound.size() ? Read(clientIndex) : std::vector<uint8_t>();
+}
+
+void LoopbackTransport::SendStringToServer(const std::string& message)
+{
+    if (m_isServer) return;
+    m_network->Send(m_network->GetServer(), m_clientIndex, message);
+}
+
+void LoopbackTransport::BroadcastStringToClients(const std::string& message)
+{
+    if (!m_isServer) return;
+    for (size_t clientIndex = 0; clientIndex < m_network->GetClientCount(); ++clientIndex)
+    {
+        m_network->Send(m_network->GetClient(clientIndex), 0, message);
+    }
+}
+
+size_t LoopbackTransport::GetConnectedClientCount() const
+{
+    return m_isServer ? m_network->GetClientCount() : 0;
+}
+
+MessageBoundaryMode LoopbackTransport::GetMessageBoundaryMode() const
+{
+    return m_network->m_mode;
+}
+
+char LoopbackTransport::GetMessageDelimiter() const
+{
+    return m_network->m_delimiter;
+}
+
+double LoopbackTransport::GetTimeSeconds() const
+{
+    return m_network->GetTimeSeconds();
+}
+
+bool LoopbackTransport::HasPendingData() const
+{
+    for (const Inbound& inbound : m_inbound)
+    {
+        if (!inbound.m_bytes.empty()) return true;
+    }
+    return false;
+}
+
+std::vector<uint8_t> LoopbackTransport::Read(size_t slot)
+{
+    std::vector<uint8_t>& bytes = m_inbound[slot].m_bytes;
+
+    size_t               readSize = m_network->GetReadSize(bytes.size());
+    std::vector<uint8_t> data(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(readSize));
+    bytes.erase(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(readSize));
+
+    m_network->m_stats.m_reads++;
+    return data;
+}
+
+LoopbackNetwork::LoopbackNetwork(const LoopbackLinkConfig& config, MessageBoundaryMode mode, char delimiter)
+    : m_config(config)
+    , m_mode(mode)
+    , m_delimiter(delimiter)
+    , m_random(config.m_seed)
+{
+    m_server = std::make_unique<LoopbackTransport>(this, true, 0);
+}
+
+LoopbackTransport* LoopbackNetwork::AddClient()
+{
+    size_t clientIndex = m_clients.size();
+    m_clients.push_back(std::make_unique<LoopbackTransport>(this, false, clientIndex));
+    m_server->m_inbound.resize(m_clients.size());
+    return m_clients.back().get();
+}
+
+void LoopbackNetwork::Advance(double seconds)
+{
+    m_timeSeconds += seconds;
+
+    while (!m_inFlight.empty() && m_inFlight.begin()->first <= m_timeSeconds)
+    {
+        Packet&               packet  = m_inFlight.begin()->second;
+        std::vector<uint8_t>& inbound = packet.m_to->m_inbound[packet.m_slot].m_bytes;
+        inbound.insert(inbound.end(), packet.m_bytes.begin(), packet.m_bytes.end());
+        m_stats.m_bytesDelivered += packet.m_bytes.size();
+        m_inFlight.erase(m_inFlight.begin());
+    }
+}
+
+bool LoopbackNetwork::IsIdle() const
+{
+    if (!m_inFlight.empty() || m_server->HasPendingData()) return false;
+    for (const std::unique_ptr<LoopbackTransport>& client : m_clients)
+    {
+        if (client->HasPendingData()) return false;
+    }
+    return true;
+}
+
+void LoopbackNetwork::Send(LoopbackTransport* to, size_t slot, const std::string& message)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    m_stats.m_messagesSent++;
+
+    if (unit(m_random) < static_cast<double>(m_config.m_lossChance))
+    {
+        m_stats.m_messagesDropped++;
+        return;
+    }
+
+    double  deliverAt     = m_timeSeconds + m_config.m_latencySeconds + unit(m_random) * m_config.m_jitterSeconds;
+    double& lastDeliverAt = to->m_inbound[slot].m_lastDeliverAt;
+
+    if (unit(m_random) < static_cast<double>(m_config.m_reorderChance))
+    {
+        // Held back long enough for the following messages to overtake it
+        deliverAt += unit(m_random) * (m_config.m_latencySeconds + m_config.m_jitterSeconds + 0.01);
+        m_stats.m_messagesReordered++;
+    }
+    else
+    {
+        // A stream never delivers out of order on its own, jitter only delays the rest of the link
+        deliverAt     = std::max(deliverAt, lastDeliverAt);
+        lastDeliverAt = deliverAt;
+    }
+
+    Packet packet;
+    packet.m_to   = to;
+    packet.m_slot = slot;
+    packet.m_bytes.assign(message.begin(), message.end());
+    if (m_mode != MessageBoundaryMode::RAW_BYTES)
+    {
+        packet.m_bytes.push_back(static_cast<uint8_t>(m_delimiter));
+    }
+    m_inFlight.emplace(deliverAt, std::move(packet));
+}
+
+size_t LoopbackNetwork::GetReadSize(size_t available)
+{
+    if (m_config.m_maxReadBytes == 0 || available <= 1)
+    {
+        return available;
+    }
+    std::uniform_int_distribution<size_t> readSize(1, std::min(available, m_config.m_maxReadBytes));
+    return readSize(m_random);
+}
@@ -0,0 +1,115 @@
+﻿#pragma once
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Game/Core/Network/NetworkTransport.hpp"
+
+/// Impairments applied to every message that travels through a LoopbackNetwork.
+struct LoopbackLinkConfig
+{
+    double   m_latencySeconds = 0.0; // One way delay
+    double   m_jitterSeconds  = 0.0; // Uniform extra delay in [0, jitter]
+    float    m_lossChance     = 0.f; // Whole messages are dropped, the stream framing stays intact
+    float    m_reorderChance  = 0.f; // Chance a message ignores the in order delivery of its link
+    size_t   m_maxReadBytes   = 0; // 0 returns everything queued, otherwise each read returns 1 to max bytes
+    uint32_t m_seed           = 1;
+};
+
+struct LoopbackStats
+{
+    uint64_t m_messagesSent      = 0;
+    uint64_t m_messagesDropped   = 0;
+    uint64_t m_messagesReordered = 0;
+    uint64_t m_bytesDelivered    = 0;
+    uint64_t m_reads             = 0;
+};
+
+class LoopbackNetwork;
+
+/// One endpoint of a LoopbackNetwork, either the server or one of its clients.
+class LoopbackTransport : public INetworkTransport
+{
+    friend class LoopbackNetwork;
+
+public:
+    LoopbackTransport(LoopbackNetwork* network, bool isServer, size_t clientIndex);
+
+    bool                 HasDataFromServer() override;
+    std::vector<uint8_t> ReceiveFromServer() override;
+    bool                 HasDataFromClient(size_t clientIndex) override;
+    std::vector<uint8_t> ReceiveFromClient(size_t clientIndex) override;
+
+    void SendStringToServer(const std::string& message) override;
+    void BroadcastStringToClients(const std::string& message) override;
+
+    bool   IsConnectedAsClient() const override { return !m_isServer; }
+    bool   IsRunningAsServer() const override { return m_isServer; }
+    size_t GetConnectedClientCount() const override;
+
+    MessageBoundaryMode GetMessageBoundaryMode() const override;
+    char                GetMessageDelimiter() const override;
+    double              GetTimeSeconds() const override;
+
+    bool HasPendingData() const;
+
+private:
+    struct Inbound
+    {
+        std::vector<uint8_t> m_bytes;
+        double               m_lastDeliverAt = 0.0; // Keeps the link in order unless a message gets reordered
+    };
+
+    LoopbackNetwork*     m_network     = nullptr;
+    bool                 m_isServer    = false;
+    size_t               m_clientIndex = 0; // Slot of this client on the server
+    std::vector<Inbound> m_inbound; // Server: one per client, client: a single one for the server
+
+    std::vector<uint8_t> Read(size_t slot);
+};
+
+/// LoopbackNetwork ― In-process replacement of the socket layer driven by a virtual clock. Messages are delayed,
+/// dropped and reordered as configured, reads hand out arbitrary slices of the byte stream to stress the framing.
+class LoopbackNetwork
+{
+    friend class LoopbackTransport;
+
+public:
+    explicit LoopbackNetwork(const LoopbackLinkConfig& config, MessageBoundaryMode mode = MessageBoundaryMode::NULL_TERMINATED, char delimiter = '\0');
+
+    LoopbackTransport* GetServer() { return m_server.get(); }
+    LoopbackTransport* AddClient();
+    size_t             GetClientCount() const { return m_clients.size(); }
+    LoopbackTransport* GetClient(size_t clientIndex) { return m_clients[clientIndex].get(); }
+
+    void   Advance(double seconds); // Move the virtual clock and deliver what became due
+    double GetTimeSeconds() const { return m_timeSeconds; }
+    bool   IsIdle() const; // Nothing in flight and nothing left unread
+
+    const LoopbackStats&      GetStats() const { return m_stats; }
+    const LoopbackLinkConfig& GetConfig() const { return m_config; }
+
+private:
+    struct Packet
+    {
+        LoopbackTransport*   m_to   = nullptr;
+        size_t               m_slot = 0;
+        std::vector<uint8_t> m_bytes;
+    };
+
+    LoopbackLinkConfig                              m_config;
+    MessageBoundaryMode                             m_mode;
+    char                                            m_delimiter   = '\0';
+    double                                          m_timeSeconds = 0.0;
+    std::mt19937                                    m_random;
+    std::unique_ptr<LoopbackTransport>              m_server;
+    std::vector<std::unique_ptr<LoopbackTransport>> m_clients;
+    std::multimap<double, Packet>                   m_inFlight; // Keyed on delivery time, equal keys keep send order
+    LoopbackStats                                   m_stats;
+
+    void   Send(LoopbackTransport* to, size_t slot, const std::string& message);
+    size_t GetReadSize(size_t available);
+};
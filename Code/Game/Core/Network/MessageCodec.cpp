@@ -0,0 +1,213 @@
+﻿#include "MessageCodec.hpp"
+
+#include <cstring>
+
+namespace
+{
+    constexpr size_t LAST_LITERALS = 5; // The block always ends with literals, same as LZ4
+    constexpr size_t MATCH_LIMIT   = 12; // No match may start within the last bytes
+
+    uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t Hash(uint32_t sequence, int hashBits)
+    {
+        return (sequence * 2654435761u) >> (32 - hashBits);
+    }
+
+    void WriteLength(std::vector<uint8_t>& dst, size_t length)
+    {
+        while (length >= 255)
+        {
+            dst.push_back(255);
+            length -= 255;
+        }
+        dst.push_back(static_cast<uint8_t>(length));
+    }
+
+    bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length)
+    {
+        uint8_t value;
+        do
+        {
+            if (ip >= end) return false;
+            value = *ip++;
+            length += value;
+        }
+        while (value == 255);
+        return true;
+    }
+
+    void EmitSequence(std::vector<uint8_t>& dst, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength)
+    {
+        size_t  extraMatch = matchLength - MessageCodec::MIN_MATCH;
+        uint8_t token      = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+        if (offset > 0) token |= static_cast<uint8_t>(extraMatch < 15 ? extraMatch : 15);
+        dst.push_back(token);
+
+        if (literalLength >= 15) WriteLength(dst, literalLength - 15);
+        dst.insert(dst.end(), literals, literals + literalLength);
+
+        if (offset == 0) return; // Last literals
+
+        dst.push_back(static_cast<uint8_t>(offset & 0xFF));
+        dst.push_back(static_cast<uint8_t>(offset >> 8));
+        if (extraMatch >= 15) WriteLength(dst, extraMatch - 15);
+    }
+}
+
+bool MessageCodec::Encode(const std::string& message, char delimiter, std::string& outFrame)
+{
+    // Varint original size followed by the block
+    m_block.clear();
+    size_t size = message.size();
+    while (size >= 0x80)
+    {
+        m_block.push_back(static_cast<uint8_t>(size | 0x80));
+        size >>= 7;
+    }
+    m_block.push_back(static_cast<uint8_t>(size));
+    CompressBlock(reinterpret_cast<const uint8_t*>(message.data()), message.size(), m_block);
+
+    // Bail out early, escaping only grows the frame
+    if (m_block.size() + 1 >= message.size())
+    {
+        return false;
+    }
+
+    outFrame.clear();
+    outFrame.push_back(COMPRESSED_MARKER);
+    uint8_t reservedDelimiter = static_cast<uint8_t>(delimiter);
+    for (uint8_t byte : m_block)
+    {
+        if (byte == 0 || byte == ESCAPE_BYTE || byte == reservedDelimiter)
+        {
+            outFrame.push_back(static_cast<char>(ESCAPE_BYTE));
+            outFrame.push_back(static_cast<char>(byte ^ ESCAPE_XOR));
+        }
+        else
+        {
+            outFrame.push_back(static_cast<char>(byte));
+        }
+    }
+    return outFrame.size() < message.size();
+}
+
+bool MessageCodec::Decode(const std::string& frame, std::string& outMessage)
+{
+    if (!IsCompressedFrame(frame))
+    {
+        return false;
+    }
+
+    m_block.clear();
+    for (size_t i = 1; i < frame.size(); ++i)
+    {
+        uint8_t byte = static_cast<uint8_t>(frame[i]);
+        if (byte == ESCAPE_BYTE)
+        {
+            if (++i >= frame.size()) return false;
+            byte = static_cast<uint8_t>(frame[i]) ^ ESCAPE_XOR;
+        }
+        m_block.push_back(byte);
+    }
+
+    size_t originalSize = 0;
+    size_t headerSize   = 0;
+    for (int shift = 0;; shift += 7)
+    {
+        if (headerSize >= m_block.size() || shift > 56) return false;
+        uint8_t byte = m_block[headerSize++];
+        originalSize |= static_cast<size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) break;
+    }
+
+    // A sequence expands to at most 255 bytes per input byte, anything beyond is a corrupt header
+    if (originalSize > (m_block.size() - headerSize) * 255)
+    {
+        return false;
+    }
+
+    outMessage.resize(originalSize);
+    return DecompressBlock(m_block.data() + headerSize, m_block.size() - headerSize, reinterpret_cast<uint8_t*>(&outMessage[0]), originalSize);
+}
+
+size_t MessageCodec::CompressBlock(const uint8_t* src, size_t srcSize, std::vector<uint8_t>& dst)
+{
+    size_t startSize = dst.size();
+    std::memset(m_hashTable, 0, sizeof(m_hashTable));
+
+    size_t anchor = 0;
+    size_t ip     = 0;
+    size_t limit  = srcSize > MATCH_LIMIT ? srcSize - MATCH_LIMIT : 0;
+
+    while (ip < limit)
+    {
+        uint32_t  sequence  = Read32(src + ip);
+        uint32_t& slot      = m_hashTable[Hash(sequence, HASH_BITS)];
+        size_t    candidate = slot;
+        slot                = static_cast<uint32_t>(ip + 1);
+
+        if (candidate == 0 || ip - (candidate - 1) > MAX_OFFSET || Read32(src + candidate - 1) != sequence)
+        {
+            ++ip;
+            continue;
+        }
+
+        size_t reference   = candidate - 1;
+        size_t matchLength = MIN_MATCH;
+        while (ip + matchLength < srcSize - LAST_LITERALS && src[reference + matchLength] == src[ip + matchLength])
+        {
+            ++matchLength;
+        }
+
+        EmitSequence(dst, src + anchor, ip - anchor, ip - reference, matchLength);
+        ip += matchLength;
+        anchor = ip;
+    }
+
+    EmitSequence(dst, src + anchor, srcSize - anchor, 0, MIN_MATCH);
+    return dst.size() - startSize;
+}
+
+bool MessageCodec::DecompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+    const uint8_t* ip  = src;
+    const uint8_t* end = src + srcSize;
+    size_t         op  = 0;
+
+    while (ip < end)
+    {
+        uint8_t token = *ip++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(ip, end, literalLength)) return false;
+        if (literalLength > static_cast<size_t>(end - ip) || literalLength > dstSize - op) return false;
+        std::memcpy(dst + op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip >= end) break; // Last literals
+
+        if (end - ip < 2) return false;
+        size_t offset = static_cast<size_t>(ip[0]) | static_cast<size_t>(ip[1]) << 8;
+        ip += 2;
+        if (offset == 0 || offset > op) return false;
+
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !ReadLength(ip, end, matchLength)) return false;
+        matchLength += MIN_MATCH;
+        if (matchLength > dstSize - op) return false;
+
+        // Byte by byte, the match may overlap the bytes it produces
+        for (size_t i = 0; i < matchLength; ++i, ++op)
+        {
+            dst[op] = dst[op - offset];
+        }
+    }
+    return op == dstSize;
+}
@@ -0,0 +1,36 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// MessageCodec ― LZ4 block style compression of bulk network messages (snapshots, PGN, analysis).
+///
+/// A compressed frame is COMPRESSED_MARKER followed by the escaped varint original size and compressed block. Escaping
+/// keeps the message delimiter, 0x00 and ESCAPE_BYTE out of the frame so it travels through the text framing untouched.
+/// Plain commands never start with COMPRESSED_MARKER. The codec keeps its scratch buffers, encoding and decoding do not
+/// allocate once they have grown to the largest message seen.
+class MessageCodec
+{
+public:
+    static constexpr char     COMPRESSED_MARKER = '\x01';
+    static constexpr uint8_t  ESCAPE_BYTE       = 0x1B;
+    static constexpr uint8_t  ESCAPE_XOR        = 0x20;
+    static constexpr size_t   MIN_MATCH         = 4;
+    static constexpr int      HASH_BITS         = 12;
+    static constexpr uint32_t MAX_OFFSET        = 65535;
+
+    static bool IsCompressedFrame(const std::string& message) { return !message.empty() && message[0] == COMPRESSED_MARKER; }
+
+    /// Returns false when the frame would not be smaller than the message, outFrame is only meaningful on success.
+    bool Encode(const std::string& message, char delimiter, std::string& outFrame);
+    /// Returns false when the frame is malformed, outMessage keeps its capacity between calls.
+    bool Decode(const std::string& frame, std::string& outMessage);
+
+    /// Raw LZ4 style block, appends to dst and returns the number of bytes appended.
+    size_t      CompressBlock(const uint8_t* src, size_t srcSize, std::vector<uint8_t>& dst);
+    static bool DecompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+private:
+    uint32_t             m_hashTable[1 << HASH_BITS] = {}; // Position + 1 of the last occurrence of a hashed 4 byte sequence
+    std::vector<uint8_t> m_block;
+};
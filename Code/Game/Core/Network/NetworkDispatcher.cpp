@@ -1,15 +1,39 @@
 ﻿#include "NetworkDispatcher.hpp"
 
+#include <cstdlib>
+#include <cstring>
+
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
 #include "Engine/Network/NetworkSubsystem.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/Core/LoggerSubsystem.hpp"
+#include "Game/Core/ProfilerSubsystem.hpp"
 
 
 NetworkDispatcher::NetworkDispatcher(NetworkSubsystem* networkSubsystem)
-    : m_networkSubsystem(networkSubsystem)
+    : NetworkDispatcher(new NetworkSubsystemTransport(networkSubsystem))
+{
+    m_ownedTransport.reset(m_transport);
+}
+
+NetworkDispatcher::NetworkDispatcher(INetworkTransport* transport, CommandSink commandSink)
+    : m_transport(transport)
+    , m_commandSink(std::move(commandSink))
 {
+    if (!m_commandSink)
+    {
+        m_commandSink = [](const std::string& command) { g_theDevConsole->Execute(command); };
+    }
+
     // Preallocate client message buffer
     m_clientMessageBuffers.resize(20); // 支持更多客户端
+
+    // Ping right away on the first frame
+    m_lastPingSeconds = m_transport->GetTimeSeconds() - m_pingIntervalSeconds;
+
+    // Both ends run the same build, the nonce only has to differ between peers of one session
+    m_nonce = static_cast<uint32_t>(static_cast<uint64_t>(NetworkMetrics::GetTimeSeconds() * 1000000.0) ^ reinterpret_cast<uintptr_t>(this));
 }
 
 NetworkDispatcher::~NetworkDispatcher()
@@ -18,6 +42,11 @@ NetworkDispatcher::~NetworkDispatcher()
 
 bool NetworkDispatcher::ExecuteRemoteCmd()
 {
+    PROFILE_SCOPE("NetworkDispatcher::ExecuteRemoteCmd");
+    double frameStartSeconds = NetworkMetrics::GetTimeSeconds();
+    m_frameParseSeconds      = 0.0;
+    m_frameCommandSeconds    = 0.0;
+
     bool processedAnyMessage = false;
 
     // Process the message received from the server
@@ -32,43 +61,86 @@ bool NetworkDispatcher::ExecuteRemoteCmd()
         processedAnyMessage = true;
     }
 
+    SendHello();
+
+    double nowSeconds = m_transport->GetTimeSeconds();
+    if (m_pingIntervalSeconds > 0.0 && nowSeconds - m_lastPingSeconds >= m_pingIntervalSeconds)
+    {
+        SendPing();
+        m_lastPingSeconds = nowSeconds;
+    }
+
+    m_metrics.RecordFrame(NetworkMetrics::GetTimeSeconds() - frameStartSeconds, m_frameParseSeconds, m_frameCommandSeconds);
+    m_metrics.Update(nowSeconds);
+
     return processedAnyMessage;
 }
 
-bool NetworkDispatcher::ProcessServerMessages()
+bool NetworkDispatcher::SendToRemote(const std::string& command, bool allowCompression)
 {
-    if (!m_networkSubsystem->HasDataFromServer())
+    bool toServer = IsConnectedAsClient();
+    if (!toServer && !IsRunningAsServer())
     {
         return false;
     }
 
-    // Get new data
-    std::vector<uint8_t> serverData = m_networkSubsystem->ReceiveFromServer();
+    std::string message = command;
+    if (command.compare(0, 10, "ChessMove ") == 0)
+    {
+        uint32_t        sequence = m_nextMoveSequence++;
+        PendingRequest& pending  = m_pendingMoves[sequence % PENDING_MOVE_COUNT];
+        pending.m_sequence       = sequence;
+        pending.m_sentAtSeconds  = m_transport->GetTimeSeconds();
+        message += Stringf(" ack=%u id=%u", sequence, m_nonce);
+    }
+
+    if (allowCompression && m_enableCompression && message.size() >= m_compressionThresholdBytes && RemoteSupportsCodec(toServer) &&
+        m_codec.Encode(message, m_transport->GetMessageDelimiter(), m_encodedFrame))
+    {
+        return SendRaw(m_encodedFrame, toServer, message.size());
+    }
+    return SendRaw(message, toServer);
+}
 
-    // Process data according to the message boundary mode
-    std::vector<std::string> completeMessages = ProcessMessageData(m_serverMessageBuffer, serverData);
+bool NetworkDispatcher::ProcessServerMessages()
+{
+    bool processedAny = false;
 
-    // Execute the complete message
-    for (const std::string& message : completeMessages)
+    // A read may only return part of what arrived, keep reading until the transport is drained
+    while (m_transport->HasDataFromServer())
     {
-        if (!message.empty())
+        // Get new data
+        std::vector<uint8_t> serverData = m_transport->ReceiveFromServer();
+
+        // Process data according to the message boundary mode
+        double                   parseStartSeconds = NetworkMetrics::GetTimeSeconds();
+        std::vector<std::string> completeMessages  = ProcessMessageData(m_serverMessageBuffer, serverData);
+        m_frameParseSeconds += NetworkMetrics::GetTimeSeconds() - parseStartSeconds;
+        m_metrics.RecordReceive(NetworkMetrics::SERVER_CONNECTION, serverData.size(), completeMessages.size());
+
+        // Execute the complete message
+        for (const std::string& message : completeMessages)
         {
-            ExecuteCommand(message);
+            if (!message.empty())
+            {
+                ExecuteCommand(message, NetworkMetrics::SERVER_CONNECTION);
+                processedAny = true;
+            }
         }
     }
 
-    return !completeMessages.empty();
+    return processedAny;
 }
 
 bool NetworkDispatcher::ProcessClientMessages()
 {
-    if (m_networkSubsystem->GetServerState() != ServerState::LISTENING)
+    if (!m_transport->IsRunningAsServer())
     {
         return false;
     }
 
     bool   processedAny = false;
-    size_t clientCount  = m_networkSubsystem->GetConnectedClientCount();
+    size_t clientCount  = m_transport->GetConnectedClientCount();
 
     // Make sure the client buffer is large enough
     if (m_clientMessageBuffers.size() < clientCount)
@@ -78,21 +150,24 @@ bool NetworkDispatcher::ProcessClientMessages()
 
     for (size_t clientIndex = 0; clientIndex < clientCount; ++clientIndex)
     {
-        if (m_networkSubsystem->HasDataFromClient(clientIndex))
+        while (m_transport->HasDataFromClient(clientIndex))
         {
             // Get the new data of the client
-            std::vector<uint8_t> clientData = m_networkSubsystem->ReceiveFromClient(clientIndex);
+            std::vector<uint8_t> clientData = m_transport->ReceiveFromClient(clientIndex);
 
             // Process data according to the message boundary mode
-            std::vector<std::string> completeMessages = ProcessMessageData(
+            double                   parseStartSeconds = NetworkMetrics::GetTimeSeconds();
+            std::vector<std::string> completeMessages  = ProcessMessageData(
                 m_clientMessageBuffers[clientIndex], clientData);
+            m_frameParseSeconds += NetworkMetrics::GetTimeSeconds() - parseStartSeconds;
+            m_metrics.RecordReceive(NetworkMetrics::ClientConnection(clientIndex), clientData.size(), completeMessages.size());
 
             // Execute the complete message
             for (const std::string& message : completeMessages)
             {
                 if (!message.empty())
                 {
-                    ExecuteCommand(message);
+                    ExecuteCommand(message, NetworkMetrics::ClientConnection(clientIndex));
                     processedAny = true;
                 }
             }
@@ -104,7 +179,7 @@ bool NetworkDispatcher::ProcessClientMessages()
 
 std::vector<std::string> NetworkDispatcher::ProcessMessageData(std::string& buffer, const std::vector<uint8_t>& newData)
 {
-    MessageBoundaryMode mode = m_networkSubsystem->GetMessageBoundaryMode();
+    MessageBoundaryMode mode = m_transport->GetMessageBoundaryMode();
 
     switch (mode)
     {
@@ -137,7 +212,7 @@ std::vector<std::string> NetworkDispatcher::ExtractCompleteMessages(
     }
 
     // Get the current message separator
-    char delimiter = m_networkSubsystem->GetConfig().messageDelimiter;
+    char delimiter = m_transport->GetMessageDelimiter();
 
     // Find the complete message (ending with the delimiter)
     size_t startPos     = 0;
@@ -191,28 +266,236 @@ std::vector<std::string> NetworkDispatcher::ExtractRawMessages(const std::vector
     return messages;
 }
 
-void NetworkDispatcher::ExecuteCommand(const std::string& command)
+void NetworkDispatcher::ExecuteCommand(const std::string& message, int connection)
 {
+    const std::string* text = &message;
+    if (MessageCodec::IsCompressedFrame(message))
+    {
+        if (!m_codec.Decode(message, m_decodedMessage) || MessageCodec::IsCompressedFrame(m_decodedMessage))
+        {
+            m_metrics.GetConnection(connection).m_decodeErrors++;
+            return;
+        }
+        text = &m_decodedMessage;
+    }
+    const std::string& command = *text;
+
+    if (HandleControlMessage(command, connection))
+    {
+        return;
+    }
+
+    // ChessMove carries "ack=<seq> id=<nonce>" at the end, strip it before the DevConsole validates the sub args
+    size_t      ackPos  = command.compare(0, 10, "ChessMove ") == 0 ? command.find(" ack=") : std::string::npos;
+    std::string ackTail = ackPos != std::string::npos ? command.substr(ackPos) : std::string();
+
     // Add remote=true flag and execute
-    std::string commandWithRemote = command + " remote=true";
-    g_theDevConsole->Execute(commandWithRemote);
+    std::string commandWithRemote = (ackPos != std::string::npos ? command.substr(0, ackPos) : command) + " remote=true";
+
+    double commandStartSeconds = NetworkMetrics::GetTimeSeconds();
+    m_commandSink(commandWithRemote);
+    m_frameCommandSeconds += NetworkMetrics::GetTimeSeconds() - commandStartSeconds;
+
+    if (!ackTail.empty())
+    {
+        const char* sequence = std::strstr(ackTail.c_str(), "ack=");
+        const char* nonce    = std::strstr(ackTail.c_str(), "id=");
+        if (sequence && nonce)
+        {
+            SendRaw(Stringf("ChessMoveAck seq=%lu id=%lu", std::strtoul(sequence + 4, nullptr, 10), std::strtoul(nonce + 3, nullptr, 10)),
+                    connection == NetworkMetrics::SERVER_CONNECTION);
+        }
+    }
 
-#ifdef NETWORK_DEBUG
-    std::cout << "[NetworkDispatcher] Executing: " << command << std::endl;
-#endif
+    LOG_RATE_LIMITED(LogNetwork, Info, 20, "Executing remote command from connection %d: %s", connection, command);
 }
 
 bool NetworkDispatcher::IsConnectedAsClient() const
 {
-    return m_networkSubsystem->GetClientState() == ClientState::CONNECTED;
+    return m_transport->IsConnectedAsClient();
 }
 
 bool NetworkDispatcher::IsRunningAsServer() const
 {
-    return m_networkSubsystem->GetServerState() == ServerState::LISTENING;
+    return m_transport->IsRunningAsServer();
 }
 
 size_t NetworkDispatcher::GetConnectedClientCount() const
 {
-    return m_networkSubsystem->GetConnectedClientCount();
+    return m_transport->GetConnectedClientCount();
+}
+
+bool NetworkDispatcher::HandleControlMessage(const std::string& message, int connection)
+{
+    if (message.compare(0, 11, "ChessHello ") == 0)
+    {
+        SetRemoteSupportsCodec(connection, message.find("codec=lz4") != std::string::npos);
+        if (message.find("reply=true") == std::string::npos)
+        {
+            SendRaw(m_enableCompression ? "ChessHello codec=lz4 reply=true" : "ChessHello codec=none reply=true", connection == NetworkMetrics::SERVER_CONNECTION);
+        }
+        return true;
+    }
+
+    bool isPing = message.compare(0, 10, "ChessPing ") == 0;
+    bool isPong = message.compare(0, 10, "ChessPong ") == 0;
+    bool isAck  = message.compare(0, 13, "ChessMoveAck ") == 0;
+    if (!isPing && !isPong && !isAck)
+    {
+        return false;
+    }
+
+    const char* sequenceField = std::strstr(message.c_str(), "seq=");
+    const char* nonceField    = std::strstr(message.c_str(), "id=");
+    if (!sequenceField || !nonceField)
+    {
+        return true;
+    }
+    uint32_t sequence = static_cast<uint32_t>(std::strtoul(sequenceField + 4, nullptr, 10));
+    uint32_t nonce    = static_cast<uint32_t>(std::strtoul(nonceField + 3, nullptr, 10));
+
+    if (isPing)
+    {
+        SendRaw(Stringf("ChessPong seq=%u id=%u", sequence, nonce), connection == NetworkMetrics::SERVER_CONNECTION);
+        return true;
+    }
+
+    // A server broadcasts replies, so clients also see the replies meant for the other clients
+    if (nonce != m_nonce)
+    {
+        return true;
+    }
+
+    if (isPong)
+    {
+        RecordReply(m_pendingPings, PENDING_PING_COUNT, sequence, connection, true);
+    }
+    else
+    {
+        RecordReply(m_pendingMoves, PENDING_MOVE_COUNT, sequence, connection, false);
+    }
+    return true;
+}
+
+void NetworkDispatcher::SendPing()
+{
+    bool toServer = IsConnectedAsClient();
+    if (!toServer && (!IsRunningAsServer() || GetConnectedClientCount() == 0))
+    {
+        return;
+    }
+
+    uint32_t        sequence = m_nextPingSequence++;
+    PendingRequest& pending  = m_pendingPings[sequence % PENDING_PING_COUNT];
+    pending.m_sequence       = sequence;
+    pending.m_sentAtSeconds  = m_transport->GetTimeSeconds();
+    SendRaw(Stringf("ChessPing seq=%u id=%u", sequence, m_nonce), toServer);
+}
+
+void NetworkDispatcher::SendHello()
+{
+    const char* hello = m_enableCompression ? "ChessHello codec=lz4" : "ChessHello codec=none";
+
+    if (IsConnectedAsClient())
+    {
+        if (!m_helloSentToServer)
+        {
+            m_helloSentToServer = SendRaw(hello, true);
+        }
+    }
+    else if (m_helloSentToServer)
+    {
+        // Disconnected, the next server has to announce itself again
+        m_helloSentToServer = false;
+        SetRemoteSupportsCodec(NetworkMetrics::SERVER_CONNECTION, false);
+    }
+
+    size_t clientCount = IsRunningAsServer() ? GetConnectedClientCount() : 0;
+    if (clientCount != m_helloClientCount)
+    {
+        // Client slots may have shifted, ask everyone again
+        for (size_t clientIndex = 0; clientIndex < m_helloClientCount; ++clientIndex)
+        {
+            SetRemoteSupportsCodec(NetworkMetrics::ClientConnection(clientIndex), false);
+        }
+        m_helloClientCount = clientCount;
+        if (clientCount > 0)
+        {
+            SendRaw(hello, false);
+        }
+    }
+}
+
+bool NetworkDispatcher::SendRaw(const std::string& message, bool toServer, size_t uncompressedBytes)
+{
+    size_t wireBytes = message.size() + 1; // Message delimiter
+
+    if (toServer)
+    {
+        if (!IsConnectedAsClient()) return false;
+        m_transport->SendStringToServer(message);
+        m_metrics.RecordSend(NetworkMetrics::SERVER_CONNECTION, wireBytes);
+        if (uncompressedBytes > 0) m_metrics.RecordCompression(NetworkMetrics::SERVER_CONNECTION, uncompressedBytes, message.size());
+        return true;
+    }
+
+    if (!IsRunningAsServer()) return false;
+    m_transport->BroadcastStringToClients(message);
+    size_t clientCount = GetConnectedClientCount();
+    for (size_t clientIndex = 0; clientIndex < clientCount; ++clientIndex)
+    {
+        m_metrics.RecordSend(NetworkMetrics::ClientConnection(clientIndex), wireBytes);
+        if (uncompressedBytes > 0) m_metrics.RecordCompression(NetworkMetrics::ClientConnection(clientIndex), uncompressedBytes, message.size());
+    }
+    return true;
+}
+
+bool NetworkDispatcher::RemoteSupportsCodec(bool toServer) const
+{
+    auto supports = [this](int connection)
+    {
+        return connection < static_cast<int>(m_remoteSupportsCodec.size()) && m_remoteSupportsCodec[connection];
+    };
+
+    if (toServer)
+    {
+        return supports(NetworkMetrics::SERVER_CONNECTION);
+    }
+
+    // A broadcast is only compressed when every client can decode it
+    size_t clientCount = GetConnectedClientCount();
+    for (size_t clientIndex = 0; clientIndex < clientCount; ++clientIndex)
+    {
+        if (!supports(NetworkMetrics::ClientConnection(clientIndex))) return false;
+    }
+    return clientCount > 0;
+}
+
+void NetworkDispatcher::SetRemoteSupportsCodec(int connection, bool supported)
+{
+    if (connection >= static_cast<int>(m_remoteSupportsCodec.size()))
+    {
+        m_remoteSupportsCodec.resize(connection + 1, false);
+    }
+    m_remoteSupportsCodec[connection] = supported;
+}
+
+void NetworkDispatcher::RecordReply(const PendingRequest* pending, int count, uint32_t sequence, int connection, bool isPing)
+{
+    // Older slots are overwritten by newer requests, such late replies are simply dropped
+    const PendingRequest& request = pending[sequence % count];
+    if (request.m_sequence != sequence || request.m_sentAtSeconds < 0.0)
+    {
+        return;
+    }
+
+    double elapsedSeconds = m_transport->GetTimeSeconds() - request.m_sentAtSeconds;
+    if (isPing)
+    {
+        m_metrics.RecordRtt(connection, elapsedSeconds);
+    }
+    else
+    {
+        m_metrics.RecordMoveDelivery(connection, elapsedSeconds);
+    }
 }
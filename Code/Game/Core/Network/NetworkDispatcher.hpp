@@ -1,28 +1,82 @@
 ﻿#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "Game/Core/Network/MessageCodec.hpp"
+#include "Game/Core/Network/NetworkMetrics.hpp"
+#include "Game/Core/Network/NetworkTransport.hpp"
+
 class NetworkSubsystem;
 
 class NetworkDispatcher
 {
 public:
+    /// Receives every remote command with " remote=true" appended, the default executes it in the DevConsole
+    using CommandSink = std::function<void(const std::string& command)>;
+
     NetworkDispatcher(NetworkSubsystem* networkSubsystem);
+    NetworkDispatcher(INetworkTransport* transport, CommandSink commandSink = nullptr); // Does not take ownership of the transport
     ~NetworkDispatcher();
 
     bool ExecuteRemoteCmd();
 
+    /// Send a command string to the remote side, the server when connected as a client otherwise every client.
+    /// ChessMove commands are tagged with an ack sequence so the delivery latency can be measured.
+    /// Bulk payloads (snapshots, PGN, analysis) opt in to compression, it is only applied above the threshold and
+    /// when every receiver announced the codec in its ChessHello.
+    bool SendToRemote(const std::string& command, bool allowCompression = false);
+
     bool   IsConnectedAsClient() const;
     bool   IsRunningAsServer() const;
     size_t GetConnectedClientCount() const;
 
+    NetworkMetrics&       GetMetrics() { return m_metrics; }
+    const NetworkMetrics& GetMetrics() const { return m_metrics; }
+
+    double m_pingIntervalSeconds       = 1.0; // Zero disables the automatic ChessPing
+    bool   m_enableCompression         = true;
+    size_t m_compressionThresholdBytes = 512; // Smaller messages are sent as they are
+
 private:
-    NetworkSubsystem* m_networkSubsystem = nullptr;
+    INetworkTransport*                 m_transport = nullptr;
+    std::unique_ptr<INetworkTransport> m_ownedTransport;
+    CommandSink                        m_commandSink;
 
     // Message buffer: store incomplete messages
     std::string              m_serverMessageBuffer; // Incomplete message received from the server
     std::vector<std::string> m_clientMessageBuffers; // Incomplete messages received from various clients
 
+    // Instrumentation
+    struct PendingRequest
+    {
+        uint32_t m_sequence      = 0;
+        double   m_sentAtSeconds = -1.0;
+    };
+
+    static constexpr int PENDING_PING_COUNT = 16;
+    static constexpr int PENDING_MOVE_COUNT = 64;
+
+    NetworkMetrics m_metrics;
+    PendingRequest m_pendingPings[PENDING_PING_COUNT];
+    PendingRequest m_pendingMoves[PENDING_MOVE_COUNT];
+    uint32_t       m_nonce               = 0; // Identifies our own requests, a server broadcasts every reply to all clients
+    uint32_t       m_nextPingSequence    = 1;
+    uint32_t       m_nextMoveSequence    = 1;
+    double         m_lastPingSeconds     = 0.0;
+    double         m_frameParseSeconds   = 0.0;
+    double         m_frameCommandSeconds = 0.0;
+
+    // Compression, the buffers are reused for every message
+    MessageCodec      m_codec;
+    std::string       m_encodedFrame;
+    std::string       m_decodedMessage;
+    std::vector<bool> m_remoteSupportsCodec; // Indexed like the metrics connections
+    bool              m_helloSentToServer = false;
+    size_t            m_helloClientCount  = 0;
+
     // Message processing
     bool ProcessServerMessages();
     bool ProcessClientMessages();
@@ -31,8 +85,17 @@ private:
     std::vector<std::string> ExtractCompleteMessages(std::string& buffer, const std::vector<uint8_t>& newData);
     std::vector<std::string> ExtractRawMessages(const std::vector<uint8_t>& data); // for RAW_BYTES mode
 
-    void ExecuteCommand(const std::string& command);
+    void ExecuteCommand(const std::string& message, int connection);
 
     // Select the processing method according to the current boundary mode
     std::vector<std::string> ProcessMessageData(std::string& buffer, const std::vector<uint8_t>& newData);
+
+    // Ping / move acknowledge messages, handled here and never forwarded to the DevConsole
+    bool HandleControlMessage(const std::string& message, int connection);
+    void SendPing();
+    void SendHello();
+    bool SendRaw(const std::string& message, bool toServer, size_t uncompressedBytes = 0);
+    bool RemoteSupportsCodec(bool toServer) const;
+    void SetRemoteSupportsCodec(int connection, bool supported);
+    void RecordReply(const PendingRequest* pending, int count, uint32_t sequence, int connection, bool isPing);
 };
@@ -0,0 +1,265 @@
+﻿#include "NetworkMetrics.hpp"
+
+#include <chrono>
+#include <cmath>
+
+#include "Engine/Core/StringUtils.hpp"
+
+void LatencyHistogram::Record(double seconds)
+{
+    if (seconds < 0.0) seconds = 0.0;
+
+    int bucket = 0;
+    if (seconds > FIRST_BUCKET_LIMIT)
+    {
+        // limit(i) = FIRST_BUCKET_LIMIT * 2^(i / 4)
+        bucket = static_cast<int>(std::ceil(4.0 * std::log2(seconds / FIRST_BUCKET_LIMIT)));
+        if (bucket >= BUCKET_COUNT) bucket = BUCKET_COUNT - 1;
+    }
+    m_buckets[bucket]++;
+
+    if (m_count == 0 || seconds < m_min) m_min = seconds;
+    if (seconds > m_max) m_max = seconds;
+    m_sum += seconds;
+    m_count++;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    if (other.m_count == 0) return;
+
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        m_buckets[i] += other.m_buckets[i];
+    }
+    if (m_count == 0 || other.m_min < m_min) m_min = other.m_min;
+    if (other.m_max > m_max) m_max = other.m_max;
+    m_sum += other.m_sum;
+    m_count += other.m_count;
+}
+
+void LatencyHistogram::Reset()
+{
+    *this = LatencyHistogram();
+}
+
+double LatencyHistogram::GetPercentile(float percentile) const
+{
+    if (m_count == 0) return 0.0;
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(static_cast<double>(percentile) * static_cast<double>(m_count)));
+    if (target == 0) target = 1;
+
+    uint64_t accumulated = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        accumulated += m_buckets[i];
+        if (accumulated >= target)
+        {
+            // Never report more than what we actually observed
+            double upperBound = GetBucketUpperBound(i);
+            return upperBound < m_max ? upperBound : m_max;
+        }
+    }
+    return m_max;
+}
+
+double LatencyHistogram::GetBucketUpperBound(int bucketIndex)
+{
+    return FIRST_BUCKET_LIMIT * std::exp2(static_cast<double>(bucketIndex) / 4.0);
+}
+
+void NetworkMetrics::RecordReceive(int connection, size_t bytes, size_t messages)
+{
+    ConnectionMetrics& metrics = GetConnection(connection);
+    metrics.m_bytesIn += bytes;
+    metrics.m_messagesIn += messages;
+    metrics.m_windowBytesIn += bytes;
+    metrics.m_windowMessagesIn += messages;
+}
+
+void NetworkMetrics::RecordSend(int connection, size_t bytes)
+{
+    ConnectionMetrics& metrics = GetConnection(connection);
+    metrics.m_bytesOut += bytes;
+    metrics.m_messagesOut++;
+    metrics.m_windowBytesOut += bytes;
+    metrics.m_windowMessagesOut++;
+}
+
+void NetworkMetrics::RecordRtt(int connection, double seconds)
+{
+    ConnectionMetrics& metrics = GetConnection(connection);
+    metrics.m_lastRttSeconds   = seconds;
+    // Same smoothing factor as the TCP SRTT estimator
+    metrics.m_smoothedRttSeconds = metrics.m_rtt.GetCount() == 0 ? seconds : metrics.m_smoothedRttSeconds * 0.875 + seconds * 0.125;
+    metrics.m_rtt.Record(seconds);
+}
+
+void NetworkMetrics::RecordMoveDelivery(int connection, double seconds)
+{
+    GetConnection(connection).m_moveDeliveryLatency.Record(seconds);
+}
+
+void NetworkMetrics::RecordCompression(int connection, size_t uncompressedBytes, size_t compressedBytes)
+{
+    ConnectionMetrics& metrics = GetConnection(connection);
+    metrics.m_compressedMessagesOut++;
+    metrics.m_uncompressedBytesOut += uncompressedBytes;
+    metrics.m_compressedBytesOut += compressedBytes;
+}
+
+void NetworkMetrics::RecordFrame(double executeSeconds, double parseSeconds, double commandSeconds)
+{
+    m_frame.m_lastExecuteSeconds = executeSeconds;
+    m_frame.m_lastParseSeconds   = parseSeconds;
+    m_frame.m_lastCommandSeconds = commandSeconds;
+    m_frame.m_executeHistogram.Record(executeSeconds);
+    m_frame.m_parseHistogram.Record(parseSeconds);
+
+    m_frame.m_windowExecuteSum += executeSeconds;
+    if (executeSeconds > m_frame.m_windowExecuteMax) m_frame.m_windowExecuteMax = executeSeconds;
+    m_frame.m_windowFrames++;
+}
+
+void NetworkMetrics::Update(double nowSeconds)
+{
+    if (!m_windowStarted)
+    {
+        m_windowStartSeconds = nowSeconds;
+        m_windowStarted      = true;
+        return;
+    }
+    double elapsed = nowSeconds - m_windowStartSeconds;
+    if (elapsed < m_windowSeconds) return;
+
+    for (ConnectionMetrics& metrics : m_connections)
+    {
+        metrics.m_bytesInPerSecond     = static_cast<double>(metrics.m_windowBytesIn) / elapsed;
+        metrics.m_bytesOutPerSecond    = static_cast<double>(metrics.m_windowBytesOut) / elapsed;
+        metrics.m_messagesInPerSecond  = static_cast<double>(metrics.m_windowMessagesIn) / elapsed;
+        metrics.m_messagesOutPerSecond = static_cast<double>(metrics.m_windowMessagesOut) / elapsed;
+        metrics.m_windowBytesIn        = 0;
+        metrics.m_windowBytesOut       = 0;
+        metrics.m_windowMessagesIn     = 0;
+        metrics.m_windowMessagesOut    = 0;
+    }
+
+    m_frame.m_avgExecuteSeconds = m_frame.m_windowFrames > 0 ? m_frame.m_windowExecuteSum / static_cast<double>(m_frame.m_windowFrames) : 0.0;
+    m_frame.m_maxExecuteSeconds = m_frame.m_windowExecuteMax;
+    m_frame.m_windowExecuteSum  = 0.0;
+    m_frame.m_windowExecuteMax  = 0.0;
+    m_frame.m_windowFrames      = 0;
+
+    m_windowStartSeconds = nowSeconds;
+}
+
+void NetworkMetrics::Reset()
+{
+    m_connections.clear();
+    m_frame         = DispatcherFrameMetrics();
+    m_windowStarted = false;
+}
+
+ConnectionMetrics& NetworkMetrics::GetConnection(int connection)
+{
+    if (connection < 0) connection = SERVER_CONNECTION;
+    while (static_cast<int>(m_connections.size()) <= connection)
+    {
+        ConnectionMetrics metrics;
+        int               index = static_cast<int>(m_connections.size());
+        metrics.m_label         = index == SERVER_CONNECTION ? std::string("server") : Stringf("client%d", index - 1);
+        m_connections.push_back(metrics);
+    }
+    return m_connections[connection];
+}
+
+std::string NetworkMetrics::ToText() const
+{
+    constexpr double MS = 1000.0;
+
+    std::string text = Stringf("Dispatcher: execute last=%.3fms avg=%.3fms max=%.3fms p99=%.3fms | parse last=%.3fms p99=%.3fms | commands last=%.3fms",
+                               m_frame.m_lastExecuteSeconds * MS, m_frame.m_avgExecuteSeconds * MS, m_frame.m_maxExecuteSeconds * MS,
+                               m_frame.m_executeHistogram.GetPercentile(0.99f) * MS,
+                               m_frame.m_lastParseSeconds * MS, m_frame.m_parseHistogram.GetPercentile(0.99f) * MS,
+                               m_frame.m_lastCommandSeconds * MS);
+
+    for (const ConnectionMetrics& metrics : m_connections)
+    {
+        if (metrics.m_messagesIn == 0 && metrics.m_messagesOut == 0) continue;
+        text += Stringf("\n[%s] in %.0f B/s %.1f msg/s (total %llu B, %llu msg) | out %.0f B/s %.1f msg/s (total %llu B, %llu msg)",
+                        metrics.m_label.c_str(),
+                        metrics.m_bytesInPerSecond, metrics.m_messagesInPerSecond,
+                        static_cast<unsigned long long>(metrics.m_bytesIn), static_cast<unsigned long long>(metrics.m_messagesIn),
+                        metrics.m_bytesOutPerSecond, metrics.m_messagesOutPerSecond,
+                        static_cast<unsigned long long>(metrics.m_bytesOut), static_cast<unsigned long long>(metrics.m_messagesOut));
+        text += Stringf("\n[%s] rtt last=%.2fms smoothed=%.2fms p50=%.2fms p99=%.2fms | move delivery p50=%.2fms p99=%.2fms (%llu moves)",
+                        metrics.m_label.c_str(),
+                        metrics.m_lastRttSeconds * MS, metrics.m_smoothedRttSeconds * MS,
+                        metrics.m_rtt.GetPercentile(0.5f) * MS, metrics.m_rtt.GetPercentile(0.99f) * MS,
+                        metrics.m_moveDeliveryLatency.GetPercentile(0.5f) * MS, metrics.m_moveDeliveryLatency.GetPercentile(0.99f) * MS,
+                        static_cast<unsigned long long>(metrics.m_moveDeliveryLatency.GetCount()));
+        if (metrics.m_compressedMessagesOut > 0 || metrics.m_decodeErrors > 0)
+        {
+            text += Stringf("\n[%s] compressed %llu msg, %llu B -> %llu B | decode errors %llu",
+                            metrics.m_label.c_str(),
+                            static_cast<unsigned long long>(metrics.m_compressedMessagesOut),
+                            static_cast<unsigned long long>(metrics.m_uncompressedBytesOut), static_cast<unsigned long long>(metrics.m_compressedBytesOut),
+                            static_cast<unsigned long long>(metrics.m_decodeErrors));
+        }
+    }
+    return text;
+}
+
+static std::string HistogramToJson(const LatencyHistogram& histogram)
+{
+    constexpr double MS = 1000.0;
+    return Stringf("{\"count\":%llu,\"minMs\":%.4f,\"meanMs\":%.4f,\"p50Ms\":%.4f,\"p99Ms\":%.4f,\"maxMs\":%.4f}",
+                   static_cast<unsigned long long>(histogram.GetCount()),
+                   histogram.GetMin() * MS, histogram.GetMean() * MS,
+                   histogram.GetPercentile(0.5f) * MS, histogram.GetPercentile(0.99f) * MS,
+                   histogram.GetMax() * MS);
+}
+
+std::string NetworkMetrics::ToJson() const
+{
+    constexpr double MS = 1000.0;
+
+    std::string json = "{\"dispatcher\":";
+    json += Stringf("{\"lastExecuteMs\":%.4f,\"avgExecuteMs\":%.4f,\"maxExecuteMs\":%.4f,\"lastParseMs\":%.4f,\"lastCommandMs\":%.4f,\"execute\":",
+                    m_frame.m_lastExecuteSeconds * MS, m_frame.m_avgExecuteSeconds * MS, m_frame.m_maxExecuteSeconds * MS,
+                    m_frame.m_lastParseSeconds * MS, m_frame.m_lastCommandSeconds * MS);
+    json += HistogramToJson(m_frame.m_executeHistogram);
+    json += ",\"parse\":";
+    json += HistogramToJson(m_frame.m_parseHistogram);
+    json += "},\"connections\":[";
+
+    for (size_t i = 0; i < m_connections.size(); ++i)
+    {
+        const ConnectionMetrics& metrics = m_connections[i];
+        if (i > 0) json += ",";
+        json += Stringf("{\"label\":\"%s\",\"bytesIn\":%llu,\"bytesOut\":%llu,\"messagesIn\":%llu,\"messagesOut\":%llu,"
+                        "\"bytesInPerSecond\":%.2f,\"bytesOutPerSecond\":%.2f,\"messagesInPerSecond\":%.2f,\"messagesOutPerSecond\":%.2f,"
+                        "\"compressedMessagesOut\":%llu,\"uncompressedBytesOut\":%llu,\"compressedBytesOut\":%llu,\"decodeErrors\":%llu,"
+                        "\"lastRttMs\":%.4f,\"smoothedRttMs\":%.4f,\"rtt\":",
+                        metrics.m_label.c_str(),
+                        static_cast<unsigned long long>(metrics.m_bytesIn), static_cast<unsigned long long>(metrics.m_bytesOut),
+                        static_cast<unsigned long long>(metrics.m_messagesIn), static_cast<unsigned long long>(metrics.m_messagesOut),
+                        metrics.m_bytesInPerSecond, metrics.m_bytesOutPerSecond, metrics.m_messagesInPerSecond, metrics.m_messagesOutPerSecond,
+                        static_cast<unsigned long long>(metrics.m_compressedMessagesOut), static_cast<unsigned long long>(metrics.m_uncompressedBytesOut),
+                        static_cast<unsigned long long>(metrics.m_compressedBytesOut), static_cast<unsigned long long>(metrics.m_decodeErrors),
+                        metrics.m_lastRttSeconds * MS, metrics.m_smoothedRttSeconds * MS);
+        json += HistogramToJson(metrics.m_rtt);
+        json += ",\"moveDelivery\":";
+        json += HistogramToJson(metrics.m_moveDeliveryLatency);
+        json += "}";
+    }
+    json += "]}";
+    return json;
+}
+
+double NetworkMetrics::GetTimeSeconds()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,122 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Fixed bucket latency histogram, buckets are exponentially spaced so both sub-millisecond loopback
+/// traffic and multi-second stalls land in a meaningful bucket without any allocation on record.
+class LatencyHistogram
+{
+public:
+    static constexpr int    BUCKET_COUNT       = 72;
+    static constexpr double FIRST_BUCKET_LIMIT = 0.0001; // 0.1 ms, each following bucket grows by 2^(1/4)
+
+    void   Record(double seconds);
+    void   Merge(const LatencyHistogram& other);
+    void   Reset();
+    double GetPercentile(float percentile) const; // percentile in [0, 1], returns the upper bound of the matching bucket
+    double GetMin() const { return m_count > 0 ? m_min : 0.0; }
+    double GetMax() const { return m_max; }
+    double GetMean() const { return m_count > 0 ? m_sum / static_cast<double>(m_count) : 0.0; }
+
+    uint64_t GetCount() const { return m_count; }
+
+    static double GetBucketUpperBound(int bucketIndex);
+
+private:
+    uint64_t m_buckets[BUCKET_COUNT] = {};
+    uint64_t m_count                 = 0;
+    double   m_sum                   = 0.0;
+    double   m_min                   = 0.0;
+    double   m_max                   = 0.0;
+};
+
+/// Traffic and latency of a single link, the server link of a client or one of the clients of a server.
+struct ConnectionMetrics
+{
+    std::string m_label;
+
+    // Totals since the connection slot was created
+    uint64_t m_bytesIn     = 0;
+    uint64_t m_bytesOut    = 0;
+    uint64_t m_messagesIn  = 0;
+    uint64_t m_messagesOut = 0;
+
+    // Rates measured over the last completed window
+    double m_bytesInPerSecond     = 0.0;
+    double m_bytesOutPerSecond    = 0.0;
+    double m_messagesInPerSecond  = 0.0;
+    double m_messagesOutPerSecond = 0.0;
+
+    // Round trip time from ChessPing / ChessPong
+    double           m_lastRttSeconds     = 0.0;
+    double           m_smoothedRttSeconds = 0.0;
+    LatencyHistogram m_rtt;
+
+    // Time from sending a ChessMove until the remote acknowledged its execution
+    LatencyHistogram m_moveDeliveryLatency;
+
+    // Outgoing messages that were sent compressed, and incoming frames that failed to decode
+    uint64_t m_compressedMessagesOut = 0;
+    uint64_t m_uncompressedBytesOut  = 0;
+    uint64_t m_compressedBytesOut    = 0;
+    uint64_t m_decodeErrors          = 0;
+
+    // Counters of the window that is currently being measured
+    uint64_t m_windowBytesIn     = 0;
+    uint64_t m_windowBytesOut    = 0;
+    uint64_t m_windowMessagesIn  = 0;
+    uint64_t m_windowMessagesOut = 0;
+};
+
+/// Per-frame timings of the dispatcher, all values are in seconds.
+struct DispatcherFrameMetrics
+{
+    double           m_lastParseSeconds   = 0.0; // Message boundary extraction of the last frame
+    double           m_lastExecuteSeconds = 0.0; // Whole ExecuteRemoteCmd of the last frame
+    double           m_lastCommandSeconds = 0.0; // DevConsole command execution of the last frame
+    double           m_maxExecuteSeconds  = 0.0; // Max ExecuteRemoteCmd of the last window
+    double           m_avgExecuteSeconds  = 0.0; // Average ExecuteRemoteCmd of the last window
+    LatencyHistogram m_executeHistogram;
+    LatencyHistogram m_parseHistogram;
+
+    double   m_windowExecuteSum = 0.0;
+    double   m_windowExecuteMax = 0.0;
+    uint64_t m_windowFrames     = 0;
+};
+
+/// NetworkMetrics ― Collects the wire, dispatcher and game thread costs of the NetworkDispatcher so multiplayer
+/// slowdowns can be attributed. Connection index 0 is the link to the server, client N uses index N + 1.
+class NetworkMetrics
+{
+public:
+    static constexpr int SERVER_CONNECTION = 0;
+
+    void RecordReceive(int connection, size_t bytes, size_t messages);
+    void RecordSend(int connection, size_t bytes);
+    void RecordRtt(int connection, double seconds);
+    void RecordMoveDelivery(int connection, double seconds);
+    void RecordCompression(int connection, size_t uncompressedBytes, size_t compressedBytes);
+    void RecordFrame(double executeSeconds, double parseSeconds, double commandSeconds);
+
+    void Update(double nowSeconds); // Close the rate window when it has elapsed, the first call opens it on the caller's clock
+    void Reset();
+
+    ConnectionMetrics&                    GetConnection(int connection);
+    const std::vector<ConnectionMetrics>& GetConnections() const { return m_connections; }
+    const DispatcherFrameMetrics&         GetFrameMetrics() const { return m_frame; }
+
+    std::string ToText() const;
+    std::string ToJson() const;
+
+    static int    ClientConnection(size_t clientIndex) { return static_cast<int>(clientIndex) + 1; }
+    static double GetTimeSeconds(); // Monotonic high resolution time
+
+    double m_windowSeconds = 1.0;
+
+private:
+    std::vector<ConnectionMetrics> m_connections;
+    DispatcherFrameMetrics         m_frame;
+    double                         m_windowStartSeconds = 0.0;
+    bool                           m_windowStarted      = false; // The transport clock may be virtual, only Update knows it
+};
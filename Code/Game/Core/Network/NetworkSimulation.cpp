@@ -0,0 +1,188 @@
+﻿#include "NetworkSimulation.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Game/Core/Network/NetworkDispatcher.hpp"
+
+namespace
+{
+    const std::string SIM_TAG       = " sim=";
+    const std::string REMOTE_SUFFIX = " remote=true";
+
+    /// What one endpoint has received so far, senders are identified by the script index modulo the endpoint count
+    struct ReceiverState
+    {
+        std::vector<int64_t> m_lastIndexFromSender;
+        std::vector<uint8_t> m_seen;
+    };
+
+    void VerifyReceived(const std::string& command, ReceiverState& receiver, const std::vector<std::string>& scriptLines, size_t totalMessages,
+                        NetworkSimulationResult& result)
+    {
+        result.m_delivered++;
+        result.m_commandBytes += command.size();
+
+        if (command.size() <= REMOTE_SUFFIX.size() || command.compare(command.size() - REMOTE_SUFFIX.size(), REMOTE_SUFFIX.size(), REMOTE_SUFFIX) != 0)
+        {
+            result.m_corrupted++;
+            return;
+        }
+
+        size_t tagPos = command.rfind(SIM_TAG);
+        size_t endPos = command.size() - REMOTE_SUFFIX.size();
+        if (tagPos == std::string::npos || tagPos + SIM_TAG.size() >= endPos)
+        {
+            result.m_corrupted++;
+            return;
+        }
+
+        size_t index = 0;
+        for (size_t i = tagPos + SIM_TAG.size(); i < endPos; ++i)
+        {
+            if (!std::isdigit(static_cast<unsigned char>(command[i])))
+            {
+                result.m_corrupted++;
+                return;
+            }
+            index = index * 10 + static_cast<size_t>(command[i] - '0');
+        }
+
+        if (index >= totalMessages || command.compare(0, tagPos, scriptLines[index % scriptLines.size()]) != 0)
+        {
+            result.m_corrupted++;
+            return;
+        }
+
+        if (receiver.m_seen[index])
+        {
+            result.m_duplicated++;
+            return;
+        }
+        receiver.m_seen[index] = 1;
+
+        int64_t& lastIndex = receiver.m_lastIndexFromSender[index % receiver.m_lastIndexFromSender.size()];
+        if (static_cast<int64_t>(index) < lastIndex)
+        {
+            result.m_outOfOrder++;
+        }
+        lastIndex = std::max(lastIndex, static_cast<int64_t>(index));
+    }
+}
+
+bool NetworkSimulationResult::IsFramingIntact() const
+{
+    if (m_corrupted > 0 || m_duplicated > 0 || m_decodeErrors > 0) return false;
+    if (!m_reorderEnabled && m_outOfOrder > 0) return false;
+    // Without loss every message has to arrive
+    return m_link.m_messagesDropped > 0 || m_delivered == m_expectedDeliveries;
+}
+
+std::string NetworkSimulationResult::ToText() const
+{
+    constexpr double MS = 1000.0;
+
+    double wallSeconds = m_wallSeconds > 0.0 ? m_wallSeconds : 1.0;
+    return Stringf("Framing: %s, delivered %llu/%llu, corrupted %llu, duplicated %llu, out of order %llu, compressed %llu, decode errors %llu\n"
+                   "Link: %llu messages, %llu dropped, %llu reordered, %llu reads\n"
+                   "Throughput: %.0f msg/s, %.0f B/s over %.3fs wall (%.2fs simulated)\n"
+                   "Move delivery p50=%.2fms p99=%.2fms, RTT p50=%.2fms p99=%.2fms, ExecuteRemoteCmd p99=%.3fms",
+                   IsFramingIntact() ? "INTACT" : "BROKEN",
+                   static_cast<unsigned long long>(m_delivered), static_cast<unsigned long long>(m_expectedDeliveries),
+                   static_cast<unsigned long long>(m_corrupted), static_cast<unsigned long long>(m_duplicated), static_cast<unsigned long long>(m_outOfOrder),
+                   static_cast<unsigned long long>(m_compressedMessages), static_cast<unsigned long long>(m_decodeErrors),
+                   static_cast<unsigned long long>(m_link.m_messagesSent), static_cast<unsigned long long>(m_link.m_messagesDropped),
+                   static_cast<unsigned long long>(m_link.m_messagesReordered), static_cast<unsigned long long>(m_link.m_reads),
+                   static_cast<double>(m_delivered) / wallSeconds, static_cast<double>(m_commandBytes) / wallSeconds, m_wallSeconds, m_simulatedSeconds,
+                   m_moveDelivery.GetPercentile(0.5f) * MS, m_moveDelivery.GetPercentile(0.99f) * MS,
+                   m_rtt.GetPercentile(0.5f) * MS, m_rtt.GetPercentile(0.99f) * MS,
+                   m_dispatcherExecute.GetPercentile(0.99f) * MS);
+}
+
+NetworkSimulationResult NetworkSimulation::Run(const NetworkSimulationConfig& config, const std::vector<std::string>& scriptLines)
+{
+    NetworkSimulationResult result;
+    result.m_reorderEnabled = config.m_link.m_reorderChance > 0.f;
+    if (scriptLines.empty())
+    {
+        return result;
+    }
+
+    int    clientCount   = std::max(1, config.m_clientCount);
+    int    endpointCount = clientCount + 1; // Endpoint 0 is the server
+    size_t totalMessages = scriptLines.size() * static_cast<size_t>(std::max(1, config.m_repeat));
+
+    std::vector<ReceiverState> receivers(endpointCount);
+    for (ReceiverState& receiver : receivers)
+    {
+        receiver.m_lastIndexFromSender.assign(endpointCount, -1);
+        receiver.m_seen.assign(totalMessages, 0);
+    }
+
+    LoopbackNetwork                                 network(config.m_link);
+    std::vector<std::unique_ptr<NetworkDispatcher>> dispatchers;
+    for (int endpoint = 0; endpoint < endpointCount; ++endpoint)
+    {
+        INetworkTransport* transport = endpoint == 0 ? static_cast<INetworkTransport*>(network.GetServer()) : network.AddClient();
+        ReceiverState*     receiver  = &receivers[endpoint];
+        dispatchers.push_back(std::make_unique<NetworkDispatcher>(transport, [receiver, &scriptLines, totalMessages, &result](const std::string& command)
+        {
+            VerifyReceived(command, *receiver, scriptLines, totalMessages, result);
+        }));
+        if (config.m_compress)
+        {
+            dispatchers.back()->m_compressionThresholdBytes = 0;
+        }
+    }
+
+    auto stepFrame = [&]()
+    {
+        network.Advance(config.m_frameSeconds);
+        for (std::unique_ptr<NetworkDispatcher>& dispatcher : dispatchers)
+        {
+            dispatcher->ExecuteRemoteCmd();
+        }
+    };
+
+    double wallStartSeconds = NetworkMetrics::GetTimeSeconds();
+
+    size_t nextMessage      = 0;
+    size_t messagesPerFrame = static_cast<size_t>(std::max(1, config.m_messagesPerFrame)) * static_cast<size_t>(endpointCount);
+    while (nextMessage < totalMessages)
+    {
+        for (size_t i = 0; i < messagesPerFrame && nextMessage < totalMessages; ++i, ++nextMessage)
+        {
+            int sender = static_cast<int>(nextMessage % static_cast<size_t>(endpointCount));
+            dispatchers[sender]->SendToRemote(scriptLines[nextMessage % scriptLines.size()] + SIM_TAG + std::to_string(nextMessage), config.m_compress);
+            result.m_messagesSent++;
+            result.m_expectedDeliveries += sender == 0 ? static_cast<uint64_t>(clientCount) : 1;
+        }
+        stepFrame();
+    }
+
+    double drainEndSeconds = network.GetTimeSeconds() + config.m_drainSeconds;
+    while (!network.IsIdle() && network.GetTimeSeconds() < drainEndSeconds)
+    {
+        stepFrame();
+    }
+
+    result.m_wallSeconds      = NetworkMetrics::GetTimeSeconds() - wallStartSeconds;
+    result.m_simulatedSeconds = network.GetTimeSeconds();
+    result.m_link             = network.GetStats();
+
+    for (std::unique_ptr<NetworkDispatcher>& dispatcher : dispatchers)
+    {
+        const NetworkMetrics& metrics = dispatcher->GetMetrics();
+        for (const ConnectionMetrics& connection : metrics.GetConnections())
+        {
+            result.m_moveDelivery.Merge(connection.m_moveDeliveryLatency);
+            result.m_rtt.Merge(connection.m_rtt);
+            result.m_compressedMessages += connection.m_compressedMessagesOut;
+            result.m_decodeErrors += connection.m_decodeErrors;
+        }
+        result.m_dispatcherExecute.Merge(metrics.GetFrameMetrics().m_executeHistogram);
+    }
+    return result;
+}
@@ -0,0 +1,51 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Game/Core/Network/LoopbackTransport.hpp"
+#include "Game/Core/Network/NetworkMetrics.hpp"
+
+struct NetworkSimulationConfig
+{
+    LoopbackLinkConfig m_link;
+    int                m_clientCount      = 1;
+    int                m_repeat           = 1; // Times the script is replayed
+    int                m_messagesPerFrame = 1; // Script lines a sender pushes per simulated frame
+    double             m_frameSeconds     = 1.0 / 60.0;
+    double             m_drainSeconds     = 10.0; // Simulated time allowed after the last send for the links to empty
+    bool               m_compress         = false; // Every line opts in to compression, regardless of its size
+};
+
+struct NetworkSimulationResult
+{
+    uint64_t m_messagesSent       = 0; // Script messages handed to a dispatcher
+    uint64_t m_expectedDeliveries = 0; // A server message counts once per client
+    uint64_t m_delivered          = 0;
+    uint64_t m_corrupted          = 0; // Payload differs from what was sent
+    uint64_t m_outOfOrder         = 0;
+    uint64_t m_duplicated         = 0;
+    uint64_t m_commandBytes       = 0;
+    uint64_t m_compressedMessages = 0;
+    uint64_t m_decodeErrors       = 0;
+
+    LoopbackStats    m_link;
+    bool             m_reorderEnabled   = false;
+    double           m_wallSeconds      = 0.0;
+    double           m_simulatedSeconds = 0.0;
+    LatencyHistogram m_moveDelivery;
+    LatencyHistogram m_rtt;
+    LatencyHistogram m_dispatcherExecute;
+
+    bool        IsFramingIntact() const;
+    std::string ToText() const;
+};
+
+/// NetworkSimulation ― Drives one server and several client NetworkDispatchers over a LoopbackNetwork with a scripted
+/// match, every script line is tagged with its index so the receivers can verify the framing and the order.
+class NetworkSimulation
+{
+public:
+    /// scriptLines as loaded by LoadScriptLines
+    static NetworkSimulationResult Run(const NetworkSimulationConfig& config, const std::vector<std::string>& scriptLines);
+};
@@ -0,0 +1,68 @@
+﻿#include "NetworkTransport.hpp"
+
+#include "Game/Core/Network/NetworkMetrics.hpp"
+
+double INetworkTransport::GetTimeSeconds() const
+{
+    return NetworkMetrics::GetTimeSeconds();
+}
+
+NetworkSubsystemTransport::NetworkSubsystemTransport(NetworkSubsystem* networkSubsystem)
+    : m_networkSubsystem(networkSubsystem)
+{
+}
+
+bool NetworkSubsystemTransport::HasDataFromServer()
+{
+    return m_networkSubsystem->HasDataFromServer();
+}
+
+std::vector<uint8_t> NetworkSubsystemTransport::ReceiveFromServer()
+{
+    return m_networkSubsystem->ReceiveFromServer();
+}
+
+bool NetworkSubsystemTransport::HasDataFromClient(size_t clientIndex)
+{
+    return m_networkSubsystem->HasDataFromClient(clientIndex);
+}
+
+std::vector<uint8_t> NetworkSubsystemTransport::ReceiveFromClient(size_t clientIndex)
+{
+    return m_networkSubsystem->ReceiveFromClient(clientIndex);
+}
+
+void NetworkSubsystemTransport::SendStringToServer(const std::string& message)
+{
+    m_networkSubsystem->SendStringToServer(message);
+}
+
+void NetworkSubsystemTransport::BroadcastStringToClients(const std::string& message)
+{
+    m_networkSubsystem->BroadcastStringToClients(message);
+}
+
+bool NetworkSubsystemTransport::IsConnectedAsClient() const
+{
+    return m_networkSubsystem->GetClientState() == ClientState::CONNECTED;
+}
+
+bool NetworkSubsystemTransport::IsRunningAsServer() const
+{
+    return m_networkSubsystem->GetServerState() == ServerState::LISTENING;
+}
+
+size_t NetworkSubsystemTransport::GetConnectedClientCount() const
+{
+    return m_networkSubsystem->GetConnectedClientCount();
+}
+
+MessageBoundaryMode NetworkSubsystemTransport::GetMessageBoundaryMode() const
+{
+    return m_networkSubsystem->GetMessageBoundaryMode();
+}
+
+char NetworkSubsystemTransport::GetMessageDelimiter() const
+{
+    return m_networkSubsystem->GetConfig().messageDelimiter;
+}
@@ -0,0 +1,57 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Engine/Network/NetworkSubsystem.hpp"
+
+/// INetworkTransport ― The socket facing part of the NetworkSubsystem the NetworkDispatcher relies on. The game uses
+/// NetworkSubsystemTransport, the simulation harness swaps in a LoopbackTransport to run without real sockets.
+class INetworkTransport
+{
+public:
+    virtual ~INetworkTransport() = default;
+
+    virtual bool                 HasDataFromServer() = 0;
+    virtual std::vector<uint8_t> ReceiveFromServer() = 0;
+    virtual bool                 HasDataFromClient(size_t clientIndex) = 0;
+    virtual std::vector<uint8_t> ReceiveFromClient(size_t clientIndex) = 0;
+
+    virtual void SendStringToServer(const std::string& message) = 0;
+    virtual void BroadcastStringToClients(const std::string& message) = 0;
+
+    virtual bool   IsConnectedAsClient() const = 0;
+    virtual bool   IsRunningAsServer() const = 0;
+    virtual size_t GetConnectedClientCount() const = 0;
+
+    virtual MessageBoundaryMode GetMessageBoundaryMode() const = 0;
+    virtual char                GetMessageDelimiter() const = 0;
+
+    /// Time used for RTT and move delivery measurements, a simulated transport returns its virtual clock
+    virtual double GetTimeSeconds() const;
+};
+
+/// Forwards to the engine NetworkSubsystem.
+class NetworkSubsystemTransport : public INetworkTransport
+{
+public:
+    explicit NetworkSubsystemTransport(NetworkSubsystem* networkSubsystem);
+
+    bool                 HasDataFromServer() override;
+    std::vector<uint8_t> ReceiveFromServer() override;
+    bool                 HasDataFromClient(size_t clientIndex) override;
+    std::vector<uint8_t> ReceiveFromClient(size_t clientIndex) override;
+
+    void SendStringToServer(const std::string& message) override;
+    void BroadcastStringToClients(const std::string& message) override;
+
+    bool   IsConnectedAsClient() const override;
+    bool   IsRunningAsServer() const override;
+    size_t GetConnectedClientCount() const override;
+
+    MessageBoundaryMode GetMessageBoundaryMode() const override;
+    char                GetMessageDelimiter() const override;
+
+private:
+    NetworkSubsystem* m_networkSubsystem = nullptr;
+};
@@ -0,0 +1,103 @@
+﻿#include "ObjectArena.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Core/LoggerSubsystem.hpp"
+
+namespace
+{
+    /// In front of every object allocation, ALIGNMENT wide so the object behind it stays aligned
+    struct alignas(ObjectArena::ALIGNMENT) ObjectHeader
+    {
+        ObjectArena* m_arena = nullptr; // Null for heap memory
+    };
+
+    thread_local ObjectArena* t_currentArena = nullptr;
+
+    size_t AlignUp(size_t size)
+    {
+        return (size + ObjectArena::ALIGNMENT - 1) & ~(ObjectArena::ALIGNMENT - 1);
+    }
+}
+
+ObjectArena::ObjectArena(size_t blockSize) : m_blockSize(blockSize)
+{
+}
+
+ObjectArena::~ObjectArena()
+{
+    if (m_liveObjects != 0 && g_theLoggerSubsystem)
+    {
+        LOG(LogSystem, Warning, "Object arena destroyed with %d live objects", m_liveObjects);
+    }
+}
+
+void* ObjectArena::Allocate(size_t size)
+{
+    size = AlignUp(size);
+    while (m_blockIndex < m_blocks.size() && m_blockOffset + size > m_blocks[m_blockIndex].m_size)
+    {
+        m_blockIndex++; // Rewound blocks are reused in order before a new one is allocated
+        m_blockOffset = 0;
+    }
+    if (m_blockIndex == m_blocks.size())
+    {
+        Block block;
+        block.m_size   = size > m_blockSize ? size : m_blockSize;
+        block.m_memory = std::make_unique<std::byte[]>(block.m_size);
+        m_blocks.push_back(std::move(block));
+        m_blockOffset = 0;
+    }
+
+    void* memory = m_blocks[m_blockIndex].m_memory.get() + m_blockOffset;
+    m_blockOffset += size;
+    m_usedBytes += size;
+    return memory;
+}
+
+void ObjectArena::Reset()
+{
+    GUARANTEE_OR_DIE(m_liveObjects == 0, "ObjectArena::Reset, objects are still alive");
+    m_blockIndex  = 0;
+    m_blockOffset = 0;
+    m_usedBytes   = 0;
+}
+
+ObjectArena::Scope::Scope(ObjectArena& arena) : m_previous(t_currentArena)
+{
+    t_currentArena = &arena;
+}
+
+ObjectArena::Scope::~Scope()
+{
+    t_currentArena = m_previous;
+}
+
+void* ObjectArena::AllocateObject(size_t size)
+{
+    ObjectArena*  arena  = t_currentArena;
+    ObjectHeader* header = nullptr;
+    if (arena)
+    {
+        header = static_cast<ObjectHeader*>(arena->Allocate(sizeof(ObjectHeader) + size));
+        arena->m_liveObjects++;
+    }
+    else
+    {
+        header = static_cast<ObjectHeader*>(::operator new(sizeof(ObjectHeader) + size));
+    }
+    header->m_arena = arena;
+    return header + 1;
+}
+
+void ObjectArena::FreeObject(void* memory)
+{
+    if (!memory) return;
+    ObjectHeader* header = static_cast<ObjectHeader*>(memory) - 1;
+    if (header->m_arena)
+    {
+        header->m_arena->m_liveObjects--; // The bytes come back with the arena
+        return;
+    }
+    ::operator delete(header);
+}
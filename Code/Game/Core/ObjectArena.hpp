@@ -0,0 +1,74 @@
+﻿#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/// ObjectArena ― Bump allocator for the objects of one owner, e.g. every Actor and Component of a ChessMatch.
+/// Memory comes from a few large blocks and is only returned when the arena dies, destructors still run one by one.
+/// Actor and IComponent route their operator new through the innermost live Scope of the calling thread, every
+/// allocation carries a header naming its arena so the matching delete works whether it came from one or the heap.
+class ObjectArena
+{
+public:
+    static constexpr size_t ALIGNMENT          = alignof(std::max_align_t);
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit ObjectArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ObjectArena(const ObjectArena&) = delete;
+    ~ObjectArena(); // Objects still alive are leaked into freed memory, destroy them first
+
+    void* Allocate(size_t size); // ALIGNMENT aligned
+    void  Reset(); // Rewinds into the first block, every object must be gone
+
+    size_t GetBlockCount() const { return m_blocks.size(); }
+    size_t GetUsedBytes() const { return m_usedBytes; }
+    int    GetLiveObjectCount() const { return m_liveObjects; }
+
+    /// Makes arena the target of AllocateObject on this thread while alive, scopes nest
+    class Scope
+    {
+    public:
+        explicit Scope(ObjectArena& arena);
+        Scope(const Scope&) = delete;
+        ~Scope();
+
+    private:
+        ObjectArena* m_previous = nullptr;
+    };
+
+    /// Backing of the class operator new / delete, the current Scope arena or the heap
+    static void* AllocateObject(size_t size);
+    static void  FreeObject(void* memory);
+
+    /// For types whose operator new cannot be overridden, e.g. Engine classes owned by an Actor
+    template <typename T, typename... Args>
+    static T* New(Args&&... args)
+    {
+        static_assert(alignof(T) <= ALIGNMENT, "ObjectArena::New, over aligned types are not supported");
+        return new(AllocateObject(sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    static void Delete(T* object)
+    {
+        if (!object) return;
+        object->~T();
+        FreeObject(object);
+    }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> m_memory;
+        size_t                       m_size = 0;
+    };
+
+    size_t             m_blockSize   = DEFAULT_BLOCK_SIZE;
+    std::vector<Block> m_blocks;
+    size_t             m_blockIndex  = 0; // Bumping into this block
+    size_t             m_blockOffset = 0;
+    size_t             m_usedBytes   = 0;
+    int                m_liveObjects = 0; // AllocateObject minus FreeObject
+};
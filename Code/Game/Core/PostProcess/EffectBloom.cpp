@@ -7,6 +7,7 @@
 #include "Engine/Renderer/VertexBuffer.hpp"
 #include "Engine/Window/Window.hpp"
 #include "Game/App.hpp"
+#include "Game/Core/ProfilerSubsystem.hpp"
 
 EffectBloom::EffectBloom(const std::string& name, int priority) : PostProcessEffect("Bloom", 0)
 {
@@ -45,6 +46,7 @@ void EffectBloom::Shutdown()
 
 void EffectBloom::Process(RenderTarget* input, RenderTarget* output)
 {
+    PROFILE_SCOPE("EffectBloom::Process");
     ExtractBrightness(*m_renderer, input, m_brightnessRT);
 
     // Downsampling and blurring
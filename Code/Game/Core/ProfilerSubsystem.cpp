@@ -0,0 +1,297 @@
+﻿#include "ProfilerSubsystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Core/LoggerSubsystem.hpp"
+
+std::atomic<bool>  ProfilerSubsystem::s_recording{false};
+ProfilerSubsystem* ProfilerSubsystem::s_instance = nullptr;
+
+namespace
+{
+    thread_local ProfileZoneBuffer*       t_buffer = nullptr;
+    thread_local const ProfilerSubsystem* t_owner  = nullptr;
+
+    void AppendJsonEscaped(std::string& out, const std::string& text)
+    {
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+    }
+}
+
+uint64_t ProfileFrameStats::GetZoneNs(const char* name) const
+{
+    for (const ZoneTotal& zone : m_zones)
+    {
+        if (zone.m_name == name || strcmp(zone.m_name, name) == 0)
+        {
+            return zone.m_ns;
+        }
+    }
+    return 0;
+}
+
+ProfileZoneBuffer::ProfileZoneBuffer(size_t capacity, uint32_t threadId, std::string threadName)
+    : m_chunks((capacity + CHUNK_SIZE - 1) / CHUNK_SIZE), m_capacity(capacity), m_threadId(threadId), m_threadName(std::move(threadName))
+{
+}
+
+void ProfileZoneBuffer::Push(const char* name, uint64_t beginNs, uint64_t endNs)
+{
+    size_t index = m_count.load(std::memory_order_relaxed);
+    if (index >= m_capacity)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::unique_ptr<ProfileZone[]>& chunk = m_chunks[index / CHUNK_SIZE];
+    if (!chunk)
+    {
+        chunk = std::make_unique<ProfileZone[]>(CHUNK_SIZE); // Published to readers by the count store below
+    }
+    chunk[index % CHUNK_SIZE] = {name, beginNs, endNs};
+    m_count.store(index + 1, std::memory_order_release);
+}
+
+ProfilerSubsystem::ProfilerSubsystem(const ProfilerConfig& config) : m_config(config)
+{
+    s_instance = this;
+}
+
+ProfilerSubsystem::~ProfilerSubsystem()
+{
+    Shutdown();
+    s_instance = nullptr;
+}
+
+void ProfilerSubsystem::Startup()
+{
+    SetThreadName("Main");
+    m_mainBuffer   = GetThreadBuffer();
+    m_frameStartNs = GetTimeNs();
+    LOG(LogSystem, Info, "Start up Profiler subsystem...");
+}
+
+void ProfilerSubsystem::Shutdown()
+{
+    m_capturing.store(false); // An unfinished capture is discarded
+    m_liveStats       = false;
+    m_requestedFrames = 0;
+    UpdateRecording();
+}
+
+void ProfilerSubsystem::BeginFrame()
+{
+    uint64_t nowNs = GetTimeNs();
+    if (m_liveStats)
+    {
+        CollectFrameStats(nowNs);
+    }
+    m_frameStartNs = nowNs;
+
+    if (IsCapturing() && ++m_capturedFrames >= m_captureFrames)
+    {
+        FinishCapture();
+    }
+    if (!IsCapturing() && m_requestedFrames > 0)
+    {
+        StartCapture();
+    }
+}
+
+bool ProfilerSubsystem::RequestCapture(int frameCount, const std::string& path)
+{
+    if (frameCount <= 0 || path.empty() || IsCaptureRequested())
+    {
+        return false;
+    }
+    m_requestedFrames = frameCount;
+    m_requestedPath   = path;
+    return true;
+}
+
+void ProfilerSubsystem::SetThreadName(const std::string& name)
+{
+    std::lock_guard<std::mutex> guard(m_buffersMutex);
+    if (t_owner == this)
+    {
+        t_buffer->m_threadName = name;
+        return;
+    }
+    m_threadNames[std::this_thread::get_id()] = name; // Picked up by GetThreadBuffer, most workers never record a zone
+}
+
+void ProfilerSubsystem::SetLiveStatsEnabled(bool enabled)
+{
+    m_liveStats = enabled;
+    if (m_mainBuffer && !IsCapturing())
+    {
+        m_mainBuffer->m_count.store(0);
+        m_mainConsumed = 0;
+    }
+    m_lastFrameStats = ProfileFrameStats();
+    UpdateRecording();
+}
+
+uint64_t ProfilerSubsystem::GetTimeNs()
+{
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+void ProfilerSubsystem::RecordZone(const char* name, uint64_t beginNs, uint64_t endNs)
+{
+    ProfilerSubsystem* profiler = s_instance;
+    if (!profiler || beginNs < profiler->m_captureStartNs.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    if (!profiler->IsCapturing() && (t_owner != profiler || t_buffer != profiler->m_mainBuffer))
+    {
+        return; // Live stats only total the main thread, other threads get no buffer for them
+    }
+    profiler->GetThreadBuffer()->Push(name, beginNs, endNs);
+}
+
+ProfileZoneBuffer* ProfilerSubsystem::GetThreadBuffer()
+{
+    if (t_owner == this)
+    {
+        return t_buffer;
+    }
+    std::lock_guard<std::mutex> guard(m_buffersMutex);
+    uint32_t                    threadId = static_cast<uint32_t>(m_buffers.size());
+    auto                        named    = m_threadNames.find(std::this_thread::get_id());
+    std::string                 name     = named != m_threadNames.end() ? named->second : "Thread " + std::to_string(threadId);
+    m_buffers.push_back(std::make_unique<ProfileZoneBuffer>(m_config.m_zonesPerThread, threadId, std::move(name)));
+    t_buffer = m_buffers.back().get();
+    t_owner  = this;
+    return t_buffer;
+}
+
+void ProfilerSubsystem::StartCapture()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_buffersMutex);
+        for (const std::unique_ptr<ProfileZoneBuffer>& buffer : m_buffers)
+        {
+            buffer->m_count.store(0);
+            buffer->m_dropped.store(0);
+        }
+    }
+    m_captureFrames   = m_requestedFrames;
+    m_capturePath     = m_requestedPath;
+    m_capturedFrames  = 0;
+    m_requestedFrames = 0;
+    m_mainConsumed    = 0;
+    m_captureStartNs.store(GetTimeNs());
+    m_capturing.store(true);
+    UpdateRecording();
+}
+
+void ProfilerSubsystem::FinishCapture()
+{
+    m_capturing.store(false);
+    UpdateRecording();
+
+    size_t   zoneCount = 0;
+    uint64_t dropped   = 0;
+    if (!WriteChromeTrace(m_capturePath, zoneCount, dropped))
+    {
+        LOG(LogSystem, Error, "Fail to write profile capture to %s", m_capturePath);
+        return;
+    }
+    LOG(LogSystem, Info, "Profile capture of %d frames written to %s, %zu zones, %llu dropped", m_captureFrames, m_capturePath, zoneCount, dropped);
+}
+
+void ProfilerSubsystem::CollectFrameStats(uint64_t nowNs)
+{
+    m_lastFrameStats.m_frameNs = nowNs - m_frameStartNs;
+    m_lastFrameStats.m_zones.clear();
+    if (!m_mainBuffer)
+    {
+        return;
+    }
+
+    // Only the main thread writes this buffer and this runs on the main thread, no zone can be in flight
+    size_t count = m_mainBuffer->m_count.load(std::memory_order_relaxed);
+    for (size_t i = m_mainConsumed; i < count; ++i)
+    {
+        const ProfileZone& zone  = m_mainBuffer->GetZone(i);
+        auto               found = std::find_if(m_lastFrameStats.m_zones.begin(), m_lastFrameStats.m_zones.end(),
+                                                [&zone](const ProfileFrameStats::ZoneTotal& total) { return total.m_name == zone.m_name; });
+        if (found == m_lastFrameStats.m_zones.end())
+        {
+            m_lastFrameStats.m_zones.push_back({zone.m_name, 0, 0});
+            found = m_lastFrameStats.m_zones.end() - 1;
+        }
+        found->m_ns += zone.m_endNs - zone.m_beginNs;
+        found->m_calls++;
+    }
+
+    if (IsCapturing())
+    {
+        m_mainConsumed = count; // The capture still needs them
+    }
+    else
+    {
+        m_mainBuffer->m_count.store(0, std::memory_order_relaxed);
+        m_mainConsumed = 0;
+    }
+}
+
+void ProfilerSubsystem::UpdateRecording()
+{
+    s_recording.store(IsCapturing() || m_liveStats);
+}
+
+bool ProfilerSubsystem::WriteChromeTrace(const std::string& path, size_t& outZoneCount, uint64_t& outDropped)
+{
+    uint64_t    startNs = m_captureStartNs.load();
+    std::string json    = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool        first   = true;
+    char        buffer[128];
+
+    std::lock_guard<std::mutex> guard(m_buffersMutex);
+    for (const std::unique_ptr<ProfileZoneBuffer>& zoneBuffer : m_buffers)
+    {
+        size_t count = zoneBuffer->m_count.load(std::memory_order_acquire);
+        outDropped += zoneBuffer->m_dropped.load();
+        if (count == 0) continue;
+
+        json += first ? "" : ",";
+        json += Stringf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", zoneBuffer->m_threadId);
+        AppendJsonEscaped(json, zoneBuffer->m_threadName);
+        json += "\"}}";
+        first = false;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const ProfileZone& zone = zoneBuffer->GetZone(i);
+            json += ",{\"name\":\"";
+            AppendJsonEscaped(json, zone.m_name);
+            snprintf(buffer, sizeof(buffer), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", zoneBuffer->m_threadId,
+                     static_cast<double>(zone.m_beginNs - startNs) * 1e-3, static_cast<double>(zone.m_endNs - zone.m_beginNs) * 1e-3);
+            json += buffer;
+        }
+        outZoneCount += count;
+    }
+    json += "]}\n";
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    file << json;
+    return true;
+}
@@ -0,0 +1,162 @@
+﻿#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#define INTERNAL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define INTERNAL_PROFILE_CONCAT(a, b)      INTERNAL_PROFILE_CONCAT_IMPL(a, b)
+
+/// Times the enclosing scope while a capture runs, Name must be a string literal.
+/// Define PROFILER_DISABLED to compile every zone out.
+#ifndef PROFILER_DISABLED
+#define PROFILE_SCOPE(Name) ProfileScope INTERNAL_PROFILE_CONCAT(profileScope, __LINE__)("" Name)
+#else
+#define PROFILE_SCOPE(Name)
+#endif
+
+struct ProfilerConfig
+{
+    size_t m_zonesPerThread = 256 * 1024; // Zones past this during one capture are dropped and counted
+};
+
+/// One closed zone, Chrome trace "complete" event
+struct ProfileZone
+{
+    const char* m_name    = nullptr;
+    uint64_t    m_beginNs = 0;
+    uint64_t    m_endNs   = 0;
+};
+
+/// Inclusive time of every zone name on the main thread during one frame
+struct ProfileFrameStats
+{
+    struct ZoneTotal
+    {
+        const char* m_name  = nullptr;
+        uint64_t    m_ns    = 0;
+        int         m_calls = 0;
+    };
+
+    uint64_t               m_frameNs = 0; // BeginFrame to BeginFrame
+    std::vector<ZoneTotal> m_zones;
+
+    uint64_t GetZoneNs(const char* name) const;
+};
+
+/// ProfileZoneBuffer ― Zones of one thread, only the owning thread appends, the exporter reads up to the published count.
+/// Storage grows one chunk at a time up to the capacity, chunks are never moved so readers stay valid while it grows.
+class ProfileZoneBuffer
+{
+public:
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    ProfileZoneBuffer(size_t capacity, uint32_t threadId, std::string threadName);
+
+    void               Push(const char* name, uint64_t beginNs, uint64_t endNs);
+    const ProfileZone& GetZone(size_t index) const { return m_chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+
+    std::vector<std::unique_ptr<ProfileZone[]>> m_chunks; // Sized once for the capacity, filled as zones arrive
+    size_t                                      m_capacity = 0;
+    std::atomic<size_t>                         m_count{0};
+    std::atomic<uint64_t>                       m_dropped{0};
+    uint32_t                                    m_threadId = 0;
+    std::string                                 m_threadName;
+};
+
+/// ProfilerSubsystem ― Scoped zone instrumentation, captures a number of frames into a Chrome trace_event JSON file
+/// that opens in chrome://tracing or https://ui.perfetto.dev.
+class ProfilerSubsystem
+{
+public:
+    ProfilerSubsystem()                         = delete;
+    ProfilerSubsystem(const ProfilerSubsystem&) = delete;
+    explicit ProfilerSubsystem(const ProfilerConfig& config);
+    ~ProfilerSubsystem();
+
+    void Startup();
+    void Shutdown();
+
+    /// Called first thing every frame, starts a requested capture and finishes it once enough frames were recorded
+    void BeginFrame();
+
+    /// The capture starts on the next frame, false if one is already pending or running
+    bool RequestCapture(int frameCount, const std::string& path);
+    bool IsCaptureRequested() const { return m_requestedFrames > 0 || IsCapturing(); }
+    bool IsCapturing() const { return m_capturing.load(std::memory_order_relaxed); }
+
+    /// Main thread zones are totalled every frame into GetLastFrameStats, used by WidgetPerformanceHUD
+    void                     SetLiveStatsEnabled(bool enabled);
+    const ProfileFrameStats& GetLastFrameStats() const { return m_lastFrameStats; }
+
+    /// Names the calling thread in the trace, its zone buffer is only allocated once it records a zone
+    void SetThreadName(const std::string& name);
+
+    /// True while a capture runs or live stats are enabled
+    static bool     IsRecording() { return s_recording.load(std::memory_order_relaxed); }
+    static uint64_t GetTimeNs();
+    static void     RecordZone(const char* name, uint64_t beginNs, uint64_t endNs);
+
+private:
+    static std::atomic<bool>  s_recording;
+    static ProfilerSubsystem* s_instance;
+
+    ProfilerConfig m_config;
+
+    std::vector<std::unique_ptr<ProfileZoneBuffer>>  m_buffers;
+    std::unordered_map<std::thread::id, std::string> m_threadNames;  // Threads named before their first zone
+    std::mutex                                       m_buffersMutex; // Only taken when a thread is named or records its first zone
+
+    int                   m_requestedFrames = 0; // Pending request, picked up by the next BeginFrame
+    int                   m_captureFrames   = 0;
+    int                   m_capturedFrames  = 0;
+    std::string           m_requestedPath;
+    std::string           m_capturePath;
+    std::atomic<uint64_t> m_captureStartNs{0}; // Zones that began earlier belong to an older capture
+    std::atomic<bool>     m_capturing{false};
+
+    bool               m_liveStats    = false;
+    ProfileZoneBuffer* m_mainBuffer   = nullptr;
+    size_t             m_mainConsumed = 0; // Main thread zones already totalled
+    uint64_t           m_frameStartNs = 0;
+    ProfileFrameStats  m_lastFrameStats;
+
+    ProfileZoneBuffer* GetThreadBuffer();
+    void               StartCapture();
+    void               FinishCapture();
+    void               CollectFrameStats(uint64_t nowNs);
+    void               UpdateRecording();
+    bool               WriteChromeTrace(const std::string& path, size_t& outZoneCount, uint64_t& outDropped);
+};
+
+/// ProfileScope ― RAII zone behind PROFILE_SCOPE, while nothing records it costs one relaxed load and a branch.
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name) : m_name(name)
+    {
+        if (ProfilerSubsystem::IsRecording())
+        {
+            m_beginNs = ProfilerSubsystem::GetTimeNs();
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (m_beginNs != 0)
+        {
+            ProfilerSubsystem::RecordZone(m_name, m_beginNs, ProfilerSubsystem::GetTimeNs());
+        }
+    }
+
+    ProfileScope(const ProfileScope&)            = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t    m_beginNs = 0;
+};
@@ -47,7 +47,7 @@ void BakedModel::RegisterModels()
 
 BakedModel* BakedModel::RegisterModel(BakedModel* model)
 {
-    LOG(LogResource, Info, ((Stringf("Register baked model with name: %s",model->name.c_str())).c_str()));
+    LOG(LogResource, Info, "Register baked model with name: %s", model->name.c_str());
     s_models.push_back(model);
     model->Build();
     return model;
@@ -10,6 +10,7 @@
 #include "Game/App.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Core/LoggerSubsystem.hpp"
+#include "Game/Core/ProfilerSubsystem.hpp"
 #include "Game/Core/Component/Component.hpp"
 #include "Game/Core/PostProcess/PostProcessEffect.hpp"
 
@@ -20,6 +21,7 @@ RenderSubsystem::RenderSubsystem(IRenderer& renderer) : m_renderer(renderer)
 void RenderSubsystem::Register(IRenderable* r)
 {
     m_renderables.push_back(r);
+    LOG_RATE_LIMITED(LogRender, Info, 10, "Register renderable %p, %zu registered", r, m_renderables.size());
 }
 
 void RenderSubsystem::Unregister(IRenderable* r)
@@ -29,13 +31,28 @@ void RenderSubsystem::Unregister(IRenderable* r)
         if (m_renderables[i] == r)
         {
             m_renderables[i] = nullptr;
+            m_emptySlots++;
         }
     }
-    //m_renderables.erase(std::find(m_renderables.begin(), m_renderables.end(), r));
+}
+
+void RenderSubsystem::EndFrame()
+{
+    if (m_emptySlots == 0) return;
+    for (size_t i = m_renderables.size(); i-- > 0;)
+    {
+        if (!m_renderables[i])
+        {
+            m_renderables[i] = m_renderables.back(); // Already visited, never empty
+            m_renderables.pop_back();
+        }
+    }
+    m_emptySlots = 0;
 }
 
 void RenderSubsystem::RenderWorld(const Camera& camera, LightingConstants& lightConstants, FrameConstants& frameConstants)
 {
+    PROFILE_SCOPE("RenderSubsystem::RenderWorld");
     // If post-processing is enabled, render to Scene RT first
     if (m_postProcessEnabled && !m_postProcessEffects.empty())
     {
@@ -138,17 +155,10 @@ void RenderSubsystem::RenderSceneToTarget(const Camera& camera, LightingConstant
     {
         if (!r) continue;
 
-        // Check if it's a component
-        auto comp = dynamic_cast<IComponent*>(r);
-        if (comp)
-        {
-            if (comp->GetEnable())
-                r->Render(ctx);
-        }
-        else
-        {
-            r->Render(ctx);
-        }
+        // Components only draw while enabled
+        const IComponent* comp = r->GetOwningComponent();
+        if (comp && !comp->GetEnable()) continue;
+        r->Render(ctx);
     }
 
     ctx.renderer.SetLightConstants(lightConstants);
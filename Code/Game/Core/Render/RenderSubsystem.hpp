@@ -18,7 +18,8 @@ public:
     RenderSubsystem(IRenderer& renderer);
 
     void Register(IRenderable* r); // Called when the component OnAttach
-    void Unregister(IRenderable* r); // Called when the component OnDetach
+    void Unregister(IRenderable* r); // Called when the component OnDetach, leaves an empty slot until EndFrame
+    void EndFrame(); // Compacts the empty slots, registration order is not kept
 
     void RenderWorld(const Camera& camera, LightingConstants& lightConstants, FrameConstants& frameConstants);
 
@@ -46,6 +47,7 @@ private:
 private:
     IRenderer&                m_renderer;
     std::vector<IRenderable*> m_renderables;
+    int                       m_emptySlots = 0;
 
     /// Render targets
     RenderTarget* m_sceneRenderTarget = nullptr;
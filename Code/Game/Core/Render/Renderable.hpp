@@ -1,10 +1,17 @@
 ﻿#pragma once
 
 struct RenderContext;
+class IComponent;
 
 class IRenderable
 {
 public:
     virtual      ~IRenderable() = default;
     virtual void Render(const RenderContext& ctx) = 0;
+
+    /// The component this renderable is a part of, null for standalone ones. Submission reads it instead of cross casting.
+    const IComponent* GetOwningComponent() const { return m_owningComponent; }
+
+protected:
+    const IComponent* m_owningComponent = nullptr; // Set by the constructor of components that render
 };
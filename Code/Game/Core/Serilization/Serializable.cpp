@@ -5,7 +5,7 @@
 
 XmlElement* ISerializable::Create(const char* path)
 {
-    LOG(LogResource, Warning, Stringf("Loading XML File From: %s\n", path).c_str());
+    LOG(LogResource, Warning, "Loading XML File From: %s\n", path);
     XmlDocument doc;
     XmlResult   result = doc.LoadFile(path);
     if (result == XmlResult::XML_SUCCESS)
@@ -15,26 +15,26 @@ XmlElement* ISerializable::Create(const char* path)
         {
             return rootElement;
         }
-        LOG(LogResource, Error, Stringf("File from \"%s\"was invalid (missing root element)\n", path).c_str());
+        LOG(LogResource, Error, "File from \"%s\"was invalid (missing root element)\n", path);
         return rootElement;
     }
-    LOG(LogResource, Error, Stringf("Fail Load Loading XML File From: \n", path).c_str());
+    LOG(LogResource, Error, "Fail Load Loading XML File From: %s\n", path);
     return nullptr;
 }
 
 bool ISerializable::Create(XmlDocument& outDoc, const char* path)
 {
-    LOG(LogResource, Warning, Stringf("Loading XML File From: %s\n", path).c_str());
+    LOG(LogResource, Warning, "Loading XML File From: %s\n", path);
     XmlResult result = outDoc.LoadFile(path);
     if (result != XmlResult::XML_SUCCESS)
     {
-        LOG(LogResource, Error, Stringf("Failed to load XML File From: %s\n", path).c_str());
+        LOG(LogResource, Error, "Failed to load XML File From: %s\n", path);
         return false;
     }
 
     if (!outDoc.RootElement())
     {
-        LOG(LogResource, Error, Stringf("File \"%s\" was invalid (missing root element)\n", path).c_str());
+        LOG(LogResource, Error, "File \"%s\" was invalid (missing root element)\n", path);
         return false;
     }
     return true;
@@ -1,6 +1,7 @@
 ﻿#include "WidgetSubsystem.hpp"
 
 #include "LoggerSubsystem.hpp"
+#include "ProfilerSubsystem.hpp"
 #include "Widget.hpp"
 #include "Game/GameCommon.hpp"
 
@@ -79,6 +80,7 @@ void WidgetSubsystem::Shutdown()
 
 void WidgetSubsystem::Update()
 {
+    PROFILE_SCOPE("WidgetSubsystem::Update");
     for (int i = 0; i < static_cast<int>(m_widgets.size()); ++i)
     {
         if (m_widgets[i] && !m_widgets[i]->m_bIsGarbage)
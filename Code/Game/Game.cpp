@@ -14,8 +14,10 @@
 #include "Engine/Renderer/Renderer.hpp"
 
 #include "Core/LoggerSubsystem.hpp"
+#include "Core/ProfilerSubsystem.hpp"
 #include "Core/Render/BakedModel.hpp"
 #include "Module/Definition/ChessPieceDefinition.hpp"
+#include "Module/Gameplay/CameraPresetRegistry.hpp"
 #include "Module/Gameplay/ChessMatch.hpp"
 #include "Module/Gameplay/ChessPlayer.hpp"
 
@@ -27,6 +29,7 @@
 #include "Core/Render/RenderSubsystem.hpp"
 #include "Engine/Network/NetworkSubsystem.hpp"
 #include "Module/Debug/WidgetDebugPanel.hpp"
+#include "Module/Lib/BenchmarkCommon.hpp"
 #include "Module/Lib/DebugCommon.hpp"
 
 
@@ -50,6 +53,8 @@ Game::Game()
 
     /// Config
     ISerializable::Create(m_chessMatchConfig, "Data/ChessMatchConfig.xml");
+    if (m_chessMatchConfig.RootElement())
+        CameraPresetRegistry::LoadFromMatchConfig(*m_chessMatchConfig.RootElement());
 
     /// Command Registration
     g_theDevConsole->RegisterCommand("ChessMove", "None", ChessMatchCommon::Command_ChessMove);
@@ -60,7 +65,15 @@ Game::Game()
     g_theDevConsole->RegisterCommand("ChessDisconnect", "Disconnect from current chess session", ChessMatchCommon::Command_ChessDisconnect);
     g_theDevConsole->RegisterCommand("ChessBegin", "Start a new chess game", ChessMatchCommon::Command_ChessBegin);
     g_theDevConsole->RegisterCommand("ChessPlayerInfo", "Set player name for chess match", ChessMatchCommon::Command_ChessPlayerInfo);
+    g_theDevConsole->RegisterCommand("ChessNetStats", "Print network metrics, format=json for a dump, file=<path> to save it, reset=true to clear", ChessMatchCommon::Command_ChessNetStats);
+    g_theDevConsole->RegisterCommand("ChessNetSim", "Run a scripted match over a simulated network, latency= jitter= loss= reorder= chunk= clients= repeat= compress=", ChessMatchCommon::Command_ChessNetSim);
+    g_theDevConsole->RegisterCommand("ChessScript", "Run chess move scripts, script=<a.js,b.js> mode=headless|live threads= repeat= board=true", ChessMatchCommon::Command_ChessScript);
     g_theDevConsole->RegisterCommand("Debug", "None", DebugCommon::Command_Debug);
+    g_theDevConsole->RegisterCommand("ProfileCapture", "Capture frames to a Chrome trace, frames=<count> file=<path.json>", DebugCommon::Command_ProfileCapture);
+    g_theDevConsole->RegisterCommand("PerfHUD", "Toggle the performance HUD (F3), visible=true|false", DebugCommon::Command_PerfHUD);
+    g_theDevConsole->RegisterCommand("AllocStats", "Per frame allocations, track=off|count|sites top=<count>", DebugCommon::Command_AllocStats);
+    g_theDevConsole->RegisterCommand("LogDecode", "Decode a binary log, file=<path> format=text|json out=<path> limit=<lines>", DebugCommon::Command_LogDecode);
+    g_theDevConsole->RegisterCommand("Benchmark", "Run micro benchmarks, name=<benchmark> or name=all, out=<json> baseline=<json> tolerance=<percent>", BenchmarkCommon::Command_Benchmark);
     g_theDevConsole->RegisterCommand("RemoteCmd", "None", ChessMatchCommon::Command_RemoteCmd);
 
     /// Rasterize
@@ -132,8 +145,10 @@ Game::~Game()
     POINTER_SAFE_DELETE(m_screenCamera)
     POINTER_SAFE_DELETE(m_spectatorCamera)
     POINTER_SAFE_DELETE(m_spectatorCamera)
+    POINTER_SAFE_DELETE(m_dispatcher)
     BakedModel::ReleaseResources();
     ChessPieceDefinition::ReleaseResources();
+    CameraPresetRegistry::Clear();
     g_theRenderSubsystem->Shutdown();
 }
 
@@ -183,6 +198,16 @@ void Game::UpdateCameras(float deltaTime)
 void Game::EnterCameraState(ECameraState state)
 {
     cameraState = state;
+    m_cameraBlend.Stop();
+}
+
+bool Game::BlendCameraToPreset(const std::string& presetName, float durationSeconds)
+{
+    const CameraPreset* preset = CameraPresetRegistry::GetByName(presetName);
+    if (!preset || cameraMode == ECameraMode::FREE)
+        return false;
+    m_cameraBlend.Start(m_player->m_position, m_player->m_orientation, *preset, durationSeconds);
+    return true;
 }
 
 void Game::InitializeNetworking()
@@ -235,6 +260,7 @@ void Game::InitializeNetworking()
 
 void Game::Update()
 {
+    PROFILE_SCOPE("Game::Update");
     m_dispatcher->ExecuteRemoteCmd();
 
     if (gameState == EGameState::ATTRACT)
@@ -244,6 +270,8 @@ void Game::Update()
     UpdateMatch();
 
     /// Player
+    if (m_cameraBlend.IsActive() && cameraMode != ECameraMode::FREE)
+        m_cameraBlend.Update(Clock::GetSystemClock().GetDeltaSeconds(), m_player->m_position, m_player->m_orientation);
     m_player->Update(Clock::GetSystemClock().GetDeltaSeconds());
     ///
 
@@ -278,6 +306,12 @@ void Game::UpdateMatch()
         match->Update();
 }
 
+void Game::EndFrame()
+{
+    if (match)
+        match->CollectGarbage();
+}
+
 bool Game::Event_DebugCharInput(EventArgs& args)
 {
     if (g_theDevConsole && g_theDevConsole->IsOpen())
@@ -398,7 +432,7 @@ void Game::HandleMouseEvent(float deltaTime)
 
 void Game::EnterState(EGameState state)
 {
-    LOG(LogGame, Info, Stringf("Entering State %s",to_string(state)).c_str());
+    LOG(LogGame, Info, "Entering State %s", to_string(state));
     switch (state)
     {
     case EGameState::NONE:
@@ -439,7 +473,7 @@ void Game::EnterSettlementState()
 {
     gameState = EGameState::SETTLEMENT;
     EnterCameraState(ECameraState::CONFIGURED);
-    ChessMatchCommon::GetCameraTransform(g_theGame->cameraState, g_theGame->m_player->m_position, g_theGame->m_player->m_orientation, match, "above");
+    BlendCameraToPreset("above", 1.0f);
     g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, Stringf("[ %s ] win the game", match->GetCurrentTurnPlayer()->m_faction.m_displayName.c_str()));
     g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, Stringf("Enter ChessMatch reset to reset the match", match->GetCurrentTurnPlayer()->m_faction.m_displayName.c_str()));
 }
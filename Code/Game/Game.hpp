@@ -4,6 +4,7 @@
 #include "Core/Render/RenderContext.hpp"
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Math/AABB2.hpp"
+#include "Module/Gameplay/CameraPresetRegistry.hpp"
 #include "Module/Gameplay/CameraState.h"
 #include "Module/Gameplay/GameState.hpp"
 #include "Module/Lib/ChessMatchCommon.hpp"
@@ -21,6 +22,7 @@ public:
     ~Game();
     void Render() const;
     void Update();
+    void EndFrame();
 
     void UpdateMatch();
 
@@ -40,6 +42,7 @@ public:
     // Camera
     void UpdateCameras(float deltaTime);
     void EnterCameraState(ECameraState state);
+    bool BlendCameraToPreset(const std::string& presetName, float durationSeconds); // False when the preset is unknown or the camera is free
 
     // Networking
     void                        InitializeNetworking();
@@ -74,6 +77,8 @@ public:
     Camera* m_spectatorCamera = nullptr; // Default World Camera
     Camera* m_playerCamera    = nullptr; // Player Camera
     Camera* m_screenCamera    = nullptr;
+    // Eases the player camera into a configured preset, stopped by any camera state change
+    CameraBlend m_cameraBlend;
     // Space for both world and screen, camera needs them
     AABB2 m_screenSpace;
     AABB2 m_worldSpace;
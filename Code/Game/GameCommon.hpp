@@ -20,6 +20,8 @@ class AudioSystem;
 class Game;
 class RenderSubsystem;
 class LoggerSubsystem;
+class ProfilerSubsystem;
+class JobSystem;
 class WidgetSubsystem;
 class NetworkSubsystem;
 
@@ -31,6 +33,8 @@ extern AudioSystem*           g_theAudio;
 extern Game*                  g_theGame;
 extern RenderSubsystem*       g_theRenderSubsystem;
 extern LoggerSubsystem*       g_theLoggerSubsystem;
+extern ProfilerSubsystem*     g_theProfilerSubsystem;
+extern JobSystem*             g_theJobSystem;
 extern WidgetSubsystem*       g_theWidgetSubsystem;
 extern NetworkSubsystem*      g_theNetworkSubsystem;
 
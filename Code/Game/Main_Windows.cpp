@@ -102,8 +102,9 @@ int WINAPI WinMain(HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR command
     }
 
     g_theApp->Shutdown();
+    int exitCode = g_theApp->m_exitCode;
     delete g_theApp;
     g_theApp = nullptr;
 
-    return 0;
+    return exitCode;
 }
@@ -0,0 +1,248 @@
+﻿#include "WidgetPerformanceHUD.hpp"
+
+#include <algorithm>
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Renderer/IRenderer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Core/AllocationTracker.hpp"
+#include "Game/Core/ProfilerSubsystem.hpp"
+#include "Game/Core/Network/NetworkDispatcher.hpp"
+
+namespace
+{
+    /// Zone totals shown per line, the names must match the PROFILE_SCOPE literals
+    const char* SECTION_ZONES[]  = {"Game::Update", "RenderSubsystem::RenderWorld", "EffectBloom::Process", "NetworkDispatcher::ExecuteRemoteCmd", "WidgetSubsystem::Update"};
+    const char* SECTION_LABELS[] = {"update", "render", "post", "network", "widgets"};
+
+    constexpr float PANEL_WIDTH  = 360.f;
+    constexpr float PANEL_MARGIN = 10.f;
+    constexpr float GRAPH_HEIGHT = 80.f;
+    constexpr float LINE_HEIGHT  = 16.f;
+    constexpr float CELL_HEIGHT  = 12.f;
+    constexpr float CELL_ASPECT  = 0.6f;
+
+    const Rgba8 BACKGROUND_COLOR(0, 0, 0, 160);
+    const Rgba8 GUIDE_COLOR(255, 255, 255, 60);
+    const Rgba8 FAST_COLOR(0, 200, 0, 220);
+    const Rgba8 SLOW_COLOR(230, 200, 0, 220);
+    const Rgba8 HITCH_COLOR(230, 40, 40, 220);
+
+    const Rgba8& GetFrameColor(float frameMs)
+    {
+        if (frameMs > 33.4f) return HITCH_COLOR;
+        if (frameMs > 16.7f) return SLOW_COLOR;
+        return FAST_COLOR;
+    }
+}
+
+WidgetPerformanceHUD::WidgetPerformanceHUD()
+{
+    m_name = "WidgetPerformanceHUD";
+
+    m_graphVerts.resize(GRAPH_VERTS);
+    m_textVerts.resize(TEXT_VERTS);
+    m_scratchVerts.reserve(LINE_CHARS * VERTS_PER_QUAD);
+}
+
+WidgetPerformanceHUD::~WidgetPerformanceHUD()
+{
+    if (m_bIsVisible && g_theProfilerSubsystem)
+    {
+        g_theProfilerSubsystem->SetLiveStatsEnabled(false);
+    }
+    if (m_bOwnsAllocationTracking)
+    {
+        AllocationTracker::SetMode(EAllocationTrackMode::OFF);
+    }
+    POINTER_SAFE_DELETE(m_graphBuffer)
+    POINTER_SAFE_DELETE(m_textBuffer)
+}
+
+void WidgetPerformanceHUD::OnInit()
+{
+    Widget::OnInit();
+    m_font        = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
+    m_graphBuffer = g_theRenderer->CreateVertexBuffer(GRAPH_VERTS * sizeof(Vertex_PCU), sizeof(Vertex_PCU));
+    m_textBuffer  = g_theRenderer->CreateVertexBuffer(TEXT_VERTS * sizeof(Vertex_PCU), sizeof(Vertex_PCU));
+
+    // The background and the 30 / 60 FPS guides never move
+    AABB2 graphBox;
+    graphBox.m_maxs = g_theGame->m_screenSpace.GetDimensions() - Vec2(PANEL_MARGIN, PANEL_MARGIN);
+    graphBox.m_mins = graphBox.m_maxs - Vec2(PANEL_WIDTH, GRAPH_HEIGHT);
+    AABB2 background(graphBox.m_mins - Vec2(4.f, LINE_COUNT * LINE_HEIGHT + 8.f), graphBox.m_maxs + Vec2(4.f, 4.f));
+    SetQuad(&m_graphVerts[0], background, BACKGROUND_COLOR);
+    for (int guide = 0; guide < 2; ++guide)
+    {
+        float y = graphBox.m_mins.y + GRAPH_HEIGHT * (guide == 0 ? 16.7f : 33.3f) / GRAPH_MAX_MS;
+        SetQuad(&m_graphVerts[(1 + guide) * VERTS_PER_QUAD], AABB2(Vec2(graphBox.m_mins.x, y), Vec2(graphBox.m_maxs.x, y + 1.f)), GUIDE_COLOR);
+    }
+
+    for (int line = 0; line < LINE_COUNT; ++line)
+    {
+        SetLine(line, "", Rgba8::WHITE);
+    }
+    SetVisibility(m_bIsVisible);
+    UpdateGraph();
+    g_theRenderer->CopyCPUToGPU(m_textVerts.data(), TEXT_VERTS * sizeof(Vertex_PCU), m_textBuffer);
+    m_bTextDirty = false;
+}
+
+void WidgetPerformanceHUD::Draw() const
+{
+    Widget::Draw();
+    g_theRenderer->BindShader(nullptr);
+    g_theRenderer->BindTexture(nullptr);
+    g_theRenderer->DrawVertexBuffer(m_graphBuffer, GRAPH_VERTS);
+    g_theRenderer->BindTexture(&m_font->GetTexture());
+    g_theRenderer->DrawVertexBuffer(m_textBuffer, TEXT_VERTS);
+}
+
+void WidgetPerformanceHUD::Update()
+{
+    Widget::Update();
+    if (!m_bIsVisible)
+    {
+        return;
+    }
+
+    const ProfileFrameStats& stats = g_theProfilerSubsystem->GetLastFrameStats();
+    if (stats.m_frameNs == 0)
+    {
+        return; // Live stats were just enabled
+    }
+    m_frameMs[m_historyHead] = static_cast<float>(static_cast<double>(stats.m_frameNs) * 1e-6);
+    m_historyHead            = (m_historyHead + 1) % HISTORY_FRAMES;
+
+    m_accumFrames++;
+    m_accumFrameNs += stats.m_frameNs;
+    m_accumMaxFrameNs = std::max(m_accumMaxFrameNs, stats.m_frameNs);
+    for (int section = 0; section < SECTION_COUNT; ++section)
+    {
+        m_accumSectionNs[section] += stats.GetZoneNs(SECTION_ZONES[section]);
+    }
+    m_accumAllocs     += AllocationTracker::GetLastFrameStats().m_allocs;
+    m_accumAllocBytes += AllocationTracker::GetLastFrameStats().m_bytes;
+
+    UpdateGraph();
+    if (static_cast<double>(m_accumFrameNs) * 1e-9 >= TEXT_REFRESH_SECS)
+    {
+        RefreshText();
+    }
+}
+
+bool WidgetPerformanceHUD::SetVisibility(bool bIsVisible)
+{
+    // Zones and allocations are only totalled per frame while someone looks at them
+    g_theProfilerSubsystem->SetLiveStatsEnabled(bIsVisible);
+    if (bIsVisible && AllocationTracker::GetMode() == EAllocationTrackMode::OFF)
+    {
+        AllocationTracker::SetMode(EAllocationTrackMode::COUNT);
+        m_bOwnsAllocationTracking = true;
+    }
+    else if (!bIsVisible && m_bOwnsAllocationTracking)
+    {
+        AllocationTracker::SetMode(EAllocationTrackMode::OFF);
+        m_bOwnsAllocationTracking = false;
+    }
+    return Widget::SetVisibility(bIsVisible);
+}
+
+void WidgetPerformanceHUD::UpdateGraph()
+{
+    AABB2 graphBox;
+    graphBox.m_maxs = g_theGame->m_screenSpace.GetDimensions() - Vec2(PANEL_MARGIN, PANEL_MARGIN);
+    graphBox.m_mins = graphBox.m_maxs - Vec2(PANEL_WIDTH, GRAPH_HEIGHT);
+    float barWidth  = PANEL_WIDTH / static_cast<float>(HISTORY_FRAMES);
+
+    // Oldest frame on the left
+    for (int bar = 0; bar < HISTORY_FRAMES; ++bar)
+    {
+        float frameMs = m_frameMs[(m_historyHead + bar) % HISTORY_FRAMES];
+        float height  = GRAPH_HEIGHT * std::min(frameMs / GRAPH_MAX_MS, 1.f);
+        Vec2  mins(graphBox.m_mins.x + barWidth * static_cast<float>(bar), graphBox.m_mins.y);
+        SetQuad(&m_graphVerts[(3 + bar) * VERTS_PER_QUAD], AABB2(mins, mins + Vec2(barWidth - 1.f, height)), GetFrameColor(frameMs));
+    }
+    g_theRenderer->CopyCPUToGPU(m_graphVerts.data(), GRAPH_VERTS * sizeof(Vertex_PCU), m_graphBuffer);
+}
+
+void WidgetPerformanceHUD::RefreshText()
+{
+    double frames  = static_cast<double>(m_accumFrames);
+    double frameMs = static_cast<double>(m_accumFrameNs) * 1e-6 / frames;
+    double maxMs   = static_cast<double>(m_accumMaxFrameNs) * 1e-6;
+    SetLine(0, Stringf("%5.1f FPS %6.2f ms  max %6.2f ms", 1000.0 / frameMs, frameMs, maxMs), GetFrameColor(static_cast<float>(frameMs)));
+
+    for (int section = 0; section < SECTION_COUNT; ++section)
+    {
+        double sectionMs = static_cast<double>(m_accumSectionNs[section]) * 1e-6 / frames;
+        SetLine(1 + section, Stringf("%-8s %6.2f ms", SECTION_LABELS[section], sectionMs), Rgba8::WHITE);
+        m_accumSectionNs[section] = 0;
+    }
+
+    SetLine(1 + SECTION_COUNT, Stringf("allocs   %6.1f /frame %8.1f KB", static_cast<double>(m_accumAllocs) / frames,
+                                       static_cast<double>(m_accumAllocBytes) / frames / 1024.0), m_accumAllocs > 0 ? SLOW_COLOR : Rgba8::WHITE);
+
+    std::string rttText = "rtt      offline";
+    if (g_theGame->m_dispatcher && !g_theGame->m_dispatcher->GetMetrics().GetConnections().empty())
+    {
+        const ConnectionMetrics& connection = g_theGame->m_dispatcher->GetMetrics().GetConnections().front();
+        rttText                             = Stringf("rtt      %6.2f ms", connection.m_smoothedRttSeconds * 1000.0);
+    }
+    SetLine(2 + SECTION_COUNT, rttText, Rgba8::WHITE);
+
+    m_accumFrames     = 0;
+    m_accumFrameNs    = 0;
+    m_accumMaxFrameNs = 0;
+    m_accumAllocs     = 0;
+    m_accumAllocBytes = 0;
+    if (m_bTextDirty)
+    {
+        g_theRenderer->CopyCPUToGPU(m_textVerts.data(), TEXT_VERTS * sizeof(Vertex_PCU), m_textBuffer);
+        m_bTextDirty = false;
+    }
+}
+
+void WidgetPerformanceHUD::SetLine(int lineIndex, const std::string& text, const Rgba8& color)
+{
+    // Padded so every line owns the same LINE_CHARS quads of m_textVerts
+    std::string padded = text.substr(0, LINE_CHARS);
+    padded.resize(LINE_CHARS, ' ');
+    if (padded == m_lines[lineIndex])
+    {
+        return;
+    }
+    m_lines[lineIndex] = padded;
+
+    AABB2 graphBox;
+    graphBox.m_maxs = g_theGame->m_screenSpace.GetDimensions() - Vec2(PANEL_MARGIN, PANEL_MARGIN);
+    Vec2 textMins(graphBox.m_maxs.x - PANEL_WIDTH, graphBox.m_maxs.y - GRAPH_HEIGHT - LINE_HEIGHT * static_cast<float>(lineIndex + 1) - 4.f);
+
+    m_scratchVerts.clear();
+    m_font->AddVertsForText2D(m_scratchVerts, textMins, CELL_HEIGHT, padded, color, CELL_ASPECT);
+    size_t      slotSize = static_cast<size_t>(LINE_CHARS * VERTS_PER_QUAD);
+    Vertex_PCU* slot     = &m_textVerts[lineIndex * slotSize];
+    std::copy_n(m_scratchVerts.begin(), std::min(slotSize, m_scratchVerts.size()), slot);
+    std::fill(slot + std::min(slotSize, m_scratchVerts.size()), slot + slotSize, Vertex_PCU()); // Degenerate, nothing drawn
+    m_bTextDirty = true;
+}
+
+void WidgetPerformanceHUD::SetQuad(Vertex_PCU* verts, const AABB2& box, const Rgba8& color)
+{
+    Vec3 bottomLeft(box.m_mins.x, box.m_mins.y, 0.f);
+    Vec3 bottomRight(box.m_maxs.x, box.m_mins.y, 0.f);
+    Vec3 topRight(box.m_maxs.x, box.m_maxs.y, 0.f);
+    Vec3 topLeft(box.m_mins.x, box.m_maxs.y, 0.f);
+    verts[0] = Vertex_PCU(bottomLeft, color, Vec2(0.f, 0.f));
+    verts[1] = Vertex_PCU(bottomRight, color, Vec2(1.f, 0.f));
+    verts[2] = Vertex_PCU(topRight, color, Vec2(1.f, 1.f));
+    verts[3] = Vertex_PCU(bottomLeft, color, Vec2(0.f, 0.f));
+    verts[4] = Vertex_PCU(topRight, color, Vec2(1.f, 1.f));
+    verts[5] = Vertex_PCU(topLeft, color, Vec2(0.f, 1.f));
+}
@@ -0,0 +1,65 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Game/Core/Widget.hpp"
+
+class BitmapFont;
+class VertexBuffer;
+struct AABB2;
+struct Rgba8;
+
+/// WidgetPerformanceHUD ― Frame time graph, per subsystem timings from the profiler live stats and allocations per frame.
+/// Every vertex lives in a buffer sized once in OnInit, the graph and the changed text lines are rewritten in place.
+class WidgetPerformanceHUD : public Widget
+{
+public:
+    WidgetPerformanceHUD();
+    ~WidgetPerformanceHUD() override;
+
+    void OnInit() override;
+    void Draw() const override;
+    void Update() override;
+    bool SetVisibility(bool bIsVisible) override;
+
+private:
+    static constexpr int   HISTORY_FRAMES    = 120;
+    static constexpr int   SECTION_COUNT     = 5;
+    static constexpr int   LINE_COUNT        = SECTION_COUNT + 3; // Frame, sections, allocations, network RTT
+    static constexpr int   LINE_CHARS        = 40;
+    static constexpr int   VERTS_PER_QUAD    = 6;
+    static constexpr int   GRAPH_VERTS       = (3 + HISTORY_FRAMES) * VERTS_PER_QUAD; // Background, two guides, bars
+    static constexpr int   TEXT_VERTS        = LINE_COUNT * LINE_CHARS * VERTS_PER_QUAD;
+    static constexpr float GRAPH_MAX_MS      = 50.f;
+    static constexpr float TEXT_REFRESH_SECS = 0.25f;
+
+    BitmapFont*   m_font                    = nullptr;
+    VertexBuffer* m_graphBuffer             = nullptr;
+    VertexBuffer* m_textBuffer              = nullptr;
+    bool          m_bTextDirty              = false;
+    bool          m_bOwnsAllocationTracking = false; // Switched the tracker on, switches it off again when hidden
+
+    float m_frameMs[HISTORY_FRAMES] = {};
+    int   m_historyHead             = 0; // Oldest frame in m_frameMs
+
+    /// Summed since the last text refresh
+    int      m_accumFrames                   = 0;
+    uint64_t m_accumFrameNs                  = 0;
+    uint64_t m_accumMaxFrameNs               = 0;
+    uint64_t m_accumSectionNs[SECTION_COUNT] = {};
+    uint64_t m_accumAllocs                   = 0;
+    uint64_t m_accumAllocBytes               = 0;
+
+    std::vector<Vertex_PCU> m_graphVerts;
+    std::vector<Vertex_PCU> m_textVerts;
+    std::vector<Vertex_PCU> m_scratchVerts;
+    std::string             m_lines[LINE_COUNT];
+
+    void UpdateGraph();
+    void RefreshText();
+    void SetLine(int lineIndex, const std::string& text, const Rgba8& color);
+
+    static void SetQuad(Vertex_PCU* verts, const AABB2& box, const Rgba8& color);
+};
@@ -5,7 +5,8 @@
 #include "Game/GameCommon.hpp"
 #include "Game/Core/LoggerSubsystem.hpp"
 #include "Game/Core/Render/BakedModel.hpp"
-std::vector<ChessPieceDefinition> ChessPieceDefinition::s_definitions = {};
+std::vector<ChessPieceDefinition>    ChessPieceDefinition::s_definitions = {};
+std::unordered_map<std::string, int> ChessPieceDefinition::s_nameIndex   = {};
 
 void ChessPieceDefinition::LoadDefinitions(const char* path)
 {
@@ -29,27 +30,32 @@ void ChessPieceDefinition::LoadDefinitions(const char* path)
         }
         else
         {
-            LOG(LogResource, Info, Stringf("ChessPieceDefinition from \"%s\"was invalid (missing root element)\n", path).c_str());
+            LOG(LogResource, Info, "ChessPieceDefinition from \"%s\"was invalid (missing root element)\n", path);
         }
     }
     else
     {
         printf("Failed to load ChessPieceDefinition from \"%s\"\n", path);
     }
+
+    s_nameIndex.clear();
+    for (int i = 0; i < static_cast<int>(s_definitions.size()); ++i)
+    {
+        s_nameIndex.emplace(Common::ToLower(s_definitions[i].m_name), i);
+    }
 }
 
 void ChessPieceDefinition::ClearDefinitions()
 {
+    s_nameIndex.clear();
+    s_definitions.clear();
 }
 
 ChessPieceDefinition* ChessPieceDefinition::GetByName(const std::string& name)
 {
-    for (auto& definition : s_definitions)
-    {
-        if (Common::ToLower(definition.m_name) == Common::ToLower(name))
-            return &definition;
-    }
-    return nullptr;
+    // Piece names fit the small string buffer, folding the query once does not touch the heap
+    auto found = s_nameIndex.find(Common::ToLower(name));
+    return found == s_nameIndex.end() ? nullptr : &s_definitions[found->second];
 }
 
 void ChessPieceDefinition::ReleaseResources()
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Engine/Core/XmlUtils.hpp"
@@ -17,6 +18,9 @@ public:
     static ChessPieceDefinition*             GetByName(const std::string& name);
     static void                              ReleaseResources();
 
+    /// Lower case name -> index into s_definitions, rebuilt after every load since push_back may reallocate
+    static std::unordered_map<std::string, int> s_nameIndex;
+
     ChessPieceDefinition(const XmlElement& element);
     std::string m_name  = "Unknown";
     std::string m_glyph = "?";
@@ -0,0 +1,92 @@
+﻿#include "CameraPresetRegistry.hpp"
+
+#include <cmath>
+
+#include "Engine/Math/MathUtils.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Core/LoggerSubsystem.hpp"
+
+std::vector<CameraPreset>            CameraPresetRegistry::s_presets   = {};
+std::unordered_map<std::string, int> CameraPresetRegistry::s_nameIndex = {};
+
+namespace
+{
+    float GetShortestDeltaDegrees(float fromDegrees, float toDegrees)
+    {
+        float delta = fmodf(toDegrees - fromDegrees, 360.f);
+        if (delta > 180.f) delta -= 360.f;
+        if (delta < -180.f) delta += 360.f;
+        return delta;
+    }
+}
+
+void CameraBlend::Start(const Vec3& fromPosition, const EulerAngles& fromOrientation, const CameraPreset& to, float durationSeconds)
+{
+    m_fromPosition    = fromPosition;
+    m_fromOrientation = fromOrientation;
+    m_toPosition      = to.m_position;
+    m_toOrientation   = to.m_orientation;
+    m_durationSeconds = durationSeconds;
+    m_elapsedSeconds  = 0.f;
+}
+
+void CameraBlend::Update(float deltaSeconds, Vec3& outPosition, EulerAngles& outOrientation)
+{
+    m_elapsedSeconds += deltaSeconds;
+    if (m_elapsedSeconds >= m_durationSeconds)
+    {
+        outPosition    = m_toPosition;
+        outOrientation = m_toOrientation;
+        return;
+    }
+    CameraPresetRegistry::Interpolate(m_fromPosition, m_fromOrientation, m_toPosition, m_toOrientation, SmoothStep3(m_elapsedSeconds / m_durationSeconds),
+                                      outPosition, outOrientation);
+}
+
+void CameraPresetRegistry::LoadFromMatchConfig(const XmlElement& rootElement)
+{
+    Clear();
+    const XmlElement* cameraPositionsElement = FindChildElementByName(rootElement, "CameraPositions");
+    if (!cameraPositionsElement)
+    {
+        LOG(LogResource, Warning, "Match config has no CameraPositions, configured cameras stay where they are");
+        return;
+    }
+    for (const XmlElement* element = cameraPositionsElement->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+    {
+        CameraPreset preset;
+        preset.m_name        = ParseXmlAttribute(*element, "name", std::string("INVALID"));
+        preset.m_position    = ParseXmlAttribute(*element, "position", Vec3(0, 0, 0));
+        preset.m_orientation = EulerAngles(ParseXmlAttribute(*element, "orientation", Vec3(0, 0, 0)));
+        preset.m_transform.AppendTranslation3D(preset.m_position);
+        preset.m_transform.Append(preset.m_orientation.GetAsMatrix_IFwd_JLeft_KUp());
+        if (!s_nameIndex.emplace(preset.m_name, static_cast<int>(s_presets.size())).second)
+        {
+            LOG(LogResource, Warning, "Camera preset \"%s\" is defined twice, the first one is kept", preset.m_name.c_str());
+            continue;
+        }
+        s_presets.push_back(preset);
+    }
+    LOG(LogResource, Info, "%d camera presets were loaded", static_cast<int>(s_presets.size()));
+}
+
+void CameraPresetRegistry::Clear()
+{
+    s_nameIndex.clear();
+    s_presets.clear();
+}
+
+const CameraPreset* CameraPresetRegistry::GetByName(const std::string& name)
+{
+    auto found = s_nameIndex.find(name);
+    return found == s_nameIndex.end() ? nullptr : &s_presets[found->second];
+}
+
+void CameraPresetRegistry::Interpolate(const Vec3& fromPosition, const EulerAngles& fromOrientation, const Vec3& toPosition, const EulerAngles& toOrientation,
+                                       float fraction, Vec3& outPosition, EulerAngles& outOrientation)
+{
+    outPosition                   = ::Interpolate(fromPosition, toPosition, fraction);
+    outOrientation.m_yawDegrees   = fromOrientation.m_yawDegrees + GetShortestDeltaDegrees(fromOrientation.m_yawDegrees, toOrientation.m_yawDegrees) * fraction;
+    outOrientation.m_pitchDegrees = fromOrientation.m_pitchDegrees + GetShortestDeltaDegrees(fromOrientation.m_pitchDegrees, toOrientation.m_pitchDegrees) * fraction;
+    outOrientation.m_rollDegrees  = fromOrientation.m_rollDegrees + GetShortestDeltaDegrees(fromOrientation.m_rollDegrees, toOrientation.m_rollDegrees) * fraction;
+}
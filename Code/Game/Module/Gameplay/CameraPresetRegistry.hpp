@@ -0,0 +1,53 @@
+﻿#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+/// One CameraPosition of the match config, the transform is built once at load
+struct CameraPreset
+{
+    std::string m_name;
+    Vec3        m_position;
+    EulerAngles m_orientation;
+    Mat44       m_transform;
+};
+
+/// CameraBlend ― Eases a camera pose toward a target over a fixed duration. Plain values only, starting, updating
+/// and restarting a blend never touch the heap.
+struct CameraBlend
+{
+    Vec3        m_fromPosition;
+    EulerAngles m_fromOrientation;
+    Vec3        m_toPosition;
+    EulerAngles m_toOrientation;
+    float       m_durationSeconds = 0.f;
+    float       m_elapsedSeconds  = 0.f;
+
+    void Start(const Vec3& fromPosition, const EulerAngles& fromOrientation, const CameraPreset& to, float durationSeconds);
+    void Stop() { m_elapsedSeconds = m_durationSeconds; }
+    bool IsActive() const { return m_elapsedSeconds < m_durationSeconds; }
+
+    /// Advances the blend and writes the eased pose, the last call lands exactly on the target
+    void Update(float deltaSeconds, Vec3& outPosition, EulerAngles& outOrientation);
+};
+
+/// CameraPresetRegistry ― The CameraPositions of the match config parsed once, looked up by name instead of walking the XML.
+class CameraPresetRegistry
+{
+public:
+    static void                LoadFromMatchConfig(const XmlElement& rootElement);
+    static void                Clear();
+    static const CameraPreset* GetByName(const std::string& name);
+
+    /// Pose between two presets, yaw, pitch and roll take the shorter way around
+    static void Interpolate(const Vec3& fromPosition, const EulerAngles& fromOrientation, const Vec3& toPosition, const EulerAngles& toOrientation,
+                            float fraction, Vec3& outPosition, EulerAngles& outOrientation);
+
+    static std::vector<CameraPreset>            s_presets;
+    static std::unordered_map<std::string, int> s_nameIndex; // Name -> index into s_presets
+};
@@ -12,6 +12,7 @@
 
 ChessBoard::ChessBoard()
 {
+    AddKind(KIND);
     AABB3 box;
     box.SetDimensions(Vec3(8.0f, 8.0f, 0.5f));
     m_collisionComponent->SetCollisionBox(box);
@@ -26,12 +27,13 @@ ChessBoard::ChessBoard()
     AddVertsForCube3DWireFrame(vertices, highLightBox, Rgba8::ORANGE);
     m_squareHighlight = AddComponent<MeshComponent>();
     m_squareHighlight->AppendVertices(vertices);
-    g_theEventSystem->SubscribeEventCallbackFunction("event.highlight.enable", Event_Highlight_Enable);
-    g_theEventSystem->SubscribeEventCallbackFunction("event.highlight.disable", Event_Highlight_Disable);
+    m_squareHighlight->SetEnable(false);
 }
 
 ChessBoard::~ChessBoard()
 {
+    if (_outer)
+        _outer->m_highlightChanged.Unsubscribe(this);
     // Like CreateOrShader()
     // POINTER_SAFE_DELETE(m_meshComponent->m_shader)
 }
@@ -55,23 +57,14 @@ Actor* ChessBoard::FromXML(const XmlElement& element)
     return this;
 }
 
-bool ChessBoard::Event_Highlight_Enable(EventArgs& args)
+void ChessBoard::OnHighlightChanged(const ChessMatchCommon::HighlightChangedEvent& event, void* listener)
 {
-    IntVec2     gridPos    = args.GetValue("position", IntVec2::ZERO);
-    ChessBoard* chessBoard = g_theGame->match->m_chessBoard;
-    if (!chessBoard)
-        return false;
+    ChessBoard* chessBoard = static_cast<ChessBoard*>(listener);
+    if (event.m_square == IntVec2::INVALID)
+    {
+        chessBoard->m_squareHighlight->SetEnable(false);
+        return;
+    }
     chessBoard->m_squareHighlight->SetEnable(true);
-    chessBoard->m_squareHighlight->SetPosition(Vec3(static_cast<float>(gridPos.x) + 0.5f, static_cast<float>(gridPos.y) + 0.5f, -0.25f));
-    return true;
-}
-
-bool ChessBoard::Event_Highlight_Disable(EventArgs& args)
-{
-    UNUSED(args)
-    ChessBoard* chessBoard = g_theGame->match->m_chessBoard;
-    if (!chessBoard)
-        return false;
-    chessBoard->m_squareHighlight->SetEnable(false);
-    return true;
+    chessBoard->m_squareHighlight->SetPosition(Vec3(static_cast<float>(event.m_square.x) + 0.5f, static_cast<float>(event.m_square.y) + 0.5f, -0.25f));
 }
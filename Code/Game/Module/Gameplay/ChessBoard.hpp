@@ -1,20 +1,22 @@
 ﻿#pragma once
 #include "ChessObject.hpp"
-#include "Engine/Core/EventSystem.hpp"
+#include "Game/Module/Lib/ChessMatchCommon.hpp"
 
 class CollisionComponent;
 
 class ChessBoard final : public ChessObject
 {
 public:
+    static constexpr EActorKind KIND = EActorKind::CHESS_BOARD;
+
     ChessBoard();
     ~ChessBoard() override;
     void OnTick(float deltaTime) override;
 
     Actor* FromXML(const XmlElement& element) override;
 
-    static bool Event_Highlight_Enable(EventArgs& args);
-    static bool Event_Highlight_Disable(EventArgs& args);
+    /// Subscribed to ChessMatch::m_highlightChanged with the board as listener
+    static void OnHighlightChanged(const ChessMatchCommon::HighlightChangedEvent& event, void* listener);
 
 private:
     MeshComponent* m_squareHighlight = nullptr;
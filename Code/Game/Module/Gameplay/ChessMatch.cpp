@@ -1,5 +1,7 @@
 ﻿#include "ChessMatch.hpp"
 
+#include <algorithm>
+
 #include "ChessBoard.hpp"
 #include "ChessPiece.hpp"
 #include "ChessPlayer.hpp"
@@ -12,7 +14,10 @@
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Player.hpp"
+#include "Game/Core/AllocationTracker.hpp"
+#include "Game/Core/JobSystem.hpp"
 #include "Game/Core/LoggerSubsystem.hpp"
+#include "Game/Core/ProfilerSubsystem.hpp"
 #include "Game/Core/Actor/Actor.hpp"
 #include "Game/Core/Component/CollisionComponent.hpp"
 #include "Game/Core/Component/MeshComponent.hpp"
@@ -21,12 +26,19 @@
 #include "Game/Module/Definition/ChessPieceDefinition.hpp"
 #include "Game/Module/Test/TestModelActor.hpp"
 
+namespace
+{
+    constexpr int COLLISION_REFRESH_BATCH = 256; // Boxes per job, a plain match refreshes its few dozen inline
+}
+
 ChessMatch::ChessMatch(Game* game) : m_game(game)
 {
+    ObjectArena::Scope arenaScope(m_arena); // The setup allocates into a few blocks instead of once per object
     m_chessBoard = new ChessBoard();
     m_chessBoard->FromXML(*g_theGame->m_chessMatchConfig.RootElement());
     m_chessBoard->SetOuter(this);
     SpawnActor(Vec3(0.f, 0.f, 0.f), EulerAngles(0, 0, 0), m_chessBoard);
+    m_highlightChanged.Subscribe(&ChessBoard::OnHighlightChanged, m_chessBoard);
 
     /// Populate Chess board data layout
     for (auto& m_chess_grid : m_chessGrid)
@@ -88,6 +100,10 @@ ChessMatch::~ChessMatch()
         m_actors[i]->Destroy();
         POINTER_SAFE_DELETE(m_actors[i])
     }
+    if (m_bloomEffect)
+    {
+        g_theRenderSubsystem->RemovePostProcessEffect(m_bloomEffect->GetName()); // Every match adds its own
+    }
 }
 
 void ChessMatch::FromXML(const XmlElement& xmlElement)
@@ -132,13 +148,23 @@ XmlElement* ChessMatch::ToXML() const
 
 void ChessMatch::Update()
 {
+    PROFILE_SCOPE("ChessMatch::Update");
+    AllocationScope allocations;
+    float           deltaSeconds = g_theGame->m_clock->GetDeltaSeconds();
+    {
+        PROFILE_SCOPE("ChessMatch::Update::Animations");
+        m_animations.Update(deltaSeconds);
+    }
+    UpdateCollisionBoxes(); // After the tweens moved the pieces, the player raycasts this frame's positions
+
     for (int i = 0; i < static_cast<int>(m_actors.size()); i++)
     {
         if (m_actors[i])
         {
-            m_actors[i]->Tick(g_theGame->m_clock->GetDeltaSeconds());
+            m_actors[i]->Tick(deltaSeconds);
         }
     }
+    m_transforms.Update(); // Only the actors that moved rebuild their matrices, rendering reads the cache
     if (g_theInput->WasKeyJustPressed(115))
     {
         if (g_theGame->cameraMode == ECameraMode::FREE)
@@ -156,6 +182,8 @@ void ChessMatch::Update()
     g_theGame->m_lightingConstants.NumLights = 2;
     g_theGame->m_lightingConstants.lights[0] = m_spotLight;
     g_theGame->m_lightingConstants.lights[1] = m_pointLight;
+
+    m_updateAllocations = allocations.GetAllocationCount();
 }
 
 Actor* ChessMatch::SpawnActor(Vec3 position, EulerAngles orientation, Actor* actor)
@@ -164,6 +192,14 @@ Actor* ChessMatch::SpawnActor(Vec3 position, EulerAngles orientation, Actor* act
     actor->m_orientation = orientation;
     m_actors.emplace_back(actor);
     actor->Initialize();
+    m_transforms.Add(actor);
+
+    // Only ChessObjects are raycast targets, the hit reports one
+    auto chessObject = ActorCast<ChessObject>(actor);
+    if (chessObject && chessObject->GetComponent<CollisionComponent>())
+    {
+        m_entities.Emplace<CollisionBoxData>(actor->GetID(), chessObject->GetComponent<CollisionComponent>()->GetCollisionBoxData());
+    }
     return actor;
 }
 
@@ -177,15 +213,15 @@ ChessPiece* ChessMatch::AddChessPieceToMatch(ChessPiece* chessPiece, std::string
     m_chessGrid[girdPos.x][girdPos.y] = chessPiece;
     chessPiece->m_gridCurrentPosition = girdPos;
     chessPiece->_match                = this;
-    LOG(LogGame, Info, Stringf("Add Chess piece [ %s ]      to [ %s ] / grid = [ %d, %d ] world = [ %.2f, %.2f ]", chessPiece->m_definition->m_name.c_str(), gridPosition.c_str(), girdPos.x, girdPos.y,
-            chessPiece->m_position.x, chessPiece->m_position.y).c_str());
+    LOG(LogGame, Info, "Add Chess piece [ %s ]      to [ %s ] / grid = [ %d, %d ] world = [ %.2f, %.2f ]", chessPiece->m_definition->m_name.c_str(), gridPosition.c_str(), girdPos.x, girdPos.y,
+        chessPiece->m_position.x, chessPiece->m_position.y);
     return chessPiece;
 }
 
 ChessPiece* ChessMatch::ExecuteChessMove(IntVec2 fromPos, IntVec2 toPos, std::string strFrom, std::string strTo, Strings meta)
 {
     using namespace ChessMatchCommon;
-    auto mover = dynamic_cast<ChessPiece*>(m_chessGrid[fromPos.x][fromPos.y]);
+    auto mover = ActorCast<ChessPiece>(m_chessGrid[fromPos.x][fromPos.y]);
     if (!mover)
     {
         g_theDevConsole->AddLine(DevConsole::COLOR_WARNING,
@@ -228,7 +264,7 @@ ChessPiece* ChessMatch::ExecuteChessMove(IntVec2 fromPos, IntVec2 toPos, std::st
         IntVec2 rookFrom = kingSide ? IntVec2(7, fromPos.y) : IntVec2(0, fromPos.y);
         IntVec2 rookTo   = fromPos + IntVec2(dir, 0);
 
-        auto rook                           = dynamic_cast<ChessPiece*>(m_chessGrid[rookFrom.x][rookFrom.y]);
+        auto rook                           = ActorCast<ChessPiece>(m_chessGrid[rookFrom.x][rookFrom.y]);
         m_chessGrid[rookFrom.x][rookFrom.y] = nullptr;
         m_chessGrid[rookTo.x][rookTo.y]     = rook;
         rook->m_gridCurrentPosition         = rookTo;
@@ -276,6 +312,7 @@ ChessPiece* ChessMatch::ExecuteChessMove(IntVec2 fromPos, IntVec2 toPos, std::st
     }
 
     g_theDevConsole->AddLine(DevConsole::COLOR_INPUT_NORMAL, to_string(res.m_moveResult));
+    UpdateCollisionBoxes(); // Raycasts later this frame must not pick the captured piece or miss a promoted one
 
 
     if (res.m_piecesCapture && res.m_piecesCapture->m_definition->m_name == "King")
@@ -294,7 +331,7 @@ ChessMatchCommon::MoveResult ChessMatch::ExecuteChessTeleport(IntVec2 fromPos, I
 {
     ChessMatchCommon::MoveResult result;
     using namespace ChessMatchCommon;
-    auto mover = dynamic_cast<ChessPiece*>(m_chessGrid[fromPos.x][fromPos.y]);
+    auto mover = ActorCast<ChessPiece>(m_chessGrid[fromPos.x][fromPos.y]);
     if (!mover)
     {
         result.m_moveResult = ChessMoveResult::INVALID_MOVE_NO_PIECE;
@@ -307,7 +344,7 @@ ChessMatchCommon::MoveResult ChessMatch::ExecuteChessTeleport(IntVec2 fromPos, I
         g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, to_string(result.m_moveResult));
         return result;
     }
-    auto victim = dynamic_cast<ChessPiece*>(m_chessGrid[toPos.x][toPos.y]);
+    auto victim = ActorCast<ChessPiece>(m_chessGrid[toPos.x][toPos.y]);
     // Teleport capture
     if (victim)
     {
@@ -338,6 +375,8 @@ ChessMatchCommon::MoveResult ChessMatch::ExecuteChessTeleport(IntVec2 fromPos, I
         result.m_moveResult               = ChessMoveResult::VALID_MOVE_TELEPORT;
         g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, to_string(result.m_moveResult));
     }
+    UpdateCollisionBoxes(); // Raycasts later this frame must not pick the captured piece
+
     // Capture king
     if (result.m_piecesCapture && result.m_piecesCapture->m_definition->m_name == "King")
     {
@@ -366,27 +405,14 @@ ChessMatchCommon::RaycastResultChess ChessMatch::Raycast(const Vec3& origin, con
     using namespace ChessMatchCommon;
     RaycastResultChess result;
 
+    const ComponentStorage<CollisionBoxData>* boxes = m_entities.FindStorage<CollisionBoxData>();
+    if (!boxes) return result;
+
+    // Only the squares along the ray and the few boxes off the grid are tested, not every actor
+    Actor*                                   owner = nullptr;
     std::pair<RaycastResult3D, ChessObject*> resultPair;
-    float                                    closestDistance = FLT_MAX;
-    for (Actor* actor : m_actors)
-    {
-        if (!actor) continue;
-        auto chessObject = dynamic_cast<ChessObject*>(actor);
-        if (!chessObject)continue;
-        if (chessObject->GetIsGarbage()) continue;
-        CollisionComponent* collisionComponent = chessObject->GetComponent<CollisionComponent>();
-        if (!collisionComponent) continue;
-
-        RaycastResult3D geometryRaycastResult = collisionComponent->Raycast(origin, direction, maxDistance);
-        if (geometryRaycastResult.m_didImpact)
-        {
-            if (geometryRaycastResult.m_impactDist < closestDistance)
-            {
-                closestDistance = geometryRaycastResult.m_impactDist;
-                resultPair      = std::make_pair(geometryRaycastResult, chessObject);
-            }
-        }
-    }
+    resultPair.first  = m_picking.Raycast(*boxes, origin, direction, maxDistance, owner);
+    resultPair.second = static_cast<ChessObject*>(owner);
 
 
     /// Consider use union to alignment the memory?
@@ -402,13 +428,71 @@ ChessMatchCommon::RaycastResultChess ChessMatch::Raycast(const Vec3& origin, con
 }
 
 
+void ChessMatch::UpdateCollisionBoxes()
+{
+    ComponentStorage<CollisionBoxData>& boxes   = m_entities.GetStorage<CollisionBoxData>();
+    CollisionBoxData*                   data    = boxes.GetData();
+    int                                 count   = static_cast<int>(boxes.Size());
+    auto                                refresh = [data](int index)
+    {
+        CollisionBoxData& box = data[index];
+        box.m_worldBox        = box.m_localBox;
+        box.m_worldBox.SetCenter(box.m_owner->m_position + box.m_offset);
+    };
+
+    // Each box only reads its own owner, scenes with many props split them over the workers
+    if (g_theJobSystem && count > COLLISION_REFRESH_BATCH)
+    {
+        PROFILE_SCOPE("ChessMatch::UpdateCollisionBoxes::Parallel");
+        g_theJobSystem->ParallelFor(count, COLLISION_REFRESH_BATCH, refresh);
+    }
+    else
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            refresh(i);
+        }
+    }
+    m_picking.Rebuild(boxes);
+}
+
+void ChessMatch::CollectGarbage()
+{
+    PROFILE_SCOPE("ChessMatch::CollectGarbage");
+    for (size_t i = m_actors.size(); i-- > 0;)
+    {
+        if (m_actors[i] && !m_actors[i]->GetIsGarbage()) continue;
+        if (m_actors[i]) ReleaseActor(m_actors[i]);
+        m_actors[i] = m_actors.back(); // Already visited, alive
+        m_actors.pop_back();
+    }
+}
+
+void ChessMatch::ReleaseActor(Actor* actor)
+{
+    LOG(LogGame, Info, "Release destroyed actor [ %u ]", actor->GetID());
+    m_entities.RemoveEntity(actor->GetID());
+    m_transforms.Remove(actor);
+    m_animations.Stop(actor);
+    for (std::vector<Actor*>& column : m_chessGrid)
+    {
+        std::replace(column.begin(), column.end(), actor, static_cast<Actor*>(nullptr));
+    }
+    if (m_selectedPiece == actor)
+        m_selectedPiece = nullptr;
+    delete actor;
+}
+
 void ChessMatch::ClearPawnDoubleMoveFlags()
 {
-    std::vector<ChessPiece*> outPieces;
-    ChessMatchCommon::GetAllPieces(m_chessGrid, outPieces);
-    for (auto piece : outPieces)
+    // Walks the grid in place, GetAllPieces would fill a fresh vector every round
+    for (std::vector<Actor*>& column : m_chessGrid)
     {
-        if (piece && piece->m_definition->m_name == "Pawn")
-            piece->m_movedTwoSquaresLastTurn = false;
+        for (Actor* actor : column)
+        {
+            auto piece = ActorCast<ChessPiece>(actor);
+            if (piece && piece->m_definition->m_name == "Pawn")
+                piece->m_movedTwoSquaresLastTurn = false;
+        }
     }
 }
@@ -6,6 +6,12 @@
 #include "Engine/Math/EulerAngles.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Renderer/Light/Light.hpp"
+#include "Game/Core/EventChannel.hpp"
+#include "Game/Core/ObjectArena.hpp"
+#include "Game/Core/Actor/EntityRegistry.hpp"
+#include "Game/Core/Actor/TransformPool.hpp"
+#include "Game/Module/Gameplay/PickingGrid.hpp"
+#include "Game/Module/Gameplay/PieceAnimationSystem.hpp"
 #include "Game/Core/Serilization/Serializable.hpp"
 #include "Game/Module/Lib/ChessMatchCommon.hpp"
 
@@ -50,6 +56,7 @@ public:
     XmlElement* ToXML() const override;
 
     void Update();
+    void CollectGarbage(); ///< Frees the actors destroyed this frame and compacts m_actors, called at the end of the frame
 
     /// Spawn Actor in Map (Match)
         /// @param position 
@@ -66,26 +73,36 @@ public:
     /// Raycast
     [[nodiscard]]
     ChessMatchCommon::RaycastResultChess Raycast(const Vec3& origin, const Vec3& direction, float maxDistance) const;
+    void UpdateCollisionBoxes(); ///< Moves every world box onto its owner and files it for picking, after the animations and after every executed move
 
     std::vector<Faction>      m_factions;
     std::vector<ChessPlayer*> m_players;
     int                       m_currentPlayerIndex = 0;
     int                       m_turnCounter        = 0;
+    uint64_t                  m_updateAllocations  = 0; ///< Allocations of the last Update on the main thread, 0 in steady state
 
 protected:
-    ChessBoard*         m_chessBoard = nullptr;
-    std::vector<Actor*> m_actors; /// Board data Layout
-    ChessGrid           m_chessGrid;
+    ObjectArena          m_arena; /// Every actor and component the match spawns, declared first so it outlives them
+    ChessBoard*          m_chessBoard = nullptr;
+    std::vector<Actor*>  m_actors; /// Board data Layout
+    ChessGrid            m_chessGrid;
+    EntityRegistry       m_entities; /// Collision boxes of the spawned ChessObjects
+    PickingGrid          m_picking; /// The collision boxes filed by square for Raycast, refreshed with them
+    TransformPool        m_transforms; /// World matrices of every spawned actor, refreshed once the actors ticked, read directly by MeshComponent::Render
+    PieceAnimationSystem m_animations; /// Move tweens of the pieces, advanced on the game clock before the actors tick
 
     /// Select and highlight
     IntVec2     m_impactSquare      = IntVec2::INVALID;
     IntVec2     m_highLightedSquare = IntVec2::INVALID;
     ChessPiece* m_selectedPiece     = nullptr;
 
+    EventChannel<ChessMatchCommon::HighlightChangedEvent> m_highlightChanged{EEventChannel::HIGHLIGHT_CHANGED}; /// Fired by the player when m_highLightedSquare changes
+
 
     Game* m_game = nullptr;
 
     void ClearPawnDoubleMoveFlags(); ///< Called at the end of each round
+    void ReleaseActor(Actor* actor); ///< Drops every reference the match holds and deletes it
 
     /// Test Lights
     Light m_pointLight;
@@ -4,6 +4,7 @@
 
 ChessObject::ChessObject()
 {
+    AddKind(KIND);
     m_meshComponent      = AddComponent<MeshComponent>();
     m_collisionComponent = AddComponent<CollisionComponent>();
 }
@@ -8,6 +8,8 @@ class MeshComponent;
 class ChessObject : public Actor
 {
 public:
+    static constexpr EActorKind KIND = EActorKind::CHESS_OBJECT;
+
     ChessObject();
 
     ChessObject* SetOuter(ChessMatch* outer)
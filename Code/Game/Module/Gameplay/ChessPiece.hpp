@@ -4,17 +4,18 @@
 #include "Game/Module/Lib/ChessMatchCommon.hpp"
 
 class CollisionComponent;
-class Timer;
 class ChessPieceDefinition;
 class ChessMatch;
-using AnimationCallback = void (ChessPiece::*)();
 
 class ChessPiece : public ChessObject
 {
     friend class ChessMatch;
     friend class ChessPlayer;
+    friend struct ChessBoardState;
 
 public:
+    static constexpr EActorKind KIND = EActorKind::CHESS_PIECE;
+
     ChessPiece();
     ~ChessPiece() override;
 
@@ -30,7 +31,6 @@ public:
     /// Highlight
     bool SetEnableHighlight(bool newEnable);
 
-    void                        OnTick(float deltaTime) override;
     std::string                 GetGlyph() { return glyph; }
     const ChessPieceDefinition* GetDefinition() const { return m_definition; }
 
@@ -46,20 +46,11 @@ protected:
     ChessPieceDefinition* m_definition           = nullptr;
     int                   m_faction              = -1; ///< 0 = white, 1 = black
 
-    /// Animation
-    float             m_timeSinceMove        = 0.f;
-    float             m_animationTime        = 1.0f;
-    Timer*            m_animationTimer       = nullptr;
-    float             m_animationJumpHeight  = 1.0f;
-    Vec3              m_animationPosition[2] = {};
-    AnimationCallback m_animationCallback    = nullptr;
+    /// Animation, played by the PieceAnimationSystem of the match
+    float m_animationTime       = 1.0f;
+    float m_animationJumpHeight = 1.0f;
 
     /// Highlight
     bool           m_bIsHighlighted  = false;
     MeshComponent* m_squareHighlight = nullptr;
-
-private:
-    void UpdateAnimation();
-    void ChessMoveSlide();
-    void ChessMoveJump();
 };
@@ -14,7 +14,8 @@ using namespace ChessMatchCommon;
 
 ChessPlayer::ChessPlayer(ChessMatch* match) : m_match(match)
 {
-    LOG(LogActor, Info, ((Stringf("Create ChessPlayer Actor with faction id = %d",m_faction.m_id)).c_str()));
+    AddKind(KIND);
+    LOG(LogActor, Info, "Create ChessPlayer Actor with faction id = %d", m_faction.m_id);
     m_spectatorCamera = g_theGame->m_spectatorCamera;
 }
 
@@ -52,15 +53,15 @@ void ChessPlayer::OnTick(float deltaTime)
     ChessMatchCommon::RaycastResultChess result = m_match->Raycast(start, forward, 10.f);
     if (result.m_didImpact)
     {
-        auto board = dynamic_cast<ChessBoard*>(result.m_hitObject);
-        auto piece = dynamic_cast<ChessPiece*>(result.m_hitObject);
+        auto board = ActorCast<ChessBoard>(result.m_hitObject);
+        auto piece = ActorCast<ChessPiece>(result.m_hitObject);
         if (board)
         {
             bool validDirection = result.m_impactNormal.z > 0.f;
             if (validDirection)
             {
                 m_match->m_impactSquare = IntVec2(static_cast<int>(result.m_impactPos.x), static_cast<int>(result.m_impactPos.y));
-                auto pieceOnSquare      = dynamic_cast<ChessPiece*>(m_match->m_chessGrid[m_match->m_impactSquare.x][m_match->m_impactSquare.y]);
+                auto pieceOnSquare      = ActorCast<ChessPiece>(m_match->m_chessGrid[m_match->m_impactSquare.x][m_match->m_impactSquare.y]);
                 if (pieceOnSquare && pieceOnSquare->m_faction == m_faction.m_id)
                     m_match->m_highLightedSquare = m_match->m_impactSquare;
             }
@@ -79,15 +80,12 @@ void ChessPlayer::OnTick(float deltaTime)
     HandlePlayerClickSelect();
     HandlePlayerClickMove();
 
-    if (m_match->m_highLightedSquare != IntVec2::INVALID)
+    // Edge triggered, the board only hears about the square when it changes
+    HighlightChangedEvent highlight;
+    highlight.m_square = m_match->m_highLightedSquare;
+    if (m_match->m_highlightChanged.FireOnChange(highlight) && highlight.m_square != IntVec2::INVALID)
     {
-        EventArgs args;
-        args.SetValue("position", m_match->m_highLightedSquare.toString());
-        g_theEventSystem->FireEvent("event.highlight.enable", args);
-    }
-    else
-    {
-        g_theEventSystem->FireEvent("event.highlight.disable");
+        LOG(LogGame, Info, "Faction %d highlights square [ %d, %d ]", m_faction.m_id, highlight.m_square.x, highlight.m_square.y);
     }
 }
 
@@ -102,7 +100,7 @@ void ChessPlayer::HandlePlayerClickSelect()
         {
             if (leftClick)
             {
-                m_match->m_selectedPiece = dynamic_cast<ChessPiece*>(m_match->m_chessGrid[m_match->m_highLightedSquare.x][m_match->m_highLightedSquare.y]);
+                m_match->m_selectedPiece = ActorCast<ChessPiece>(m_match->m_chessGrid[m_match->m_highLightedSquare.x][m_match->m_highLightedSquare.y]);
                 if (m_match->m_selectedPiece->m_faction == m_faction.m_id)
                 {
                     m_match->m_selectedPiece->SetEnableHighlight(true);
@@ -7,6 +7,8 @@ class Camera;
 class ChessPlayer : public Actor
 {
 public:
+    static constexpr EActorKind KIND = EActorKind::CHESS_PLAYER;
+
     ChessPlayer(ChessMatch* match);
     ~ChessPlayer() override;
 
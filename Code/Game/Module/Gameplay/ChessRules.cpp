@@ -0,0 +1,413 @@
+﻿#include "ChessRules.hpp"
+
+#include <cstdlib>
+
+#include "ChessPiece.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Module/Definition/ChessPieceDefinition.hpp"
+
+using namespace ChessMatchCommon;
+
+namespace
+{
+    int Signi(int v) { return (v > 0) - (v < 0); }
+
+    bool IsInside(IntVec2 pos)
+    {
+        return pos.x >= 0 && pos.x <= 7 && pos.y >= 0 && pos.y <= 7;
+    }
+
+    bool IsPathClear(const ChessBoardState& state, IntVec2 from, IntVec2 to)
+    {
+        int     dx  = Signi(to.x - from.x);
+        int     dy  = Signi(to.y - from.y);
+        IntVec2 cur = from + IntVec2(dx, dy);
+        while (cur != to)
+        {
+            if (!state.At(cur).IsEmpty()) return false;
+            cur += IntVec2(dx, dy);
+        }
+        return true;
+    }
+
+    void StepNextTurn(ChessBoardState& state)
+    {
+        state.m_turnCounter++;
+        state.m_currentFaction = (state.m_currentFaction + 1) % state.m_factionCount;
+    }
+}
+
+ChessBoardState ChessBoardState::FromGrid(ChessGrid& grid, int turnCounter, int currentFaction)
+{
+    ChessBoardState state;
+    state.m_turnCounter    = turnCounter;
+    state.m_currentFaction = currentFaction;
+    for (int x = 0; x < 8; ++x)
+    {
+        for (int y = 0; y < static_cast<int>(grid[x].size()); ++y)
+        {
+            auto piece = ActorCast<ChessPiece>(grid[x][y]);
+            if (!piece || !piece->m_definition) continue;
+
+            ChessSquare& square              = state.At(IntVec2(x, y));
+            square.m_type                    = ChessRules::PieceTypeFromName(piece->m_definition->m_name);
+            square.m_faction                 = static_cast<int8_t>(piece->m_faction);
+            square.m_hasMoved                = piece->m_hasMoved;
+            square.m_movedTwoSquaresLastTurn = piece->m_movedTwoSquaresLastTurn;
+            square.m_lastMoveTurn            = piece->m_lastMoveTurn;
+        }
+    }
+    return state;
+}
+
+ChessBoardState ChessBoardState::FromMatchConfig(const XmlElement& rootElement)
+{
+    ChessBoardState   state;
+    const XmlElement* chessBoardElement  = FindChildElementByName(rootElement, "ChessBoard");
+    const XmlElement* chessPiecesElement = chessBoardElement ? FindChildElementByName(*chessBoardElement, "ChessPieces") : nullptr;
+    const XmlElement* element            = chessPiecesElement ? chessPiecesElement->FirstChildElement() : nullptr;
+    while (element != nullptr)
+    {
+        IntVec2 pos = GetGridPosition(ParseXmlAttribute(*element, "position", std::string()));
+        if (IsInside(pos))
+        {
+            ChessSquare& square = state.At(pos);
+            square.m_type       = ChessRules::PieceTypeFromName(ParseXmlAttribute(*element, "name", std::string()));
+            square.m_faction    = static_cast<int8_t>(ParseXmlAttribute(*element, "faction", -1));
+        }
+        element = element->NextSiblingElement();
+    }
+    return state;
+}
+
+std::string ChessBoardState::ToText() const
+{
+    std::string text = "  ABCDEFGH  \n +--------+ \n";
+    for (int y = 7; y >= 0; --y)
+    {
+        text += std::to_string(y + 1) + "|";
+        for (int x = 0; x < 8; ++x)
+        {
+            text += ChessRules::GetGlyph(At(IntVec2(x, y)));
+        }
+        text += "|" + std::to_string(y + 1) + "\n";
+    }
+    return text + " +--------+ \n  ABCDEFGH  ";
+}
+
+std::string ChessBoardState::ToLine() const
+{
+    std::string line;
+    line.reserve(80);
+    for (int y = 7; y >= 0; --y)
+    {
+        for (int x = 0; x < 8; ++x)
+        {
+            line += ChessRules::GetGlyph(At(IntVec2(x, y)));
+        }
+        line += y == 0 ? ' ' : '/';
+    }
+    return line + std::to_string(m_turnCounter);
+}
+
+EChessPieceType ChessRules::PieceTypeFromName(const std::string& name)
+{
+    std::string lower = Common::ToLower(name);
+    if (lower == "pawn") return EChessPieceType::PAWN;
+    if (lower == "knight") return EChessPieceType::KNIGHT;
+    if (lower == "bishop") return EChessPieceType::BISHOP;
+    if (lower == "rook") return EChessPieceType::ROOK;
+    if (lower == "queen") return EChessPieceType::QUEEN;
+    if (lower == "king") return EChessPieceType::KING;
+    return EChessPieceType::NONE;
+}
+
+const char* ChessRules::PieceTypeToName(EChessPieceType type)
+{
+    switch (type)
+    {
+    case EChessPieceType::PAWN: return "Pawn";
+    case EChessPieceType::KNIGHT: return "Knight";
+    case EChessPieceType::BISHOP: return "Bishop";
+    case EChessPieceType::ROOK: return "Rook";
+    case EChessPieceType::QUEEN: return "Queen";
+    case EChessPieceType::KING: return "King";
+    case EChessPieceType::NONE: break;
+    }
+    return "None";
+}
+
+char ChessRules::GetGlyph(const ChessSquare& square)
+{
+    static const char* GLYPHS = ".PNBRQK";
+    char               glyph  = GLYPHS[static_cast<int>(square.m_type)];
+    if (square.m_faction == 1 && glyph != '.')
+    {
+        glyph = static_cast<char>(glyph - 'A' + 'a');
+    }
+    return glyph;
+}
+
+bool ChessRules::IsValid(ChessMoveResult result)
+{
+    MoveResult moveResult;
+    moveResult.m_moveResult = result;
+    return GetChessMoveValid(moveResult);
+}
+
+ChessRuleResult ChessRules::Evaluate(const ChessBoardState& state, IntVec2 fromPos, IntVec2 toPos)
+{
+    ChessRuleResult r;
+
+    // Coordinate validity
+    if (fromPos == toPos)
+    {
+        r.m_moveResult = ChessMoveResult::INVALID_MOVE_ZERO_DISTANCE;
+        return r;
+    }
+    if (!IsInside(fromPos) || !IsInside(toPos))
+    {
+        r.m_moveResult = ChessMoveResult::INVALID_MOVE_BAD_LOCATION;
+        return r;
+    }
+
+    const ChessSquare& mover = state.At(fromPos);
+    const ChessSquare& dst   = state.At(toPos);
+    if (!dst.IsEmpty() && dst.m_faction == mover.m_faction)
+    {
+        r.m_moveResult = ChessMoveResult::INVALID_MOVE_DESTINATION_BLOCKED;
+        return r;
+    }
+    if (!dst.IsEmpty())
+    {
+        r.m_captureSquare = toPos;
+    }
+
+    const int dx  = toPos.x - fromPos.x;
+    const int dy  = toPos.y - fromPos.y;
+    const int adx = std::abs(dx);
+    const int ady = std::abs(dy);
+
+    ChessMoveResult normal = dst.IsEmpty() ? ChessMoveResult::VALID_MOVE_NORMAL : ChessMoveResult::VALID_CAPTURE_NORMAL;
+
+    switch (mover.m_type)
+    {
+    case EChessPieceType::KNIGHT:
+        r.m_moveResult = (adx == 2 && ady == 1) || (adx == 1 && ady == 2) ? normal : ChessMoveResult::INVALID_MOVE_WRONG_MOVE_SHAPE;
+        break;
+
+    case EChessPieceType::BISHOP:
+        if (adx != ady) r.m_moveResult = ChessMoveResult::INVALID_MOVE_WRONG_MOVE_SHAPE;
+        else if (!IsPathClear(state, fromPos, toPos)) r.m_moveResult = ChessMoveResult::INVALID_MOVE_PATH_BLOCKED;
+        else r.m_moveResult = normal;
+        break;
+
+    case EChessPieceType::ROOK:
+        if (adx != 0 && ady != 0) r.m_moveResult = ChessMoveResult::INVALID_MOVE_WRONG_MOVE_SHAPE;
+        else if (!IsPathClear(state, fromPos, toPos)) r.m_moveResult = ChessMoveResult::INVALID_MOVE_PATH_BLOCKED;
+        else r.m_moveResult = normal;
+        break;
+
+    case EChessPieceType::QUEEN:
+        if (!(adx == ady || adx == 0 || ady == 0)) r.m_moveResult = ChessMoveResult::INVALID_MOVE_WRONG_MOVE_SHAPE;
+        else if (!IsPathClear(state, fromPos, toPos)) r.m_moveResult = ChessMoveResult::INVALID_MOVE_PATH_BLOCKED;
+        else r.m_moveResult = normal;
+        break;
+
+    case EChessPieceType::PAWN:
+        {
+            int dir      = (mover.m_faction == 0) ? +1 : -1; // White moves toward +y
+            int startRow = (mover.m_faction == 0) ? 1 : 6;
+
+            // Single step forward
+            if (dx == 0 && dy == dir && dst.IsEmpty())
+            {
+                r.m_moveResult = (toPos.y == 0 || toPos.y == 7) ? ChessMoveResult::VALID_MOVE_PROMOTION : ChessMoveResult::VALID_MOVE_NORMAL;
+            }
+            // First round double step
+            else if (dx == 0 && dy == 2 * dir && dst.IsEmpty() && fromPos.y == startRow)
+            {
+                r.m_moveResult = state.At(fromPos + IntVec2(0, dir)).IsEmpty() ? ChessMoveResult::VALID_MOVE_NORMAL : ChessMoveResult::INVALID_MOVE_PATH_BLOCKED;
+            }
+            // Diagonal capture / en passant
+            else if (adx == 1 && dy == dir)
+            {
+                if (!dst.IsEmpty())
+                {
+                    r.m_moveResult = (toPos.y == 0 || toPos.y == 7) ? ChessMoveResult::VALID_CAPTURE_PROMOTION : ChessMoveResult::VALID_CAPTURE_NORMAL;
+                }
+                else
+                {
+                    IntVec2            sidePos  = fromPos + IntVec2(dx, 0);
+                    const ChessSquare& sidePawn = state.At(sidePos);
+                    if (sidePawn.m_type == EChessPieceType::PAWN && sidePawn.m_faction != mover.m_faction &&
+                        sidePawn.m_movedTwoSquaresLastTurn && sidePawn.m_lastMoveTurn == state.m_turnCounter - 1)
+                    {
+                        r.m_captureSquare = sidePos;
+                        r.m_moveResult    = ChessMoveResult::VALID_CAPTURE_ENPASSANT;
+                    }
+                    else
+                    {
+                        r.m_moveResult = ChessMoveResult::INVALID_MOVE_WRONG_MOVE_SHAPE;
+                    }
+                }
+            }
+            else
+            {
+                r.m_moveResult = ChessMoveResult::INVALID_MOVE_WRONG_MOVE_SHAPE;
+            }
+        }
+        break;
+
+    case EChessPieceType::KING:
+        if (adx <= 1 && ady <= 1)
+        {
+            r.m_moveResult = normal;
+        }
+        // Castling
+        else if (mover.m_hasMoved)
+        {
+            r.m_moveResult = ChessMoveResult::INVALID_CASTLE_KING_HAS_MOVED;
+        }
+        else if (ady != 0 || !(adx == 2 || adx == 3))
+        {
+            r.m_moveResult = ChessMoveResult::INVALID_MOVE_WRONG_MOVE_SHAPE;
+        }
+        else
+        {
+            bool               kingSide = dx > 0;
+            IntVec2            rookPos  = kingSide ? IntVec2(7, fromPos.y) : IntVec2(0, fromPos.y);
+            const ChessSquare& rook     = state.At(rookPos);
+            if (rook.m_type != EChessPieceType::ROOK || rook.m_hasMoved)
+                r.m_moveResult = ChessMoveResult::INVALID_CASTLE_ROOK_HAS_MOVED;
+            else if (!IsPathClear(state, fromPos, rookPos))
+                r.m_moveResult = ChessMoveResult::INVALID_CASTLE_PATH_BLOCKED;
+            else
+                r.m_moveResult = kingSide ? ChessMoveResult::VALID_CASTLE_KINGSIDE : ChessMoveResult::VALID_CASTLE_QUEENSIDE;
+        }
+        break;
+
+    case EChessPieceType::NONE:
+        break;
+    }
+
+    // If still not set, keep UNKNOWN (considered invalid)
+    if (r.m_moveResult == ChessMoveResult::UNKNOWN)
+        r.m_moveResult = ChessMoveResult::INVALID_MOVE_WRONG_MOVE_SHAPE;
+    return r;
+}
+
+ChessRuleResult ChessRules::ApplyMove(ChessBoardState& state, IntVec2 fromPos, IntVec2 toPos, EChessPieceType promoteTo)
+{
+    ChessRuleResult result;
+    if (!IsInside(fromPos) || state.At(fromPos).IsEmpty())
+    {
+        result.m_moveResult = ChessMoveResult::INVALID_MOVE_NO_PIECE;
+        return result;
+    }
+    if (state.At(fromPos).m_faction != state.m_currentFaction)
+    {
+        result.m_moveResult = ChessMoveResult::INVALID_MOVE_NOT_YOUR_PIECE;
+        return result;
+    }
+
+    result = Evaluate(state, fromPos, toPos);
+    if (!IsValid(result.m_moveResult))
+    {
+        return result;
+    }
+
+    // Clear the double step markers from the previous round
+    for (ChessSquare& square : state.m_squares)
+    {
+        if (square.m_type == EChessPieceType::PAWN) square.m_movedTwoSquaresLastTurn = false;
+    }
+
+    ChessSquare mover    = state.At(fromPos);
+    bool        captured = result.m_captureSquare != IntVec2::INVALID;
+    bool        kingHit  = captured && state.At(result.m_captureSquare).m_type == EChessPieceType::KING;
+    if (captured)
+    {
+        state.At(result.m_captureSquare) = ChessSquare();
+    }
+
+    // King and Rook Castling Synchronous Rook Movement
+    if (result.m_moveResult == ChessMoveResult::VALID_CASTLE_KINGSIDE || result.m_moveResult == ChessMoveResult::VALID_CASTLE_QUEENSIDE)
+    {
+        bool    kingSide = result.m_moveResult == ChessMoveResult::VALID_CASTLE_KINGSIDE;
+        IntVec2 rookFrom = kingSide ? IntVec2(7, fromPos.y) : IntVec2(0, fromPos.y);
+        IntVec2 rookTo   = fromPos + IntVec2(kingSide ? +1 : -1, 0);
+
+        ChessSquare rook   = state.At(rookFrom);
+        rook.m_hasMoved    = true;
+        state.At(rookFrom) = ChessSquare();
+        state.At(rookTo)   = rook;
+    }
+
+    // Move the main chess piece
+    mover.m_lastMoveTurn            = state.m_turnCounter;
+    mover.m_hasMoved                = true;
+    mover.m_movedTwoSquaresLastTurn = mover.m_type == EChessPieceType::PAWN && std::abs(toPos.y - fromPos.y) == 2;
+    if ((result.m_moveResult == ChessMoveResult::VALID_MOVE_PROMOTION || result.m_moveResult == ChessMoveResult::VALID_CAPTURE_PROMOTION) &&
+        promoteTo != EChessPieceType::NONE)
+    {
+        mover.m_type = promoteTo;
+    }
+    state.At(fromPos) = ChessSquare();
+    state.At(toPos)   = mover;
+
+    if (kingHit)
+    {
+        state.m_winnerFaction = mover.m_faction;
+        return result;
+    }
+
+    // End of turn
+    StepNextTurn(state);
+    return result;
+}
+
+ChessRuleResult ChessRules::ApplyTeleport(ChessBoardState& state, IntVec2 fromPos, IntVec2 toPos)
+{
+    ChessRuleResult result;
+    if (!IsInside(fromPos) || !IsInside(toPos) || state.At(fromPos).IsEmpty())
+    {
+        result.m_moveResult = ChessMoveResult::INVALID_MOVE_NO_PIECE;
+        return result;
+    }
+    if (state.At(fromPos).m_faction != state.m_currentFaction)
+    {
+        result.m_moveResult = ChessMoveResult::INVALID_MOVE_NOT_YOUR_PIECE;
+        return result;
+    }
+
+    const ChessSquare& victim  = state.At(toPos);
+    bool               kingHit = false;
+    if (!victim.IsEmpty())
+    {
+        if (victim.m_faction == state.m_currentFaction)
+        {
+            result.m_moveResult = ChessMoveResult::INVALID_MOVE_BAD_LOCATION;
+            return result;
+        }
+        kingHit                = victim.m_type == EChessPieceType::KING;
+        result.m_captureSquare = toPos;
+        result.m_moveResult    = ChessMoveResult::VALID_CAPTURE_TELEPORT;
+    }
+    else
+    {
+        result.m_moveResult = ChessMoveResult::VALID_MOVE_TELEPORT;
+    }
+
+    // Teleports skip the move bookkeeping, exactly like ChessMatch::ExecuteChessTeleport
+    state.At(toPos)   = state.At(fromPos);
+    state.At(fromPos) = ChessSquare();
+
+    if (kingHit)
+    {
+        state.m_winnerFaction = state.At(toPos).m_faction;
+        return result;
+    }
+    StepNextTurn(state);
+    return result;
+}
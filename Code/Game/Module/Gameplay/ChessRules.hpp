@@ -0,0 +1,79 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Game/Module/Lib/ChessMatchCommon.hpp"
+
+enum class EChessPieceType : uint8_t
+{
+    NONE,
+    PAWN,
+    KNIGHT,
+    BISHOP,
+    ROOK,
+    QUEEN,
+    KING
+};
+
+/// One square of a ChessBoardState, the rule relevant part of a ChessPiece
+struct ChessSquare
+{
+    EChessPieceType m_type                    = EChessPieceType::NONE;
+    int8_t          m_faction                 = -1; ///< 0 = white, 1 = black
+    bool            m_hasMoved                = false;
+    bool            m_movedTwoSquaresLastTurn = false;
+    int             m_lastMoveTurn            = -1;
+
+    bool IsEmpty() const { return m_type == EChessPieceType::NONE; }
+};
+
+/// ChessBoardState ― Compact copyable snapshot of a match, enough to evaluate and apply moves without any Actor.
+struct ChessBoardState
+{
+    ChessSquare m_squares[64];
+    int         m_turnCounter    = 0;
+    int         m_currentFaction = 0;
+    int         m_factionCount   = 2;
+    int         m_winnerFaction  = -1; ///< Set once a king is captured, the match is over
+
+    ChessSquare&       At(IntVec2 pos) { return m_squares[pos.y * 8 + pos.x]; }
+    const ChessSquare& At(IntVec2 pos) const { return m_squares[pos.y * 8 + pos.x]; }
+    bool               IsOver() const { return m_winnerFaction != -1; }
+
+    /// Snapshot of the live grid, the same view ChessPiece::ChessMove evaluates against
+    static ChessBoardState FromGrid(ChessGrid& grid, int turnCounter, int currentFaction);
+    /// Starting position from the root element of ChessMatchConfig.xml, the same pieces ChessMatch::FromXML spawns
+    static ChessBoardState FromMatchConfig(const XmlElement& rootElement);
+
+    /// Rank 8 first, one line per rank in the PrintChessGrid glyph layout
+    std::string ToText() const;
+    /// Single line "rank8/rank7/.../rank1 turn" for reports and diffs
+    std::string ToLine() const;
+};
+
+/// Result of a rule evaluation, the capture square is INVALID when nothing is taken
+struct ChessRuleResult
+{
+    ChessMatchCommon::ChessMoveResult m_moveResult    = ChessMatchCommon::ChessMoveResult::UNKNOWN;
+    IntVec2                           m_captureSquare = IntVec2::INVALID;
+};
+
+/// ChessRules ― Pure move kernel shared by the live match and the headless script runner.
+namespace ChessRules
+{
+    EChessPieceType PieceTypeFromName(const std::string& name);
+    const char*     PieceTypeToName(EChessPieceType type);
+    char            GetGlyph(const ChessSquare& square);
+
+    /// Rule determination only, the state is never modified
+    ChessRuleResult Evaluate(const ChessBoardState& state, IntVec2 fromPos, IntVec2 toPos);
+    bool            IsValid(ChessMatchCommon::ChessMoveResult result);
+
+    /// Same steps as ChessMatch::ExecuteChessMove over a snapshot: turn ownership, capture, castling rook, promotion,
+    /// double step flags and the turn switch.
+    ChessRuleResult ApplyMove(ChessBoardState& state, IntVec2 fromPos, IntVec2 toPos, EChessPieceType promoteTo = EChessPieceType::NONE);
+    /// Same steps as ChessMatch::ExecuteChessTeleport over a snapshot
+    ChessRuleResult ApplyTeleport(ChessBoardState& state, IntVec2 fromPos, IntVec2 toPos);
+}
@@ -0,0 +1,181 @@
+﻿#include "ChessScriptRunner.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "ChessMatch.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Core/AllocationTracker.hpp"
+#include "Game/Module/Lib/CommandArgs.hpp"
+#include "Game/Module/Lib/ScriptFile.hpp"
+
+namespace
+{
+    double GetTimeSeconds()
+    {
+        using namespace std::chrono;
+        return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+bool ChessScriptRunner::Compile(const std::string& path, ChessScript& outScript)
+{
+    std::vector<std::string> lines;
+    if (!LoadScriptLines(path, lines))
+    {
+        return false;
+    }
+    outScript.m_path = path;
+    CompileLines(lines, outScript);
+    return true;
+}
+
+void ChessScriptRunner::CompileLines(const std::vector<std::string>& lines, ChessScript& outScript)
+{
+    outScript.m_ops.reserve(outScript.m_ops.size() + lines.size());
+    for (int i = 0; i < static_cast<int>(lines.size()); ++i)
+    {
+        const std::string& line  = lines[i];
+        size_t             space = line.find(' ');
+        std::string        name  = line.substr(0, space);
+        if (!CommandArgs::EqualsIgnoreCase(name, "ChessMove"))
+        {
+            outScript.m_errors.push_back(Stringf("#%d unsupported command \"%s\"", i + 1, name.c_str()));
+            continue;
+        }
+
+        CommandArgs args(space == std::string::npos ? std::string_view() : std::string_view(line).substr(space + 1));
+        ChessScriptOp op;
+        op.m_command = i + 1;
+        op.m_from    = ChessMatchCommon::StringToGridPos(Common::ToUpper(std::string(args.Get("from"))));
+        op.m_to      = ChessMatchCommon::StringToGridPos(Common::ToUpper(std::string(args.Get("to"))));
+        op.m_type    = args.GetBool("teleport") ? EChessScriptOp::TELEPORT : EChessScriptOp::MOVE;
+        if (!args.IsValid() || op.m_from == IntVec2::INVALID || op.m_to == IntVec2::INVALID)
+        {
+            outScript.m_errors.push_back(Stringf("#%d invalid squares in \"%s\"", i + 1, line.c_str()));
+            continue;
+        }
+        if (args.Has("promoteTo"))
+        {
+            op.m_promoteTo = ChessRules::PieceTypeFromName(std::string(args.Get("promoteTo")));
+            if (op.m_promoteTo == EChessPieceType::NONE || op.m_promoteTo == EChessPieceType::PAWN || op.m_promoteTo == EChessPieceType::KING)
+            {
+                outScript.m_errors.push_back(Stringf("#%d invalid promotion piece in \"%s\"", i + 1, line.c_str()));
+                continue;
+            }
+        }
+        outScript.m_ops.push_back(op);
+    }
+}
+
+ChessScriptResult ChessScriptRunner::RunHeadless(const ChessScript& script, const ChessBoardState& initialState, int repeat)
+{
+    ChessScriptResult result;
+    result.m_path   = script.m_path;
+    result.m_repeat = repeat > 0 ? repeat : 1;
+
+    AllocationScope allocations;
+    uint64_t        firstRunAllocations = 0;
+    double          startSeconds        = GetTimeSeconds();
+    for (int run = 0; run < result.m_repeat; ++run)
+    {
+        ChessBoardState state    = initialState;
+        int             applied  = 0;
+        int             rejected = 0;
+        for (const ChessScriptOp& op : script.m_ops)
+        {
+            if (state.IsOver()) break;
+
+            ChessRuleResult rule = op.m_type == EChessScriptOp::TELEPORT
+                                       ? ChessRules::ApplyTeleport(state, op.m_from, op.m_to)
+                                       : ChessRules::ApplyMove(state, op.m_from, op.m_to, op.m_promoteTo);
+            if (ChessRules::IsValid(rule.m_moveResult))
+            {
+                ++applied;
+            }
+            else
+            {
+                ++rejected;
+                if (run == 0)
+                {
+                    result.m_rejections.push_back(Stringf("#%d %s", op.m_command, ChessMatchCommon::to_string(rule.m_moveResult)));
+                }
+            }
+        }
+        if (run == 0)
+        {
+            result.m_opsApplied  = applied;
+            result.m_opsRejected = rejected;
+            result.m_finalState  = state;
+            firstRunAllocations  = allocations.GetAllocationCount(); // Rejection messages are only built once
+        }
+    }
+    result.m_runSeconds        = GetTimeSeconds() - startSeconds;
+    result.m_steadyAllocations = allocations.GetAllocationCount() - firstRunAllocations;
+    return result;
+}
+
+std::vector<ChessScriptResult> ChessScriptRunner::RunParallel(const std::vector<ChessScript>& scripts, const ChessBoardState& initialState, int repeat, int threadCount)
+{
+    std::vector<ChessScriptResult> results(scripts.size());
+    std::atomic<int>               nextScript = 0;
+
+    auto worker = [&]()
+    {
+        for (int index = nextScript++; index < static_cast<int>(scripts.size()); index = nextScript++)
+        {
+            results[index] = RunHeadless(scripts[index], initialState, repeat);
+        }
+    };
+
+    int workerCount = threadCount < static_cast<int>(scripts.size()) ? threadCount : static_cast<int>(scripts.size());
+    if (workerCount <= 1)
+    {
+        worker();
+        return results;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    return results;
+}
+
+int ChessScriptRunner::RunLive(const ChessScript& script, ChessMatch* match)
+{
+    int applied = 0;
+    for (const ChessScriptOp& op : script.m_ops)
+    {
+        // A captured king ends the match, the remaining ops have nothing to play against
+        if (!match || g_theGame->gameState != EGameState::MATCH) break;
+
+        std::string strFrom = Common::ToUpper(ChessMatchCommon::GridPosToChessNotation(op.m_from));
+        std::string strTo   = Common::ToUpper(ChessMatchCommon::GridPosToChessNotation(op.m_to));
+        Strings     meta;
+        if (op.m_promoteTo != EChessPieceType::NONE)
+        {
+            meta.push_back(std::string("promoteTo=") + ChessRules::PieceTypeToName(op.m_promoteTo));
+        }
+
+        if (op.m_type == EChessScriptOp::TELEPORT)
+        {
+            ChessMatchCommon::MoveResult result = match->ExecuteChessTeleport(op.m_from, op.m_to, strFrom, strTo, meta);
+            if (ChessMatchCommon::GetChessMoveValid(result)) ++applied;
+        }
+        else if (match->ExecuteChessMove(op.m_from, op.m_to, strFrom, strTo, meta))
+        {
+            ++applied;
+        }
+    }
+    return applied;
+}
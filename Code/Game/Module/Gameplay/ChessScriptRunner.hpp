@@ -0,0 +1,60 @@
+﻿#pragma once
+#include <string>
+#include <vector>
+
+#include "ChessRules.hpp"
+
+class ChessMatch;
+
+enum class EChessScriptOp : uint8_t
+{
+    MOVE,
+    TELEPORT
+};
+
+/// One precompiled "ChessMove" command, squares are already grid positions
+struct ChessScriptOp
+{
+    EChessScriptOp  m_type      = EChessScriptOp::MOVE;
+    IntVec2         m_from      = IntVec2::INVALID;
+    IntVec2         m_to        = IntVec2::INVALID;
+    EChessPieceType m_promoteTo = EChessPieceType::NONE;
+    int             m_command   = 0; ///< 1 based index of the command in the script
+};
+
+struct ChessScript
+{
+    std::string                m_path;
+    std::vector<ChessScriptOp> m_ops;
+    std::vector<std::string>   m_errors; ///< Commands that could not be compiled, they are skipped
+};
+
+struct ChessScriptResult
+{
+    std::string              m_path;
+    int                      m_repeat      = 0;
+    int                      m_opsApplied  = 0; ///< Per run
+    int                      m_opsRejected = 0; ///< Per run, moves the rules refused
+    std::vector<std::string> m_rejections;
+    double                   m_runSeconds        = 0.0; ///< Total over every repeat
+    uint64_t                 m_steadyAllocations = 0; ///< Allocations of every run after the first, expected to be 0
+    ChessBoardState          m_finalState;
+
+    double GetSecondsPerRun() const { return m_repeat > 0 ? m_runSeconds / m_repeat : 0.0; }
+};
+
+/// ChessScriptRunner ― Compiles chess command scripts such as Data/Scripts/chess_example.js into typed move operations
+/// and runs them either against the live match or headless against ChessBoardState snapshots on worker threads.
+class ChessScriptRunner
+{
+public:
+    static bool Compile(const std::string& path, ChessScript& outScript);
+    static void CompileLines(const std::vector<std::string>& lines, ChessScript& outScript);
+
+    /// Replays the script repeat times, every run starts again from initialState
+    static ChessScriptResult              RunHeadless(const ChessScript& script, const ChessBoardState& initialState, int repeat = 1);
+    /// One headless run per script, spread over threadCount threads, results keep the order of scripts
+    static std::vector<ChessScriptResult> RunParallel(const std::vector<ChessScript>& scripts, const ChessBoardState& initialState, int repeat, int threadCount);
+    /// Feeds the ops through ChessMatch::ExecuteChessMove / ExecuteChessTeleport, returns the number of accepted ops
+    static int                            RunLive(const ChessScript& script, ChessMatch* match);
+};
@@ -0,0 +1,154 @@
+﻿#include "PickingGrid.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+    /// The part of the ray inside the box, false when it misses
+    bool ClipRay(const AABB3& box, const Vec3& origin, const Vec3& direction, float maxDistance, float& outEnter, float& outExit)
+    {
+        float enter = 0.f;
+        float exit  = maxDistance;
+        float o[3]  = {origin.x, origin.y, origin.z};
+        float d[3]  = {direction.x, direction.y, direction.z};
+        float lo[3] = {box.m_mins.x, box.m_mins.y, box.m_mins.z};
+        float hi[3] = {box.m_maxs.x, box.m_maxs.y, box.m_maxs.z};
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (d[axis] == 0.f)
+            {
+                if (o[axis] < lo[axis] || o[axis] > hi[axis]) return false;
+                continue;
+            }
+            float t0 = (lo[axis] - o[axis]) / d[axis];
+            float t1 = (hi[axis] - o[axis]) / d[axis];
+            if (t0 > t1) std::swap(t0, t1);
+            enter = std::max(enter, t0);
+            exit  = std::min(exit, t1);
+            if (enter > exit) return false;
+        }
+        outEnter = enter;
+        outExit  = exit;
+        return true;
+    }
+
+    bool IsPickable(const CollisionBoxData* box)
+    {
+        return box && !box->m_owner->GetIsGarbage(); // Destroyed during this frame, dropped by CollectGarbage
+    }
+}
+
+void PickingGrid::Rebuild(const ComponentStorage<CollisionBoxData>& boxes)
+{
+    std::fill(&m_cells[0][0], &m_cells[0][0] + SIZE * SIZE, NO_ACTOR);
+    m_hasCells = false;
+    m_offGrid.swap(m_previousOffGrid);
+    m_offGrid.clear();
+    m_offGridBoxes.clear();
+
+    const CollisionBoxData* data     = boxes.GetData();
+    const Actor::ActorID*   entities = boxes.GetEntities();
+    for (int i = 0; i < static_cast<int>(boxes.Size()); ++i)
+    {
+        if (!IsPickable(&data[i])) continue;
+
+        const AABB3& box  = data[i].m_worldBox;
+        int          x    = static_cast<int>(std::floor(box.m_mins.x));
+        int          y    = static_cast<int>(std::floor(box.m_mins.y));
+        bool         fits = x >= 0 && x < SIZE && y >= 0 && y < SIZE && box.m_maxs.x <= static_cast<float>(x + 1) && box.m_maxs.y <= static_cast<float>(y + 1);
+        if (!fits || m_cells[x][y] != NO_ACTOR)
+        {
+            m_offGrid.push_back(entities[i]);
+            m_offGridBoxes.push_back(box);
+            continue;
+        }
+
+        m_cells[x][y] = entities[i];
+        if (!m_hasCells)
+        {
+            m_cellBounds = box;
+            m_hasCells   = true;
+            continue;
+        }
+        m_cellBounds.m_mins = Vec3(std::min(m_cellBounds.m_mins.x, box.m_mins.x), std::min(m_cellBounds.m_mins.y, box.m_mins.y), std::min(m_cellBounds.m_mins.z, box.m_mins.z));
+        m_cellBounds.m_maxs = Vec3(std::max(m_cellBounds.m_maxs.x, box.m_maxs.x), std::max(m_cellBounds.m_maxs.y, box.m_maxs.y), std::max(m_cellBounds.m_maxs.z, box.m_maxs.z));
+    }
+
+    // The board and the idle props stay put, most frames only the bounds of the moving ones change
+    if (m_offGrid == m_previousOffGrid && m_offGridTree.GetItemCount() == GetOffGridCount())
+        m_offGridTree.Refit(m_offGridBoxes.data());
+    else
+        m_offGridTree.Build(m_offGridBoxes.data(), GetOffGridCount());
+}
+
+void PickingGrid::Clear()
+{
+    std::fill(&m_cells[0][0], &m_cells[0][0] + SIZE * SIZE, NO_ACTOR);
+    m_hasCells = false;
+    m_offGrid.clear();
+    m_previousOffGrid.clear();
+    m_offGridBoxes.clear();
+    m_offGridTree.Clear();
+}
+
+RaycastResult3D PickingGrid::Raycast(const ComponentStorage<CollisionBoxData>& boxes, const Vec3& origin, const Vec3& direction, float maxDistance, Actor*& outOwner) const
+{
+    RaycastResult3D closest;
+    float           closestDistance = maxDistance;
+    outOwner                        = nullptr;
+
+    int item = m_offGridTree.Raycast(origin, direction, maxDistance, closest, [&](int index) { return IsPickable(boxes.Get(m_offGrid[index])); });
+    if (item >= 0)
+    {
+        closestDistance = closest.m_impactDist;
+        outOwner        = boxes.Get(m_offGrid[item])->m_owner;
+    }
+
+    float enter = 0.f;
+    float exit  = 0.f;
+    if (!m_hasCells || !ClipRay(m_cellBounds, origin, direction, closestDistance, enter, exit)) return closest;
+
+    // Squares in the order the ray crosses them, a filed box lies inside its square so the first hit is the nearest
+    Vec3  start  = origin + direction * enter;
+    int   x      = std::clamp(static_cast<int>(std::floor(start.x)), 0, SIZE - 1);
+    int   y      = std::clamp(static_cast<int>(std::floor(start.y)), 0, SIZE - 1);
+    int   stepX  = direction.x > 0.f ? 1 : (direction.x < 0.f ? -1 : 0);
+    int   stepY  = direction.y > 0.f ? 1 : (direction.y < 0.f ? -1 : 0);
+    float nextX  = stepX == 0 ? FLT_MAX : (static_cast<float>(x + (stepX > 0 ? 1 : 0)) - origin.x) / direction.x;
+    float nextY  = stepY == 0 ? FLT_MAX : (static_cast<float>(y + (stepY > 0 ? 1 : 0)) - origin.y) / direction.y;
+    float deltaX = stepX == 0 ? FLT_MAX : std::fabs(1.f / direction.x);
+    float deltaY = stepY == 0 ? FLT_MAX : std::fabs(1.f / direction.y);
+
+    float cellEnter = enter;
+    while (cellEnter <= exit)
+    {
+        const CollisionBoxData* data = m_cells[x][y] == NO_ACTOR ? nullptr : boxes.Get(m_cells[x][y]);
+        if (IsPickable(data))
+        {
+            AABB3           box    = data->m_worldBox;
+            RaycastResult3D result = box.Raycast(origin, direction, closestDistance);
+            if (result.m_didImpact && result.m_impactDist < closestDistance)
+            {
+                outOwner = data->m_owner;
+                return result;
+            }
+        }
+
+        if (nextX < nextY)
+        {
+            cellEnter = nextX;
+            nextX += deltaX;
+            x += stepX;
+        }
+        else
+        {
+            cellEnter = nextY;
+            nextY += deltaY;
+            y += stepY;
+        }
+        if (x < 0 || x >= SIZE || y < 0 || y >= SIZE) break;
+    }
+    return closest;
+}
@@ -0,0 +1,34 @@
+﻿#pragma once
+#include <vector>
+
+#include "Game/Core/Actor/BoundingVolumeHierarchy.hpp"
+#include "Game/Core/Actor/EntityRegistry.hpp"
+#include "Game/Core/Component/CollisionComponent.hpp"
+
+/// PickingGrid ― Raycast acceleration over the collision boxes of a match. A box that fits inside the footprint of one
+/// board square is filed under that square, Raycast walks the squares along the ray and tests only their occupants.
+/// Every other box, the board itself, a piece between two squares or any actor off the board, goes into a BVH.
+class PickingGrid
+{
+public:
+    static constexpr int            SIZE     = 8;
+    static constexpr Actor::ActorID NO_ACTOR = 0xFFFFFFFFu;
+
+    /// Files every box again, called once the world boxes were refreshed
+    void Rebuild(const ComponentStorage<CollisionBoxData>& boxes);
+    void Clear();
+
+    /// Nearest box the ray hits, outOwner is its owner or null
+    RaycastResult3D Raycast(const ComponentStorage<CollisionBoxData>& boxes, const Vec3& origin, const Vec3& direction, float maxDistance, Actor*& outOwner) const;
+
+    int GetOffGridCount() const { return static_cast<int>(m_offGrid.size()); }
+
+private:
+    Actor::ActorID              m_cells[SIZE][SIZE] = {};
+    AABB3                       m_cellBounds; // Around the filed boxes, the walk starts and ends on it
+    bool                        m_hasCells = false;
+    std::vector<Actor::ActorID> m_offGrid; // Item i of m_offGridTree
+    std::vector<Actor::ActorID> m_previousOffGrid; // Same items as last frame only refit the tree
+    std::vector<AABB3>          m_offGridBoxes;
+    BoundingVolumeHierarchy     m_offGridTree;
+};
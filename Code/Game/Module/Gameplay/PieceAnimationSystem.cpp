@@ -0,0 +1,150 @@
+﻿#include "PieceAnimationSystem.hpp"
+
+#include "Engine/Math/Easing.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Game/Core/Actor/Actor.hpp"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PIECE_ANIMATION_SSE 1
+#include <xmmintrin.h>
+#else
+#define PIECE_ANIMATION_SSE 0
+#endif
+
+void PieceAnimationSystem::Play(Actor* actor, const Vec3& from, const Vec3& to, float durationSeconds, float jumpHeight)
+{
+    int index = Find(actor);
+    if (index < 0)
+    {
+        index = GetActiveCount();
+        m_actors.push_back(actor);
+        for (std::vector<float>* values : {&m_fromX, &m_fromY, &m_fromZ, &m_deltaX, &m_deltaY, &m_deltaZ, &m_elapsed, &m_inverseDuration, &m_jumpHeight, &m_slideWeight, &m_outX, &m_outY, &m_outZ, &m_fraction})
+        {
+            values->push_back(0.f);
+        }
+    }
+    m_fromX[index]           = from.x;
+    m_fromY[index]           = from.y;
+    m_fromZ[index]           = from.z;
+    m_deltaX[index]          = to.x - from.x;
+    m_deltaY[index]          = to.y - from.y;
+    m_deltaZ[index]          = to.z - from.z;
+    m_elapsed[index]         = 0.f;
+    m_inverseDuration[index] = durationSeconds > 0.f ? 1.f / durationSeconds : 1e30f; // Done on the next update
+    m_jumpHeight[index]      = jumpHeight;
+    m_slideWeight[index]     = jumpHeight == 0.f ? 1.f : 0.f;
+}
+
+void PieceAnimationSystem::Stop(Actor* actor)
+{
+    int index = Find(actor);
+    if (index >= 0)
+    {
+        RemoveAt(index);
+    }
+}
+
+void PieceAnimationSystem::Clear()
+{
+    while (GetActiveCount() > 0)
+    {
+        RemoveAt(GetActiveCount() - 1);
+    }
+}
+
+void PieceAnimationSystem::Update(float deltaSeconds)
+{
+    int count = GetActiveCount();
+    if (count == 0) return;
+
+    int simdEnd = 0;
+#if PIECE_ANIMATION_SSE
+    if (m_simdEnabled)
+    {
+        simdEnd = count & ~3;
+        EvaluateSimd(0, simdEnd, deltaSeconds);
+    }
+#endif
+    EvaluateScalar(simdEnd, count, deltaSeconds);
+
+    // Backwards, a finished tween pulls in the last one which was already written
+    for (int i = count - 1; i >= 0; --i)
+    {
+        Actor* actor = m_actors[i];
+        if (m_fraction[i] >= 1.f)
+        {
+            actor->m_position = Vec3(m_fromX[i] + m_deltaX[i], m_fromY[i] + m_deltaY[i], m_fromZ[i] + m_deltaZ[i]);
+            RemoveAt(i);
+            continue;
+        }
+        actor->m_position = Vec3(m_outX[i], m_outY[i], m_outZ[i]);
+    }
+}
+
+int PieceAnimationSystem::Find(const Actor* actor) const
+{
+    for (int i = 0; i < GetActiveCount(); ++i)
+    {
+        if (m_actors[i] == actor) return i;
+    }
+    return -1;
+}
+
+void PieceAnimationSystem::RemoveAt(int index)
+{
+    m_actors[index] = m_actors.back();
+    m_actors.pop_back();
+    for (std::vector<float>* values : {&m_fromX, &m_fromY, &m_fromZ, &m_deltaX, &m_deltaY, &m_deltaZ, &m_elapsed, &m_inverseDuration, &m_jumpHeight, &m_slideWeight, &m_outX, &m_outY, &m_outZ, &m_fraction})
+    {
+        (*values)[index] = values->back();
+        values->pop_back();
+    }
+}
+
+void PieceAnimationSystem::EvaluateScalar(int begin, int end, float deltaSeconds)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        m_elapsed[i] += deltaSeconds;
+        float fraction = m_elapsed[i] * m_inverseDuration[i];
+        fraction       = fraction < 1.f ? fraction : 1.f;
+        float eased    = Interpolate(SmoothStop2(fraction), Hesitate3(fraction), m_slideWeight[i]);
+        float parabola = 4.f * fraction * (1.f - fraction); // 0 -> 1 -> 0, the peak at half way
+
+        m_fraction[i] = fraction;
+        m_outX[i]     = m_fromX[i] + m_deltaX[i] * eased;
+        m_outY[i]     = m_fromY[i] + m_deltaY[i] * eased;
+        m_outZ[i]     = m_fromZ[i] + m_deltaZ[i] * eased + m_jumpHeight[i] * parabola;
+    }
+}
+
+void PieceAnimationSystem::EvaluateSimd(int begin, int end, float deltaSeconds)
+{
+#if PIECE_ANIMATION_SSE
+    // The same polynomials as the Engine easing functions, Hesitate3 = 3t(1-t)^2 + t^3 and SmoothStop2 = 1 - (1-t)^2
+    const __m128 one   = _mm_set1_ps(1.f);
+    const __m128 three = _mm_set1_ps(3.f);
+    const __m128 four  = _mm_set1_ps(4.f);
+    const __m128 delta = _mm_set1_ps(deltaSeconds);
+    for (int i = begin; i < end; i += 4)
+    {
+        __m128 elapsed = _mm_add_ps(_mm_loadu_ps(&m_elapsed[i]), delta);
+        _mm_storeu_ps(&m_elapsed[i], elapsed);
+
+        __m128 t       = _mm_min_ps(_mm_mul_ps(elapsed, _mm_loadu_ps(&m_inverseDuration[i])), one);
+        __m128 u       = _mm_sub_ps(one, t);
+        __m128 hes     = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(three, t), _mm_mul_ps(u, u)), _mm_mul_ps(_mm_mul_ps(t, t), t));
+        __m128 stop    = _mm_sub_ps(one, _mm_mul_ps(u, u));
+        __m128 eased   = _mm_add_ps(stop, _mm_mul_ps(_mm_loadu_ps(&m_slideWeight[i]), _mm_sub_ps(hes, stop)));
+        __m128 arc     = _mm_mul_ps(_mm_mul_ps(four, t), u);
+        __m128 offsetZ = _mm_mul_ps(_mm_loadu_ps(&m_jumpHeight[i]), arc);
+
+        _mm_storeu_ps(&m_fraction[i], t);
+        _mm_storeu_ps(&m_outX[i], _mm_add_ps(_mm_loadu_ps(&m_fromX[i]), _mm_mul_ps(_mm_loadu_ps(&m_deltaX[i]), eased)));
+        _mm_storeu_ps(&m_outY[i], _mm_add_ps(_mm_loadu_ps(&m_fromY[i]), _mm_mul_ps(_mm_loadu_ps(&m_deltaY[i]), eased)));
+        _mm_storeu_ps(&m_outZ[i], _mm_add_ps(_mm_add_ps(_mm_loadu_ps(&m_fromZ[i]), _mm_mul_ps(_mm_loadu_ps(&m_deltaZ[i]), eased)), offsetZ));
+    }
+#else
+    EvaluateScalar(begin, end, deltaSeconds);
+#endif
+}
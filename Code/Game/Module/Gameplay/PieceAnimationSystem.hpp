@@ -0,0 +1,46 @@
+﻿#pragma once
+#include <vector>
+
+#include "Engine/Math/Vec3.hpp"
+
+class Actor;
+
+/// PieceAnimationSystem ― The move tweens of a match. Only running tweens are stored, packed in parallel arrays that
+/// Update advances and eases four at a time with SSE, then writes the positions back and drops the finished ones.
+/// Slides ease with Hesitate3, jumps with SmoothStop2 and a parabola of jumpHeight on top.
+class PieceAnimationSystem
+{
+public:
+    /// Replaces the running tween of the actor, jumpHeight 0 is a slide
+    void Play(Actor* actor, const Vec3& from, const Vec3& to, float durationSeconds, float jumpHeight);
+    void Stop(Actor* actor); // Leaves the actor where it is
+    void Clear();
+    void Update(float deltaSeconds);
+
+    bool IsAnimating(const Actor* actor) const { return Find(actor) >= 0; }
+    int  GetActiveCount() const { return static_cast<int>(m_actors.size()); }
+    void SetSimdEnabled(bool enabled) { m_simdEnabled = enabled; } // The scalar pass is the reference, for benchmarks
+
+private:
+    std::vector<Actor*> m_actors;
+    std::vector<float>  m_fromX;
+    std::vector<float>  m_fromY;
+    std::vector<float>  m_fromZ;
+    std::vector<float>  m_deltaX; // to - from
+    std::vector<float>  m_deltaY;
+    std::vector<float>  m_deltaZ;
+    std::vector<float>  m_elapsed;
+    std::vector<float>  m_inverseDuration;
+    std::vector<float>  m_jumpHeight;
+    std::vector<float>  m_slideWeight; // 1 eases with Hesitate3, 0 with SmoothStop2
+    std::vector<float>  m_outX; // Written by the evaluation, scattered to the actors afterwards
+    std::vector<float>  m_outY;
+    std::vector<float>  m_outZ;
+    std::vector<float>  m_fraction;
+    bool                m_simdEnabled = true;
+
+    int  Find(const Actor* actor) const;
+    void RemoveAt(int index); // Swap and pop over every array
+    void EvaluateScalar(int begin, int end, float deltaSeconds);
+    void EvaluateSimd(int begin, int end, float deltaSeconds); // end - begin a multiple of 4
+};
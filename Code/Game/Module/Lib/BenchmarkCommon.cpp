@@ -0,0 +1,1386 @@
+﻿#include "BenchmarkCommon.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "ChessMatchCommon.hpp"
+#include "CommandArgs.hpp"
+#include "ScriptFile.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Player.hpp"
+#include "Game/Core/AllocationTracker.hpp"
+#include "Game/Core/EventChannel.hpp"
+#include "Game/Core/JobSystem.hpp"
+#include "Game/Core/LoggerSubsystem.hpp"
+#include "Game/Core/ObjectArena.hpp"
+#include "Game/Core/Actor/AABB3Packets.hpp"
+#include "Game/Core/Actor/Actor.hpp"
+#include "Game/Core/Actor/EntityRegistry.hpp"
+#include "Game/Core/Actor/TransformPool.hpp"
+#include "Game/Core/Component/CollisionComponent.hpp"
+#include "Game/Core/Component/Component.hpp"
+#include "Game/Core/Component/MeshComponent.hpp"
+#include "Game/Core/Network/LoopbackTransport.hpp"
+#include "Game/Core/Network/MessageCodec.hpp"
+#include "Game/Core/Network/NetworkDispatcher.hpp"
+#include "Game/Core/Network/NetworkSimulation.hpp"
+#include "Game/Core/Render/BakedModel.hpp"
+#include "Game/Core/Render/Renderable.hpp"
+#include "Game/Module/Definition/ChessPieceDefinition.hpp"
+#include "Game/Module/Gameplay/ChessMatch.hpp"
+#include "Game/Module/Gameplay/ChessRules.hpp"
+#include "Game/Module/Gameplay/PickingGrid.hpp"
+#include "Game/Module/Gameplay/PieceAnimationSystem.hpp"
+#include "Game/Module/Model/BakedModelBishop.hpp"
+#include "Game/Module/Model/BakedModelKnight.hpp"
+#include "Game/Module/Model/BakeModelChessBoard.hpp"
+#include "Game/Module/Model/BakeModelKing.hpp"
+#include "Game/Module/Model/BakeModelPawn.hpp"
+#include "Game/Module/Model/BakeModelQueen.hpp"
+#include "Game/Module/Model/BakeModelRook.hpp"
+#include "Game/Module/Test/TestModelActor.hpp"
+
+namespace
+{
+    struct BenchmarkEntry
+    {
+        const char*                    m_name;
+        BenchmarkCommon::BenchmarkFunc m_func;
+    };
+
+    const BenchmarkEntry BENCHMARKS[] = {
+        {"actorTick", BenchmarkCommon::Benchmark_ActorTick},
+        {"animation", BenchmarkCommon::Benchmark_Animation},
+        {"arena", BenchmarkCommon::Benchmark_Arena},
+        {"casts", BenchmarkCommon::Benchmark_Casts},
+        {"components", BenchmarkCommon::Benchmark_Components},
+        {"compression", BenchmarkCommon::Benchmark_Compression},
+        {"entities", BenchmarkCommon::Benchmark_Entities},
+        {"events", BenchmarkCommon::Benchmark_Events},
+        {"framing", BenchmarkCommon::Benchmark_Framing},
+        {"jobs", BenchmarkCommon::Benchmark_Jobs},
+        {"logging", BenchmarkCommon::Benchmark_Logging},
+        {"models", BenchmarkCommon::Benchmark_Models},
+        {"moves", BenchmarkCommon::Benchmark_Moves},
+        {"parsing", BenchmarkCommon::Benchmark_Parsing},
+        {"picking", BenchmarkCommon::Benchmark_Picking},
+        {"rayBox", BenchmarkCommon::Benchmark_RayBox},
+        {"raycast", BenchmarkCommon::Benchmark_Raycast},
+        {"transforms", BenchmarkCommon::Benchmark_Transforms},
+    };
+
+    /// Distinct component types for the lookup benchmark, never attached outside of it
+    template <int N>
+    class BenchmarkComponent final : public IComponent
+    {
+        COMPONENT_CLASS(BenchmarkComponent<N>)
+
+        IComponent* FromXML(const XmlElement& xmlElement) override
+        {
+            UNUSED(xmlElement)
+            return this;
+        }
+
+        XmlElement* ToXML() const override { return nullptr; }
+    };
+
+    template <int... N>
+    void AddBenchmarkComponents(Actor& actor, int count, std::integer_sequence<int, N...>)
+    {
+        ((N < count ? static_cast<void>(actor.AddComponent<BenchmarkComponent<N>>()) : static_cast<void>(0)), ...);
+    }
+
+    /// A component that renders, the way MeshComponent and CollisionComponent are registered
+    class BenchmarkRenderComponent final : public IComponent, public IRenderable
+    {
+        COMPONENT_CLASS(BenchmarkRenderComponent)
+
+        BenchmarkRenderComponent() { m_owningComponent = this; }
+
+        void Render(const RenderContext& ctx) override { UNUSED(ctx) }
+
+        IComponent* FromXML(const XmlElement& xmlElement) override
+        {
+            UNUSED(xmlElement)
+            return this;
+        }
+
+        XmlElement* ToXML() const override { return nullptr; }
+    };
+
+    class BenchmarkRenderable final : public IRenderable
+    {
+    public:
+        void Render(const RenderContext& ctx) override { UNUSED(ctx) }
+    };
+
+    /// Stand in for an animating ChessPiece, the same easing work without a MeshComponent registered for rendering
+    class BenchmarkAnimatedActor final : public Actor
+    {
+    public:
+        explicit BenchmarkAnimatedActor(int index)
+        {
+            m_from    = Vec3(static_cast<float>(index % 64), static_cast<float>(index / 64), 0.f);
+            m_to      = m_from + Vec3(1.f, 2.f, 0.f);
+            m_elapsed = static_cast<float>(index % 16) * 0.05f;
+        }
+
+        void OnTick(float deltaTime) override
+        {
+            m_elapsed += deltaTime;
+            float fraction = m_elapsed - static_cast<float>(static_cast<int>(m_elapsed)); // Loops every second
+            for (int step = 0; step < 8; ++step) // A slide and a jump sample per step, like the piece callbacks
+            {
+                float eased  = Hesitate3(fraction);
+                m_position   = Interpolate(m_from, m_to, eased);
+                m_position.z = 4.f * fraction * (1.f - fraction) * SmoothStop2(eased);
+                fraction     = fraction * 0.999f;
+            }
+        }
+
+    private:
+        Vec3  m_from;
+        Vec3  m_to;
+        float m_elapsed = 0.f;
+    };
+
+    using ModelFactory = BakedModel* (*)();
+
+    const ModelFactory MODEL_FACTORIES[] = {
+        []() -> BakedModel* { return new BakeModelQueen(); },
+        []() -> BakedModel* { return new BakeModelKing(); },
+        []() -> BakedModel* { return new BakeModelRook(); },
+        []() -> BakedModel* { return new BakedModelBishop(); },
+        []() -> BakedModel* { return new BakedModelKnight(); },
+        []() -> BakedModel* { return new BakeModelPawn(); },
+        []() -> BakedModel* { return new BakeModelChessBoard(); },
+    };
+
+    /// Value of "key": in the object starting at from, a quoted string or a number
+    bool ReadJsonField(const std::string& text, size_t from, size_t to, const char* key, std::string& outValue)
+    {
+        std::string pattern = std::string("\"") + key + "\":";
+        size_t      start   = text.find(pattern, from);
+        if (start == std::string::npos || start >= to)
+        {
+            return false;
+        }
+        start += pattern.size();
+        if (text[start] == '"')
+        {
+            size_t end = text.find('"', start + 1);
+            if (end == std::string::npos) return false;
+            outValue = text.substr(start + 1, end - start - 1);
+            return true;
+        }
+        size_t end = text.find_first_of(",}", start);
+        outValue   = text.substr(start, end - start);
+        return true;
+    }
+
+    /// The data driven part of ChessMatch setup, every ChessPiece of the match config is resolved and logged the way
+    /// ChessMatch::AddChessPieceToMatch does it, without spawning actors. CompiledIn false is what a stripped LOG leaves.
+    template <bool CompiledIn>
+    int ReplayMatchSetup(const XmlElement& chessPiecesElement)
+    {
+        int checksum = 0;
+        for (const XmlElement* element = chessPiecesElement.FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+        {
+            std::string           position   = ParseXmlAttribute(*element, "position", std::string());
+            ChessPieceDefinition* definition = ChessPieceDefinition::GetByName(ParseXmlAttribute(*element, "name", std::string()));
+            IntVec2               gridPos    = ChessMatchCommon::GetGridPosition(position);
+            Vec2                  worldPos(static_cast<float>(gridPos.x) + 0.5f, static_cast<float>(gridPos.y) + 0.5f);
+            checksum += gridPos.x + gridPos.y * 8;
+            LOG_IF_COMPILED(CompiledIn && LogIsCompiledIn(ELogCategory::LogGame, ELogVerbosity::Info), LogGame, Info,
+                            "Add Chess piece [ %s ]      to [ %s ] / grid = [ %d, %d ] world = [ %.2f, %.2f ]",
+                            definition ? definition->m_name.c_str() : "?", position.c_str(), gridPos.x, gridPos.y, worldPos.x, worldPos.y);
+        }
+        return checksum;
+    }
+
+    /// Deterministic pseudo random numbers so every run compresses the very same payloads
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+
+    std::string SquareName(uint32_t index)
+    {
+        return std::string(1, static_cast<char>('a' + index % 8)) + static_cast<char>('1' + index / 8 % 8);
+    }
+
+    std::string MakeMoveMessage()
+    {
+        return "ChessMove from=e2 to=e4 ack=42 id=3735928559";
+    }
+
+    std::string MakeSnapshotMessage()
+    {
+        static const char* BACK_RANK = "RNBQKBNR";
+
+        std::string snapshot = "ChessSnapshot turn=24 current=1 player0=Alice player1=Bob castle=KQkq enpassant=none board=";
+        for (int rank = 0; rank < 8; ++rank)
+        {
+            for (int file = 0; file < 8; ++file)
+            {
+                char piece = '.';
+                if (rank == 0 || rank == 7) piece = BACK_RANK[file];
+                if (rank == 1 || rank == 6) piece = 'P';
+                if (rank >= 6 && piece != '.') piece = static_cast<char>(piece - 'A' + 'a');
+                snapshot += Stringf("%s:%c:%d,", SquareName(static_cast<uint32_t>(rank * 8 + file)).c_str(), piece, piece == '.' ? 0 : 1);
+            }
+        }
+        snapshot += " history=";
+        uint32_t state = 7;
+        for (int ply = 0; ply < 48; ++ply)
+        {
+            snapshot += SquareName(NextRandom(state) % 64) + SquareName(NextRandom(state) % 64) + (ply % 2 == 0 ? "," : ";");
+        }
+        return snapshot;
+    }
+
+    std::string MakePgnMessage()
+    {
+        static const char* MOVES[] = {
+            "e4", "e5", "Nf3", "Nc6", "Bb5", "a6", "Ba4", "Nf6", "O-O", "Be7", "Re1", "b5", "Bb3", "d6", "c3", "O-O",
+            "h3", "Nb8", "d4", "Nbd7", "c4", "c6", "cxb5", "axb5", "Nc3", "Bb7", "Bg5", "b4", "Nb1", "h6", "Bh4", "c5",
+            "dxe5", "Nxe4", "Bxe7", "Qxe7", "exd6", "Qf6", "Nbd2", "Nxd6", "Nc4", "Nxc4", "Bxc4", "Nb6", "Ne5", "Rae8", "Bxf7+", "Rxf7"
+        };
+
+        std::string pgn = "ChessPgn [Event \"Casual Game\"] [Site \"EnigmaChess\"] [Date \"2025.01.01\"] [Round \"1\"] [White \"Alice\"] [Black \"Bob\"] [Result \"*\"] ";
+        constexpr int MOVE_COUNT = static_cast<int>(sizeof(MOVES) / sizeof(MOVES[0]));
+        for (int ply = 0; ply < MOVE_COUNT * 2; ++ply)
+        {
+            if (ply % 2 == 0) pgn += Stringf("%d. ", ply / 2 + 1);
+            pgn += MOVES[ply % MOVE_COUNT];
+            pgn += ' ';
+        }
+        return pgn + "*";
+    }
+
+    std::string MakeAnalysisMessage()
+    {
+        std::string analysis = "ChessAnalysis";
+        uint32_t    state    = 11;
+        for (int depth = 18; depth <= 22; ++depth)
+        {
+            for (int pv = 1; pv <= 4; ++pv)
+            {
+                analysis += Stringf(" |info depth %d seldepth %d multipv %d score cp %d nodes %u nps %u time %u pv", depth, depth + 9, pv,
+                                    static_cast<int>(NextRandom(state) % 80) - 20, NextRandom(state) % 5000000, 1500000 + NextRandom(state) % 500000, NextRandom(state) % 3000);
+                for (int ply = 0; ply < 14; ++ply)
+                {
+                    analysis += " " + SquareName(NextRandom(state) % 64) + SquareName(NextRandom(state) % 64);
+                }
+            }
+        }
+        return analysis;
+    }
+
+    /// The argument lookup ChessMove used before CommandArgs, every key re-split the whole string
+    int LegacyGetCommandArgsWith(const std::string& arg, const std::string& key, std::pair<std::string, std::string>& pair)
+    {
+        Strings args = SplitStringOnDelimiter(arg, ' ');
+        for (int i = 0; i < static_cast<int>(args.size()); i++)
+        {
+            Strings keyValue = SplitStringOnDelimiter(args[i], '=');
+            if (keyValue.size() != 2)
+            {
+                return -1;
+            }
+            if (Common::ToUpper(keyValue[0]) == Common::ToUpper(key))
+            {
+                pair.first  = Common::ToUpper(keyValue[0]);
+                pair.second = Common::ToUpper(keyValue[1]);
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    ChessPieceDefinition* LegacyGetByName(const std::string& name)
+    {
+        for (auto& definition : ChessPieceDefinition::s_definitions)
+        {
+            if (Common::ToLower(definition.m_name) == Common::ToLower(name))
+                return &definition;
+        }
+        return nullptr;
+    }
+}
+
+double BenchmarkCommon::GetTimeSeconds()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void BenchmarkCommon::Benchmark_Compression(BenchmarkResults& results)
+{
+    struct MessageClass
+    {
+        const char* m_name;
+        std::string m_payload;
+    };
+
+    MessageClass classes[] = {
+        {"move", MakeMoveMessage()},
+        {"snapshot", MakeSnapshotMessage()},
+        {"pgn", MakePgnMessage()},
+        {"analysis", MakeAnalysisMessage()},
+    };
+
+    MessageCodec codec;
+    std::string  frame;
+    std::string  decoded;
+
+    for (MessageClass& messageClass : classes)
+    {
+        std::string caseName = std::string("compression/") + messageClass.m_name;
+        double      rawBytes = static_cast<double>(messageClass.m_payload.size());
+
+        bool   compressed    = codec.Encode(messageClass.m_payload, '\0', frame);
+        double encodeSeconds = MeasureSecondsPerCall([&]() { codec.Encode(messageClass.m_payload, '\0', frame); });
+        double wireBytes     = rawBytes;
+        double decodeSeconds = 0.0;
+        if (compressed)
+        {
+            wireBytes = static_cast<double>(frame.size());
+            if (!codec.Decode(frame, decoded) || decoded != messageClass.m_payload)
+            {
+                g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Benchmark %s failed the round trip", caseName.c_str()));
+            }
+            decodeSeconds = MeasureSecondsPerCall([&]() { codec.Decode(frame, decoded); });
+        }
+
+        results.push_back({caseName, "rawBytes", rawBytes, "B"});
+        results.push_back({caseName, "wireBytes", wireBytes, "B"});
+        results.push_back({caseName, "saved", (1.0 - wireBytes / rawBytes) * 100.0, "%"});
+        results.push_back({caseName, "encode", encodeSeconds * 1e6, "us"});
+        results.push_back({caseName, "encodeThroughput", rawBytes / encodeSeconds / (1024.0 * 1024.0), "MB/s"});
+        results.push_back({caseName, "decode", decodeSeconds * 1e6, "us"});
+        if (decodeSeconds > 0.0)
+        {
+            results.push_back({caseName, "decodeThroughput", rawBytes / decodeSeconds / (1024.0 * 1024.0), "MB/s"});
+        }
+        // CPU spent for every byte kept off the wire, the number to weigh against the link bandwidth
+        if (wireBytes < rawBytes)
+        {
+            results.push_back({caseName, "costPerSavedByte", (encodeSeconds + decodeSeconds) * 1e9 / (rawBytes - wireBytes), "ns/B"});
+        }
+    }
+}
+
+void BenchmarkCommon::Benchmark_Parsing(BenchmarkResults& results)
+{
+    static const char* KEYS[] = {"remote", "from", "to", "teleport", "promoteTo"};
+
+    std::vector<std::string> scriptLines;
+    if (!LoadScriptLines("Data/Scripts/chess_example.js", scriptLines) || scriptLines.empty())
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Benchmark parsing could not load Data/Scripts/chess_example.js");
+        return;
+    }
+
+    // Handlers only ever see what follows the command name
+    std::vector<std::string> commandArgs;
+    for (const std::string& line : scriptLines)
+    {
+        size_t space = line.find(' ');
+        commandArgs.push_back(space == std::string::npos ? std::string() : line.substr(space + 1));
+    }
+
+    std::pair<std::string, std::string> pair;
+    std::string                         outMessage;
+    int                                 checksum = 0;
+
+    double legacySeconds = MeasureSecondsPerCall([&]()
+    {
+        for (const std::string& arg : commandArgs)
+        {
+            for (const char* key : KEYS)
+            {
+                checksum += LegacyGetCommandArgsWith(arg, key, pair);
+            }
+            if (LegacyGetCommandArgsWith(arg, "promoteTo", pair) != -1 && LegacyGetByName(pair.second)) ++checksum;
+        }
+    });
+
+    double fastSeconds = MeasureSecondsPerCall([&]()
+    {
+        for (const std::string& arg : commandArgs)
+        {
+            CommandArgs parsed(arg);
+            for (const char* key : KEYS)
+            {
+                checksum += ChessMatchCommon::GetCommandArgsWith(parsed, key, pair, outMessage);
+            }
+            if (parsed.Has("promoteTo") && ChessPieceDefinition::GetByName(std::string(parsed.Get("promoteTo")))) ++checksum;
+        }
+    });
+
+    // Both paths must agree on every key of every line before their timings mean anything
+    for (const std::string& arg : commandArgs)
+    {
+        CommandArgs parsed(arg);
+        for (const char* key : KEYS)
+        {
+            std::pair<std::string, std::string> legacyPair;
+            std::pair<std::string, std::string> fastPair;
+            if (LegacyGetCommandArgsWith(arg, key, legacyPair) != ChessMatchCommon::GetCommandArgsWith(parsed, key, fastPair, outMessage) ||
+                legacyPair.second != fastPair.second)
+            {
+                g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Benchmark parsing mismatch on \"%s\" key %s", arg.c_str(), key));
+            }
+        }
+    }
+
+    double commandCount = static_cast<double>(commandArgs.size());
+    results.push_back({"parsing/chessMove", "commands", commandCount, ""});
+    results.push_back({"parsing/chessMove", "legacy", legacySeconds * 1e9 / commandCount, "ns/cmd"});
+    results.push_back({"parsing/chessMove", "commandArgs", fastSeconds * 1e9 / commandCount, "ns/cmd"});
+    results.push_back({"parsing/chessMove", "speedup", legacySeconds / fastSeconds, "x"});
+    results.push_back({"parsing/chessMove", "checksum", static_cast<double>(checksum % 1000), ""}); // Keeps the loops observable
+}
+
+void BenchmarkCommon::Benchmark_Logging(BenchmarkResults& results)
+{
+    XmlElement*       root          = g_theGame->m_chessMatchConfig.RootElement();
+    const XmlElement* boardElement  = root ? FindChildElementByName(*root, "ChessBoard") : nullptr;
+    const XmlElement* piecesElement = boardElement ? FindChildElementByName(*boardElement, "ChessPieces") : nullptr;
+    if (!piecesElement)
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Benchmark logging needs the ChessPieces of the match config");
+        return;
+    }
+
+    uint32_t savedMask = g_theLoggerSubsystem->GetCategoryMask();
+    int      checksum  = 0;
+
+    // Every iteration prints the whole setup, a few are enough
+    g_theLoggerSubsystem->EnableCategory(ELogCategory::LogGame);
+    double onSeconds = MeasureSecondsPerCall([&]() { checksum += ReplayMatchSetup<true>(*piecesElement); }, 0.0, 4);
+    g_theLoggerSubsystem->Flush();
+
+    // Cost of one LOG call on the game thread, formatting and the hand off to the writer
+    constexpr int LOG_CALLS = 32;
+    g_theLoggerSubsystem->EnableCategory(ELogCategory::LogTemp);
+    double submitSeconds = MeasureSecondsPerCall([&]()
+    {
+        for (int i = 0; i < LOG_CALLS; ++i)
+        {
+            LOG(LogTemp, Info, "Benchmark log line %d of %d", i, LOG_CALLS);
+        }
+    }, 0.0, 4);
+    g_theLoggerSubsystem->Flush();
+
+    g_theLoggerSubsystem->DisableCategory(ELogCategory::LogGame);
+    double offSeconds      = MeasureSecondsPerCall([&]() { checksum += ReplayMatchSetup<true>(*piecesElement); });
+    double strippedSeconds = MeasureSecondsPerCall([&]() { checksum += ReplayMatchSetup<false>(*piecesElement); });
+    g_theLoggerSubsystem->SetCategoryMask(savedMask);
+
+    results.push_back({"logging/matchSetup", "compiledIn", LogIsCompiledIn(ELogCategory::LogGame, ELogVerbosity::Info) ? 1.0 : 0.0, ""});
+    results.push_back({"logging/matchSetup", "on", onSeconds * 1e6, "us"});
+    results.push_back({"logging/matchSetup", "offAtRuntime", offSeconds * 1e6, "us"});
+    results.push_back({"logging/matchSetup", "stripped", strippedSeconds * 1e6, "us"});
+    results.push_back({"logging/matchSetup", "checksum", static_cast<double>(checksum % 1000), ""});
+    results.push_back({"logging/log", "submit", submitSeconds * 1e9 / LOG_CALLS, "ns/call"});
+}
+
+void BenchmarkCommon::Benchmark_Components(BenchmarkResults& results)
+{
+    constexpr int ACTORS   = 1024;
+    const int     counts[] = {1, 4, 16};
+    for (int count : counts)
+    {
+        std::vector<std::unique_ptr<Actor>> actors;
+        actors.reserve(ACTORS);
+        for (int i = 0; i < ACTORS; ++i)
+        {
+            actors.push_back(std::make_unique<Actor>());
+            AddBenchmarkComponents(*actors.back(), count, std::make_integer_sequence<int, 16>());
+        }
+
+        // The first type is the front of the list, the 16th is the end of it or missing, a scan would pay for it
+        int    found   = 0;
+        double seconds = MeasureSecondsPerCall([&]()
+        {
+            for (const std::unique_ptr<Actor>& actor : actors)
+            {
+                found += actor->GetComponent<BenchmarkComponent<0>>() != nullptr;
+                found += actor->GetComponent<BenchmarkComponent<15>>() != nullptr;
+                found += actor->HasComponent<CollisionComponent>();
+            }
+        });
+
+        std::string caseName = Stringf("components/%d", count);
+        results.push_back({caseName, "lookup", seconds * 1e9 / (ACTORS * 3), "ns"});
+        results.push_back({caseName, "found", static_cast<double>(found % 1000), ""}); // Keeps the loop observable
+    }
+}
+
+void BenchmarkCommon::Benchmark_Arena(BenchmarkResults& results)
+{
+    constexpr int PIECES  = 32;
+    constexpr int MATCHES = 64; // Per measured call, a dedicated server churns through many
+    const bool    modes[] = {false, true};
+    for (bool pooled : modes)
+    {
+        std::vector<Actor*> actors;
+        actors.reserve(PIECES);
+        uint64_t allocations = 0;
+        double   seconds     = MeasureSecondsPerCall([&]()
+        {
+            AllocationScope scope;
+            for (int match = 0; match < MATCHES; ++match)
+            {
+                // The actor lifetime of a ChessMatch, three components per piece like a ChessPiece
+                ObjectArena arena;
+                {
+                    std::optional<ObjectArena::Scope> arenaScope;
+                    if (pooled) arenaScope.emplace(arena);
+                    for (int i = 0; i < PIECES; ++i)
+                    {
+                        actors.push_back(new Actor());
+                        AddBenchmarkComponents(*actors.back(), 3, std::make_integer_sequence<int, 16>());
+                    }
+                }
+                for (Actor* actor : actors)
+                {
+                    delete actor;
+                }
+                actors.clear();
+            }
+            allocations = scope.GetAllocationCount();
+        });
+
+        std::string caseName = pooled ? "arena/pooled" : "arena/heap";
+        results.push_back({caseName, "match", seconds * 1e6 / MATCHES, "us"});
+        results.push_back({caseName, "allocs", static_cast<double>(allocations) / MATCHES, "allocs"});
+    }
+}
+
+void BenchmarkCommon::Benchmark_Casts(BenchmarkResults& results)
+{
+    constexpr int COUNT = 4096;
+
+    // Every fourth actor is a TestModelActor, never initialized so it owns no components
+    std::vector<std::unique_ptr<Actor>> actors;
+    actors.reserve(COUNT);
+    for (int i = 0; i < COUNT; ++i)
+    {
+        actors.push_back(i % 4 == 0 ? std::make_unique<TestModelActor>() : std::make_unique<Actor>());
+    }
+
+    int    found          = 0;
+    double dynamicSeconds = MeasureSecondsPerCall([&]()
+    {
+        for (const std::unique_ptr<Actor>& actor : actors)
+        {
+            found += dynamic_cast<TestModelActor*>(actor.get()) != nullptr;
+        }
+    });
+    double kindSeconds = MeasureSecondsPerCall([&]()
+    {
+        for (const std::unique_ptr<Actor>& actor : actors)
+        {
+            found += ActorCast<TestModelActor>(actor.get()) != nullptr;
+        }
+    });
+    results.push_back({"casts/actor", "dynamicCast", dynamicSeconds * 1e9 / COUNT, "ns"});
+    results.push_back({"casts/actor", "kindTag", kindSeconds * 1e9 / COUNT, "ns"});
+    results.push_back({"casts/actor", "found", static_cast<double>(found % 1000), ""});
+
+    // The render submission filter over components interleaved with standalone renderables, an eighth disabled
+    std::vector<std::unique_ptr<BenchmarkRenderComponent>> components;
+    std::vector<std::unique_ptr<BenchmarkRenderable>>      standalone;
+    std::vector<IRenderable*>                              renderables;
+    renderables.reserve(COUNT);
+    for (int i = 0; i < COUNT; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            components.push_back(std::make_unique<BenchmarkRenderComponent>());
+            components.back()->SetEnable(i % 8 != 0);
+            renderables.push_back(components.back().get());
+        }
+        else
+        {
+            standalone.push_back(std::make_unique<BenchmarkRenderable>());
+            renderables.push_back(standalone.back().get());
+        }
+    }
+
+    int submitted = 0;
+    dynamicSeconds = MeasureSecondsPerCall([&]()
+    {
+        for (IRenderable* r : renderables)
+        {
+            auto comp = dynamic_cast<IComponent*>(r);
+            submitted += !comp || comp->GetEnable();
+        }
+    });
+    double owningSeconds = MeasureSecondsPerCall([&]()
+    {
+        for (IRenderable* r : renderables)
+        {
+            const IComponent* comp = r->GetOwningComponent();
+            submitted += !comp || comp->GetEnable();
+        }
+    });
+    results.push_back({"casts/renderable", "dynamicCast", dynamicSeconds * 1e9 / COUNT, "ns"});
+    results.push_back({"casts/renderable", "owningComponent", owningSeconds * 1e9 / COUNT, "ns"});
+    results.push_back({"casts/renderable", "submitted", static_cast<double>(submitted % 1000), ""});
+}
+
+void BenchmarkCommon::Benchmark_Entities(BenchmarkResults& results)
+{
+    const int counts[] = {4096, 65536};
+    for (int count : counts)
+    {
+        // A spectator scene of boards side by side, every box follows one of a few owners
+        std::vector<std::unique_ptr<Actor>> owners;
+        for (int i = 0; i < 64; ++i)
+        {
+            owners.push_back(std::make_unique<Actor>());
+        }
+        EntityRegistry                      registry;
+        ComponentStorage<CollisionBoxData>& boxes = registry.GetStorage<CollisionBoxData>();
+        boxes.Reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            CollisionBoxData data;
+            data.m_localBox = AABB3(Vec3(-0.3f, -0.3f, 0.f), Vec3(0.3f, 0.3f, 0.8f));
+            data.m_offset   = Vec3(static_cast<float>(i % 256), static_cast<float>(i / 256), 0.f);
+            data.m_owner    = owners[i % owners.size()].get();
+            boxes.Emplace(static_cast<Actor::ActorID>(i), data);
+        }
+
+        double refreshSeconds = MeasureSecondsPerCall([&]()
+        {
+            for (CollisionBoxData& box : boxes)
+            {
+                box.m_worldBox = box.m_localBox;
+                box.m_worldBox.SetCenter(box.m_owner->m_position + box.m_offset);
+            }
+        });
+
+        Vec3   origin(128.f, -8.f, 6.f);
+        Vec3   direction      = (Vec3(128.f, 64.f, 0.f) - origin).GetNormalized();
+        int    hits           = 0;
+        double raycastSeconds = MeasureSecondsPerCall([&]()
+        {
+            for (const CollisionBoxData& box : boxes)
+            {
+                AABB3 worldBox = box.m_worldBox;
+                hits += worldBox.Raycast(origin, direction, 512.f).m_didImpact;
+            }
+        });
+
+        std::string caseName = Stringf("entities/%d", count);
+        results.push_back({caseName, "refresh", refreshSeconds * 1e9 / count, "ns/entity"});
+        results.push_back({caseName, "raycast", raycastSeconds * 1e9 / count, "ns/entity"});
+        results.push_back({caseName, "hits", static_cast<double>(hits % 1000), ""});
+    }
+}
+
+void BenchmarkCommon::Benchmark_Events(BenchmarkResults& results)
+{
+    constexpr int HOLD_FRAMES = 30; // The cursor rests on a square for half a second before it moves on
+
+    // One highlight per frame the old way, an EventArgs with the square as text fired by name
+    int    frame         = 0;
+    auto   squareAt      = [](int index) { return IntVec2(index / HOLD_FRAMES % 8, index / HOLD_FRAMES / 8 % 8); };
+    double stringAllocs  = 0.0;
+    double stringSeconds = MeasureSecondsPerCall([&]()
+    {
+        AllocationScope scope;
+        EventArgs       args;
+        args.SetValue("position", squareAt(frame++).toString());
+        g_theEventSystem->FireEvent("event.benchmark.highlight", args);
+        stringAllocs = static_cast<double>(scope.GetAllocationCount());
+    });
+
+    // The same through a typed channel, fired every frame and edge triggered
+    EventChannel<ChessMatchCommon::HighlightChangedEvent> channel(EEventChannel::HIGHLIGHT_CHANGED);
+    int                                                   delivered = 0;
+    channel.Subscribe([](const ChessMatchCommon::HighlightChangedEvent& event, void* listener)
+    {
+        *static_cast<int*>(listener) += event.m_square.x + 1;
+    }, &delivered);
+
+    double channelAllocs  = 0.0;
+    double channelSeconds = MeasureSecondsPerCall([&]()
+    {
+        AllocationScope                         scope;
+        ChessMatchCommon::HighlightChangedEvent event;
+        event.m_square = squareAt(frame++);
+        channel.Fire(event);
+        channelAllocs = static_cast<double>(scope.GetAllocationCount());
+    });
+    double edgeSeconds = MeasureSecondsPerCall([&]()
+    {
+        ChessMatchCommon::HighlightChangedEvent event;
+        event.m_square = squareAt(frame++);
+        channel.FireOnChange(event);
+    });
+
+    results.push_back({"events/highlight", "string", stringSeconds * 1e9, "ns"});
+    results.push_back({"events/highlight", "stringAllocs", stringAllocs, "allocs"});
+    results.push_back({"events/highlight", "channel", channelSeconds * 1e9, "ns"});
+    results.push_back({"events/highlight", "channelAllocs", channelAllocs, "allocs"});
+    results.push_back({"events/highlight", "edge", edgeSeconds * 1e9, "ns"});
+    results.push_back({"events/highlight", "speedup", stringSeconds / channelSeconds, "x"});
+    results.push_back({"events/highlight", "checksum", static_cast<double>(delivered % 1000), ""});
+}
+
+void BenchmarkCommon::Benchmark_Moves(BenchmarkResults& results)
+{
+    XmlElement* root = g_theGame->m_chessMatchConfig.RootElement();
+    if (!root)
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Benchmark moves needs the match config");
+        return;
+    }
+
+    ChessBoardState      state = ChessBoardState::FromMatchConfig(*root);
+    std::vector<IntVec2> fromSquares;
+    for (int i = 0; i < 64; ++i)
+    {
+        IntVec2 pos(i % 8, i / 8);
+        if (!state.At(pos).IsEmpty()) fromSquares.push_back(pos);
+    }
+
+    int    validMoves = 0;
+    double seconds    = MeasureSecondsPerCall([&]()
+    {
+        validMoves = 0;
+        for (IntVec2 fromPos : fromSquares)
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                if (ChessRules::IsValid(ChessRules::Evaluate(state, fromPos, IntVec2(i % 8, i / 8)).m_moveResult)) ++validMoves;
+            }
+        }
+    });
+
+    double pairs = static_cast<double>(fromSquares.size() * 64);
+    results.push_back({"moves/startPosition", "pairs", pairs, ""});
+    results.push_back({"moves/startPosition", "evaluate", seconds * 1e9 / pairs, "ns/move"});
+    results.push_back({"moves/startPosition", "validMoves", static_cast<double>(validMoves), ""});
+}
+
+void BenchmarkCommon::Benchmark_Picking(BenchmarkResults& results)
+{
+    const int propCounts[] = {0, 1024, 16384};
+    for (int propCount : propCounts)
+    {
+        // The board, the 32 pieces of the starting position and props scattered around the table
+        std::vector<std::unique_ptr<Actor>> owners;
+        ComponentStorage<CollisionBoxData>  boxes;
+        auto                                addBox = [&](const Vec3& mins, const Vec3& maxs)
+        {
+            owners.push_back(std::make_unique<Actor>());
+            CollisionBoxData data;
+            data.m_worldBox = AABB3(mins, maxs);
+            data.m_owner    = owners.back().get();
+            boxes.Emplace(owners.back()->GetID(), data);
+        };
+        addBox(Vec3(0.f, 0.f, -0.5f), Vec3(8.f, 8.f, 0.f));
+        for (int i = 0; i < 32; ++i)
+        {
+            float x = static_cast<float>(i % 8);
+            float y = static_cast<float>(i < 16 ? i / 8 : i / 8 + 4);
+            addBox(Vec3(x + 0.25f, y + 0.25f, 0.f), Vec3(x + 0.75f, y + 0.75f, 1.f));
+        }
+        for (int i = 0; i < propCount; ++i)
+        {
+            float degrees = static_cast<float>(i) * 137.50776f; // Golden angle, an even spiral around the board
+            float radius  = 8.f + 0.02f * static_cast<float>(i % 1024);
+            Vec3  center(4.f + radius * CosDegrees(degrees), 4.f + radius * SinDegrees(degrees), static_cast<float>(i / 1024));
+            addBox(center - Vec3(0.3f, 0.3f, 0.f), center + Vec3(0.3f, 0.3f, 0.6f));
+        }
+        PickingGrid picking;
+        picking.Rebuild(boxes);
+
+        // A camera above the board looking at every square, like ChessMatch::Raycast from the player
+        Vec3              origin(4.f, -4.f, 8.f);
+        std::vector<Vec3> directions;
+        for (int i = 0; i < 64; ++i)
+        {
+            Vec3 target(static_cast<float>(i % 8) + 0.5f, static_cast<float>(i / 8) + 0.5f, 0.f);
+            directions.push_back((target - origin).GetNormalized());
+        }
+
+        int    linearHits    = 0;
+        double linearSeconds = MeasureSecondsPerCall([&]()
+        {
+            for (const Vec3& direction : directions)
+            {
+                float closest = 32.f;
+                bool  hit     = false;
+                for (const CollisionBoxData& box : boxes)
+                {
+                    AABB3           worldBox = box.m_worldBox;
+                    RaycastResult3D result   = worldBox.Raycast(origin, direction, 32.f);
+                    if (result.m_didImpact && result.m_impactDist < closest)
+                    {
+                        closest = result.m_impactDist;
+                        hit     = true;
+                    }
+                }
+                linearHits += hit;
+            }
+        });
+        int    gridHits    = 0;
+        double gridSeconds = MeasureSecondsPerCall([&]()
+        {
+            for (const Vec3& direction : directions)
+            {
+                Actor* owner = nullptr;
+                gridHits += picking.Raycast(boxes, origin, direction, 32.f, owner).m_didImpact;
+            }
+        });
+
+        double      rays     = static_cast<double>(directions.size());
+        std::string caseName = Stringf("picking/%d", static_cast<int>(boxes.Size()));
+        results.push_back({caseName, "linear", linearSeconds * 1e9 / rays, "ns/ray"});
+        results.push_back({caseName, "grid", gridSeconds * 1e9 / rays, "ns/ray"});
+        results.push_back({caseName, "speedup", linearSeconds / gridSeconds, "x"});
+        results.push_back({caseName, "offGrid", static_cast<double>(picking.GetOffGridCount()), ""});
+        results.push_back({caseName, "hits", static_cast<double>((linearHits + gridHits) % 1000), ""});
+    }
+}
+
+void BenchmarkCommon::Benchmark_RayBox(BenchmarkResults& results)
+{
+    constexpr int BOXES = 4096;
+    constexpr int RAYS  = 64;
+
+    // Piece sized boxes over a field of boards, rays from a camera above it
+    std::vector<AABB3> boxes;
+    AABB3Packets       packets;
+    for (int i = 0; i < BOXES; ++i)
+    {
+        Vec3 mins(static_cast<float>(i % 64) + 0.25f, static_cast<float>(i / 64) + 0.25f, 0.f);
+        boxes.emplace_back(mins, mins + Vec3(0.5f, 0.5f, 1.f));
+        packets.Add(boxes.back());
+    }
+    std::vector<Vec3> origins;
+    std::vector<Vec3> directions;
+    for (int i = 0; i < RAYS; ++i)
+    {
+        origins.emplace_back(32.f, -16.f, 24.f);
+        directions.push_back((Vec3(static_cast<float>(i % 8) * 8.f + 0.5f, static_cast<float>(i / 8) * 8.f + 0.5f, 0.f) - origins.back()).GetNormalized());
+    }
+
+    double tests       = static_cast<double>(BOXES) * RAYS;
+    int    checked     = 0;
+    double aabbSeconds = MeasureSecondsPerCall([&]()
+    {
+        for (int ray = 0; ray < RAYS; ++ray)
+        {
+            for (const AABB3& box : boxes)
+            {
+                AABB3 worldBox = box;
+                checked += worldBox.Raycast(origins[ray], directions[ray], 64.f).m_didImpact;
+            }
+        }
+    });
+    results.push_back({"rayBox/oneRayManyBoxes", "aabb3", tests / aabbSeconds * 1e-6, "Mtests/s"});
+
+    // Every kernel the CPU has, the dispatch is put back afterwards
+    const ERaySimdLevel levels[]     = {ERaySimdLevel::SCALAR, ERaySimdLevel::SSE, ERaySimdLevel::AVX};
+    const char*         levelNames[] = {"scalar", "sse", "avx"};
+    ERaySimdLevel       previous     = AABB3Packets::GetSimdLevel();
+    std::vector<float>  distances(BOXES > RAYS ? BOXES : RAYS);
+    for (int level = 0; level < 3; ++level)
+    {
+        if (levels[level] > AABB3Packets::GetSupportedSimdLevel()) break;
+        AABB3Packets::SetSimdLevel(levels[level]);
+
+        double packetSeconds = MeasureSecondsPerCall([&]()
+        {
+            for (int ray = 0; ray < RAYS; ++ray)
+            {
+                packets.Raycast(origins[ray], directions[ray], 64.f, distances.data());
+                checked += distances[ray] != AABB3Packets::MISS;
+            }
+        });
+        double boxSeconds = MeasureSecondsPerCall([&]()
+        {
+            for (const AABB3& box : boxes)
+            {
+                AABB3Packets::RaycastBox(box, origins.data(), directions.data(), RAYS, 64.f, distances.data());
+                checked += distances[0] != AABB3Packets::MISS;
+            }
+        });
+        results.push_back({"rayBox/oneRayManyBoxes", levelNames[level], tests / packetSeconds * 1e-6, "Mtests/s"});
+        results.push_back({"rayBox/manyRaysOneBox", levelNames[level], tests / boxSeconds * 1e-6, "Mtests/s"});
+    }
+    AABB3Packets::SetSimdLevel(previous);
+    results.push_back({"rayBox/oneRayManyBoxes", "checksum", static_cast<double>(checked % 1000), ""});
+}
+
+void BenchmarkCommon::Benchmark_Raycast(BenchmarkResults& results)
+{
+    if (!g_theGame->m_chessMatchConfig.RootElement())
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Benchmark raycast needs the match config");
+        return;
+    }
+
+    // A match of its own in the start position, the headless run has none and a running one would not compare
+    ECameraState cameraState = g_theGame->cameraState;
+    Vec3         position    = g_theGame->m_player->m_position;
+    EulerAngles  orientation = g_theGame->m_player->m_orientation;
+    auto         match       = std::make_unique<ChessMatch>(g_theGame);
+    g_theGame->cameraState             = cameraState;
+    g_theGame->m_player->m_position    = position;
+    g_theGame->m_player->m_orientation = orientation;
+    match->UpdateCollisionBoxes();
+
+    Vec3              origin(4.f, -4.f, 8.f);
+    std::vector<Vec3> directions;
+    for (int i = 0; i < 64; ++i)
+    {
+        Vec3 target(static_cast<float>(i % 8) + 0.5f, static_cast<float>(i / 8) + 0.5f, 0.f);
+        directions.push_back((target - origin).GetNormalized());
+    }
+
+    int    hits    = 0;
+    double seconds = MeasureSecondsPerCall([&]()
+    {
+        hits = 0;
+        for (const Vec3& direction : directions)
+        {
+            if (match->Raycast(origin, direction, 32.f).m_didImpact) ++hits;
+        }
+    });
+
+    double rays = static_cast<double>(directions.size());
+    results.push_back({"raycast/squares", "rays", rays, ""});
+    results.push_back({"raycast/squares", "perRay", seconds * 1e9 / rays, "ns/ray"});
+    results.push_back({"raycast/squares", "hits", static_cast<double>(hits), ""});
+}
+
+void BenchmarkCommon::Benchmark_Framing(BenchmarkResults& results)
+{
+    constexpr int MESSAGES = 256;
+
+    struct FramingCase
+    {
+        const char* m_name;
+        size_t      m_maxReadBytes;
+    };
+
+    const FramingCase cases[] = {
+        {"framing/whole", 0},
+        {"framing/chunked", 7},
+    };
+
+    std::string message = MakeMoveMessage();
+    for (const FramingCase& framingCase : cases)
+    {
+        LoopbackLinkConfig config;
+        config.m_maxReadBytes = framingCase.m_maxReadBytes;
+
+        LoopbackNetwork   network(config);
+        int               received = 0;
+        NetworkDispatcher server(network.GetServer(), [&received](const std::string&) { ++received; });
+        NetworkDispatcher client(network.AddClient(), [](const std::string&) {});
+        server.m_pingIntervalSeconds = 0.0;
+        client.m_pingIntervalSeconds = 0.0;
+
+        double seconds = MeasureSecondsPerCall([&]()
+        {
+            for (int i = 0; i < MESSAGES; ++i)
+            {
+                client.SendToRemote(message);
+            }
+            do
+            {
+                network.Advance(0.0);
+                server.ExecuteRemoteCmd();
+                client.ExecuteRemoteCmd();
+            }
+            while (!network.IsIdle());
+        });
+
+        results.push_back({framingCase.m_name, "message", seconds * 1e9 / MESSAGES, "ns/msg"});
+        results.push_back({framingCase.m_name, "received", static_cast<double>(received), ""});
+    }
+}
+
+void BenchmarkCommon::Benchmark_Models(BenchmarkResults& results)
+{
+    for (ModelFactory factory : MODEL_FACTORIES)
+    {
+        std::unique_ptr<BakedModel> model(factory());
+        model->Build();
+        std::string caseName = "models/" + model->name;
+        double      vertices = static_cast<double>(model->GetVerticesByID().size());
+
+        // Build appends, every iteration bakes a fresh instance
+        double buildSeconds = MeasureSecondsPerCall([&]()
+        {
+            std::unique_ptr<BakedModel> fresh(factory());
+            fresh->Build();
+        }, 0.0, 4);
+        double setModelSeconds = MeasureSecondsPerCall([&]()
+        {
+            MeshComponent mesh;
+            mesh.SetModel(model.get());
+        }, 0.0, 4);
+        double uploadSeconds = MeasureSecondsPerCall([&]()
+        {
+            MeshComponent mesh;
+            mesh.SetModel(model.get());
+            mesh.UploadIfDirty();
+        }, 0.0, 4);
+
+        results.push_back({caseName, "vertices", vertices, ""});
+        results.push_back({caseName, "build", buildSeconds * 1e6, "us"});
+        results.push_back({caseName, "setModel", setModelSeconds * 1e6, "us"});
+        results.push_back({caseName, "upload", (std::max)(uploadSeconds - setModelSeconds, 0.0) * 1e6, "us"});
+    }
+}
+
+void BenchmarkCommon::Benchmark_ActorTick(BenchmarkResults& results)
+{
+    const int counts[] = {256, 4096};
+    for (int count : counts)
+    {
+        // Every other actor owns a child, the depth first walk of Actor::Tick
+        std::vector<std::unique_ptr<Actor>> actors;
+        actors.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            actors.push_back(std::make_unique<Actor>());
+            if (i % 2 == 1) actors.back()->CreateChild();
+        }
+
+        uint64_t allocations = 0;
+        double   seconds     = MeasureSecondsPerCall([&]()
+        {
+            AllocationScope scope;
+            for (const std::unique_ptr<Actor>& actor : actors)
+            {
+                actor->Tick(1.f / 60.f);
+            }
+            allocations = scope.GetAllocationCount();
+        });
+
+        std::string caseName = Stringf("actorTick/%d", count);
+        results.push_back({caseName, "tick", seconds * 1e6, "us"});
+        results.push_back({caseName, "perActor", seconds * 1e9 / count, "ns"});
+        results.push_back({caseName, "allocs", static_cast<double>(allocations), "allocs"});
+    }
+}
+
+void BenchmarkCommon::Benchmark_Animation(BenchmarkResults& results)
+{
+    constexpr int COUNT = 4096; // Every piece of a long replay fast-forwarding at once
+
+    // Half slides and half jumps, long enough that none finishes while measured
+    std::vector<std::unique_ptr<Actor>> actors;
+    PieceAnimationSystem                animations;
+    actors.reserve(COUNT);
+    for (int i = 0; i < COUNT; ++i)
+    {
+        actors.push_back(std::make_unique<Actor>());
+        Vec3 from = Vec3(static_cast<float>(i % 8) + 0.5f, static_cast<float>(i / 8 % 8) + 0.5f, 0.f);
+        animations.Play(actors.back().get(), from, from + Vec3(1.f, 2.f, 0.f), 1e6f, i % 2 == 0 ? 0.f : 1.f);
+    }
+
+    float checksum = 0.f;
+    auto  update   = [&]()
+    {
+        animations.Update(1.f / 60.f);
+        checksum += actors[COUNT / 2]->m_position.z;
+    };
+    animations.SetSimdEnabled(false);
+    double scalarSeconds = MeasureSecondsPerCall(update);
+    animations.SetSimdEnabled(true);
+    double simdSeconds = MeasureSecondsPerCall(update);
+
+    results.push_back({"animation/update", "tweens", COUNT, ""});
+    results.push_back({"animation/update", "scalar", scalarSeconds * 1e9 / COUNT, "ns/tween"});
+    results.push_back({"animation/update", "simd", simdSeconds * 1e9 / COUNT, "ns/tween"});
+    results.push_back({"animation/update", "speedup", scalarSeconds / simdSeconds, "x"});
+    results.push_back({"animation/update", "checksum", static_cast<double>(static_cast<int>(checksum * 1000.f) % 1000), ""});
+}
+
+void BenchmarkCommon::Benchmark_Transforms(BenchmarkResults& results)
+{
+    constexpr int ROOTS       = 2048;
+    constexpr int MOVE_STRIDE = 16; // One root in 16 moves per frame, a few animating pieces on a still board
+
+    // Two identical scenes of parented actors, one read through a TransformPool
+    std::vector<std::unique_ptr<Actor>> scenes[2];
+    TransformPool                       pool;
+    for (int scene = 0; scene < 2; ++scene)
+    {
+        scenes[scene].reserve(ROOTS);
+        for (int i = 0; i < ROOTS; ++i)
+        {
+            scenes[scene].push_back(std::make_unique<Actor>());
+            Actor* root         = scenes[scene].back().get();
+            Actor* child        = root->CreateChild();
+            root->m_position    = Vec3(static_cast<float>(i % 64), static_cast<float>(i / 64), 0.f);
+            root->m_orientation = EulerAngles(static_cast<float>(i % 360), 0.f, 0.f);
+            child->m_position   = Vec3(0.f, 0.f, 0.5f);
+        }
+    }
+    for (const std::unique_ptr<Actor>& root : scenes[1])
+    {
+        pool.Add(root.get());
+    }
+
+    // A frame moves the next slice of roots, then fetches the world matrix of every actor like render submission
+    float checksum    = 0.f;
+    int   frames[2]   = {};
+    auto  moveAndRead = [&](int scene)
+    {
+        int frame = frames[scene]++;
+        for (int i = frame % MOVE_STRIDE; i < ROOTS; i += MOVE_STRIDE)
+        {
+            scenes[scene][i]->m_position.z = static_cast<float>(frame % 100) * 0.01f;
+        }
+        if (scene == 1)
+        {
+            pool.Update();
+        }
+        for (const std::unique_ptr<Actor>& root : scenes[scene])
+        {
+            checksum += root->GetRenderTransform().GetTranslation3D().z;
+            checksum += root->GetChildren()[0]->GetRenderTransform().GetTranslation3D().z;
+        }
+    };
+
+    double rebuildSeconds = MeasureSecondsPerCall([&]() { moveAndRead(0); });
+    double cachedSeconds  = MeasureSecondsPerCall([&]() { moveAndRead(1); });
+
+    results.push_back({"transforms/frame", "rebuild", rebuildSeconds * 1e6, "us"});
+    results.push_back({"transforms/frame", "cached", cachedSeconds * 1e6, "us"});
+    results.push_back({"transforms/frame", "speedup", rebuildSeconds / cachedSeconds, "x"});
+    results.push_back({"transforms/frame", "checksum", static_cast<double>(static_cast<int>(checksum) % 1000), ""});
+}
+
+void BenchmarkCommon::Benchmark_Jobs(BenchmarkResults& results)
+{
+    constexpr int count     = 4096;
+    constexpr int batchSize = 64;
+
+    std::vector<std::unique_ptr<Actor>> actors;
+    actors.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        actors.push_back(std::make_unique<BenchmarkAnimatedActor>(i));
+    }
+
+    double sequentialSeconds = MeasureSecondsPerCall([&]()
+    {
+        for (const std::unique_ptr<Actor>& actor : actors)
+        {
+            actor->Tick(1.f / 60.f);
+        }
+    });
+    results.push_back({"jobs/sequential", "tick", sequentialSeconds * 1e6, "us"});
+
+    // Private pools so the run does not depend on the worker count of g_theJobSystem
+    int hardwareThreads = (std::max)(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    for (int threads = 1; threads <= hardwareThreads; threads *= 2)
+    {
+        JobSystemConfig config;
+        config.m_workerCount = threads - 1; // The calling thread works while it waits
+        config.m_threadName  = "";
+        JobSystem jobSystem(config);
+        jobSystem.Startup();
+
+        double seconds = MeasureSecondsPerCall([&]()
+        {
+            jobSystem.ParallelFor(count, batchSize, [&actors](int index) { actors[index]->Tick(1.f / 60.f); });
+        });
+        jobSystem.Shutdown();
+
+        std::string caseName = Stringf("jobs/%dthreads", threads);
+        results.push_back({caseName, "tick", seconds * 1e6, "us"});
+        results.push_back({caseName, "speedup", sequentialSeconds / seconds, "x"});
+    }
+}
+
+bool BenchmarkCommon::WriteResultsJson(const BenchmarkResults& results, const std::string& path)
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    file << "{\"benchmarks\":[\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchmarkMetric& metric = results[i];
+        file << Stringf("{\"case\":\"%s\",\"metric\":\"%s\",\"value\":%.9g,\"unit\":\"%s\"}%s\n", metric.m_case.c_str(), metric.m_metric.c_str(),
+                        metric.m_value, metric.m_unit.c_str(), i + 1 < results.size() ? "," : "");
+    }
+    file << "]}\n";
+    return true;
+}
+
+bool BenchmarkCommon::ReadResultsJson(const std::string& path, BenchmarkResults& outResults)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    std::string text = stream.str();
+
+    // Only what WriteResultsJson produces, one flat object per metric
+    size_t from = text.find("\"benchmarks\"");
+    while (from != std::string::npos)
+    {
+        size_t begin = text.find('{', from + 1);
+        size_t end   = begin == std::string::npos ? std::string::npos : text.find('}', begin);
+        if (end == std::string::npos)
+        {
+            break;
+        }
+        BenchmarkMetric metric;
+        std::string     value;
+        if (ReadJsonField(text, begin, end, "case", metric.m_case) && ReadJsonField(text, begin, end, "metric", metric.m_metric) &&
+            ReadJsonField(text, begin, end, "value", value))
+        {
+            ReadJsonField(text, begin, end, "unit", metric.m_unit);
+            metric.m_value = atof(value.c_str());
+            outResults.push_back(metric);
+        }
+        from = end;
+    }
+    return !outResults.empty();
+}
+
+int BenchmarkCommon::GetMetricDirection(const std::string& unit)
+{
+    if (unit.empty())
+    {
+        return 0;
+    }
+    if (unit == "x" || unit == "%" || (unit.size() > 2 && unit.compare(unit.size() - 2, 2, "/s") == 0))
+    {
+        return 1;
+    }
+    return -1;
+}
+
+/**
+ * Runs in-process micro benchmarks and prints every metric to the DevConsole.
+ *
+ * @param args "name" of the benchmark to run, "all" runs every registered benchmark. "out" writes the results as JSON,
+ *             "baseline" compares them against an earlier JSON within "tolerance" percent (default 10).
+ * @return Returns false if the benchmark name is unknown, a file could not be written or read, or a metric regressed.
+ */
+bool BenchmarkCommon::Command_Benchmark(EventArgs& args)
+{
+    std::string name = Common::ToUpper(ChessMatchCommon::GetCommandArgValue(args, "name", "all"));
+
+    BenchmarkResults results;
+    bool             found  = false;
+    int              failed = 0;
+    for (const BenchmarkEntry& entry : BENCHMARKS)
+    {
+        if (name == "ALL" || name == Common::ToUpper(entry.m_name))
+        {
+            size_t metricCount = results.size();
+            entry.m_func(results);
+            found = true;
+            if (results.size() == metricCount) // Every benchmark reports a metric once it ran, a gate must not pass without it
+            {
+                g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Benchmark %s could not run", entry.m_name));
+                failed++;
+            }
+        }
+    }
+
+    if (!found)
+    {
+        std::string available;
+        for (const BenchmarkEntry& entry : BENCHMARKS)
+        {
+            available += std::string(" ") + entry.m_name;
+        }
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Unknown benchmark, available: all" + available);
+        return false;
+    }
+
+    for (const BenchmarkMetric& metric : results)
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR,
+                                 Stringf("%-24s %-20s %14.3f %s", metric.m_case.c_str(), metric.m_metric.c_str(), metric.m_value, metric.m_unit.c_str()));
+    }
+
+    std::string outPath = ChessMatchCommon::GetCommandArgValue(args, "out", "");
+    if (!outPath.empty() && !WriteResultsJson(results, outPath))
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Fail to write benchmark results to %s", outPath.c_str()));
+        return false;
+    }
+
+    std::string baselinePath = ChessMatchCommon::GetCommandArgValue(args, "baseline", "");
+    if (baselinePath.empty())
+    {
+        return failed == 0;
+    }
+    BenchmarkResults baseline;
+    if (!ReadResultsJson(baselinePath, baseline))
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Fail to read benchmark baseline %s", baselinePath.c_str()));
+        return false;
+    }
+
+    double tolerance   = atof(ChessMatchCommon::GetCommandArgValue(args, "tolerance", "10").c_str()) * 0.01;
+    int    compared    = 0;
+    int    regressions = 0;
+    for (const BenchmarkMetric& metric : results)
+    {
+        int direction = GetMetricDirection(metric.m_unit);
+        if (direction == 0) continue;
+
+        auto baselineMetric = std::find_if(baseline.begin(), baseline.end(), [&metric](const BenchmarkMetric& base)
+        {
+            return base.m_case == metric.m_case && base.m_metric == metric.m_metric;
+        });
+        if (baselineMetric == baseline.end()) continue;
+
+        // A zero baseline is only kept by counts that must stay zero, e.g. allocations per tick
+        bool regressed = direction < 0 ? metric.m_value > baselineMetric->m_value * (1.0 + tolerance) : metric.m_value < baselineMetric->m_value * (1.0 - tolerance);
+        compared++;
+        if (regressed)
+        {
+            regressions++;
+            g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Regression %s %s %.3f -> %.3f %s", metric.m_case.c_str(), metric.m_metric.c_str(),
+                                                                      baselineMetric->m_value, metric.m_value, metric.m_unit.c_str()));
+        }
+    }
+    g_theDevConsole->AddLine(regressions > 0 ? DevConsole::COLOR_ERROR : DevConsole::COLOR_INFO_LOG,
+                             Stringf("Benchmark baseline %s: %d metrics compared, %d regressed beyond %.0f%%", baselinePath.c_str(), compared, regressions,
+                                     tolerance * 100.0));
+    return regressions == 0 && failed == 0;
+}
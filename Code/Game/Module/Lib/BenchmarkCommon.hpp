@@ -0,0 +1,87 @@
+﻿#pragma once
+#include <string>
+#include <vector>
+
+#include "Engine/Core/EventSystem.hpp"
+
+namespace BenchmarkCommon
+{
+    struct BenchmarkMetric
+    {
+        std::string m_case; // e.g. "compression/snapshot"
+        std::string m_metric; // e.g. "encodeMBps"
+        double      m_value = 0.0;
+        std::string m_unit;
+    };
+
+    using BenchmarkResults = std::vector<BenchmarkMetric>;
+    using BenchmarkFunc    = void (*)(BenchmarkResults& results); // Pushes no metric when it cannot run, which fails the run
+
+    double GetTimeSeconds();
+
+    /// One metric per line so baselines diff well, {"benchmarks":[{"case":..,"metric":..,"value":..,"unit":..}]}
+    bool WriteResultsJson(const BenchmarkResults& results, const std::string& path);
+    bool ReadResultsJson(const std::string& path, BenchmarkResults& outResults);
+
+    /// -1 lower is better (time, bytes, allocations), +1 higher is better (throughput, speedup), 0 informational
+    int GetMetricDirection(const std::string& unit);
+
+    /// Calls func repeatedly until minSeconds elapsed and at least minIterations ran.
+    /// @return the average seconds per call.
+    template <typename Func>
+    double MeasureSecondsPerCall(Func&& func, double minSeconds = 0.1, int minIterations = 8)
+    {
+        func(); // Warm up caches and reusable buffers
+        int    iterations   = 0;
+        double startSeconds = GetTimeSeconds();
+        double elapsed      = 0.0;
+        while (iterations < minIterations || elapsed < minSeconds)
+        {
+            func();
+            ++iterations;
+            elapsed = GetTimeSeconds() - startSeconds;
+        }
+        return elapsed / static_cast<double>(iterations);
+    }
+
+    /// Actor::Tick over flat and parented actors without components, with the allocations per tick.
+    void Benchmark_ActorTick(BenchmarkResults& results);
+    /// PieceAnimationSystem::Update of 4096 running slides and jumps, the scalar pass against the SSE one.
+    void Benchmark_Animation(BenchmarkResults& results);
+    /// Setup and teardown of a 32 piece match worth of actors and components, from the heap and from an ObjectArena.
+    void Benchmark_Arena(BenchmarkResults& results);
+    /// dynamic_cast against ActorCast over mixed actors, and the render submission component check both ways.
+    void Benchmark_Casts(BenchmarkResults& results);
+    /// Actor::GetComponent and HasComponent on actors holding 1 to 16 component types.
+    void Benchmark_Components(BenchmarkResults& results);
+    /// MessageCodec encode and decode of move, snapshot, PGN and analysis messages, wire size against time per saved byte.
+    void Benchmark_Compression(BenchmarkResults& results);
+    /// EntityRegistry collision boxes at replay scene scale, the per frame refresh and a ray against every box.
+    void Benchmark_Entities(BenchmarkResults& results);
+    /// One highlight event per frame, by name through the EventSystem against a typed EventChannel, plain and edge triggered.
+    void Benchmark_Events(BenchmarkResults& results);
+    /// NetworkDispatcher framing of ChessMove messages over a loopback link, whole reads and 7 byte slices.
+    void Benchmark_Framing(BenchmarkResults& results);
+    /// Actor::Tick of 4096 animated actors, sequential against JobSystem::ParallelFor with 1 to every hardware thread.
+    void Benchmark_Jobs(BenchmarkResults& results);
+    /// Match setup piece placement with LogGame enabled, disabled at runtime and stripped at compile time.
+    void Benchmark_Logging(BenchmarkResults& results);
+    /// BakedModel::Build of every model, MeshComponent::SetModel and the GPU upload of the result.
+    void Benchmark_Models(BenchmarkResults& results);
+    /// Move validation, ChessRules::Evaluate of every from / to pair of the starting position in the match config.
+    void Benchmark_Moves(BenchmarkResults& results);
+    /// ChessMove argument parsing over the example script, legacy per-key rescans against CommandArgs.
+    void Benchmark_Parsing(BenchmarkResults& results);
+    /// Rays at every square over the board, 32 pieces and up to 16384 props, every box tested against a PickingGrid.
+    void Benchmark_Picking(BenchmarkResults& results);
+    /// Ray against box throughput of AABB3::Raycast and every AABB3Packets kernel, one ray against 4096 boxes and back.
+    void Benchmark_RayBox(BenchmarkResults& results);
+    /// ChessMatch::Raycast from a camera above the board to every square, on a match of its own built from the match config.
+    void Benchmark_Raycast(BenchmarkResults& results);
+    /// World matrices of 2048 parented pairs with a sixteenth moving per frame, rebuilt per call against a TransformPool.
+    void Benchmark_Transforms(BenchmarkResults& results);
+
+    /// Runs the benchmark named by "name=", or every benchmark with "name=all", and prints the metrics.
+    /// "out=" writes them as JSON, "baseline=" compares against an earlier JSON and fails on regressions.
+    bool Command_Benchmark(EventArgs& args);
+}
@@ -1,6 +1,8 @@
 ﻿#include "ChessMatchCommon.hpp"
 
+#include <fstream>
 #include <regex>
+#include <thread>
 
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/NamedStrings.hpp"
@@ -9,10 +11,17 @@
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Player.hpp"
+#include "Game/Core/Network/NetworkDispatcher.hpp"
+#include "Game/Core/Network/NetworkSimulation.hpp"
 #include "Game/Module/Definition/ChessPieceDefinition.hpp"
+#include "Game/Module/Gameplay/CameraPresetRegistry.hpp"
 #include "Game/Module/Gameplay/ChessMatch.hpp"
 #include "Game/Module/Gameplay/ChessPiece.hpp"
 #include "Game/Module/Gameplay/ChessPlayer.hpp"
+#include "Game/Module/Gameplay/ChessScriptRunner.hpp"
+#include "Game/Module/Lib/BenchmarkCommon.hpp"
+#include "Game/Module/Lib/CommandArgs.hpp"
+#include "Game/Module/Lib/ScriptFile.hpp"
 
 IntVec2 ChessMatchCommon::GetGridPosition(std::string strPos)
 {
@@ -55,7 +64,7 @@ Faction* ChessMatchCommon::GetFaction(int fromID, ChessMatch* match)
     return nullptr;
 }
 
-Mat44 ChessMatchCommon::GetCameraTransform(ECameraState state, Vec3& position, EulerAngles& rotation, ChessMatch* match, std::string configValue)
+Mat44 ChessMatchCommon::GetCameraTransform(ECameraState state, Vec3& position, EulerAngles& rotation, ChessMatch* match, const std::string& configValue)
 {
     Mat44 mat;
     if (g_theGame->cameraMode == ECameraMode::FREE)
@@ -77,24 +86,13 @@ Mat44 ChessMatchCommon::GetCameraTransform(ECameraState state, Vec3& position, E
         }
     case ECameraState::CONFIGURED:
         {
-            XmlElement*       root              = g_theGame->m_chessMatchConfig.RootElement();
-            const XmlElement* cameraPosElements = FindChildElementByName(*root, "CameraPositions");
-            const XmlElement* elementCameraPos  = cameraPosElements->FirstChildElement();
-            while (elementCameraPos != nullptr)
-            {
-                std::string strConfigValue = ParseXmlAttribute(*elementCameraPos, "name", std::string("INVALID"));
-                if (strConfigValue == configValue)
-                {
-                    position = ParseXmlAttribute(*elementCameraPos, "position", Vec3(0, 0, 0));
-                    rotation = EulerAngles(ParseXmlAttribute(*elementCameraPos, "orientation", Vec3(0, 0, 0)));
-                    mat.AppendTranslation3D(position);
-                    mat.Append(rotation.GetAsMatrix_IFwd_JLeft_KUp());
-                    return mat;
-                }
-                elementCameraPos = elementCameraPos->NextSiblingElement();
-            }
+            const CameraPreset* preset = CameraPresetRegistry::GetByName(configValue);
+            if (!preset)
+                return mat;
+            position = preset->m_position;
+            rotation = preset->m_orientation;
+            return preset->m_transform;
         }
-        break;
     }
     return mat;
 }
@@ -105,7 +103,7 @@ bool ChessMatchCommon::GetAllPieces(ChessGrid& grid, std::vector<ChessPiece*>& p
     {
         for (Actor* actor : actors)
         {
-            auto piece = dynamic_cast<ChessPiece*>(actor);
+            auto piece = ActorCast<ChessPiece>(actor);
             if (piece != nullptr)
                 pieces.push_back(piece);
         }
@@ -162,7 +160,7 @@ void ChessMatchCommon::PrintChessGrid(ChessGrid& grid)
         std::string line = std::to_string(i + 1) + "|";
         for (int j = 0; j < static_cast<int>(grid[i].size()); j++)
         {
-            auto        chessPiece = dynamic_cast<ChessPiece*>(grid[j][i]);
+            auto        chessPiece = ActorCast<ChessPiece>(grid[j][i]);
             std::string gly;
             if (chessPiece)
             {
@@ -182,36 +180,32 @@ void ChessMatchCommon::PrintChessGrid(ChessGrid& grid)
 
 int ChessMatchCommon::GetCommandArgsWith(EventArgs& inArgs, std::string key, std::pair<std::string, std::string>& pair, std::string& outMessage, char split)
 {
-    std::string arg = inArgs.GetValue("args", std::string(""));
-    if (arg == "")
+    CommandArgs commandArgs(inArgs, split);
+    return GetCommandArgsWith(commandArgs, key, pair, outMessage);
+}
+
+int ChessMatchCommon::GetCommandArgsWith(const CommandArgs& inArgs, std::string_view key, std::pair<std::string, std::string>& pair, std::string& outMessage)
+{
+    int index = inArgs.IndexOf(key);
+    if (inArgs.IsEmpty() || (inArgs.GetFirstInvalidIndex() != -1 && (index == -1 || inArgs.GetFirstInvalidIndex() < index)))
     {
         outMessage = "Invalid args,the correct usage is > ChessMove from=<> to=<> promoteTo=<>";
         return -1;
     }
-    Strings args = SplitStringOnDelimiter(arg, ' ');
-    if (args.size() == 0)
+    if (index == -1)
     {
-        outMessage = "Invalid args,the correct usage is > ChessMove from=<> to=<> promoteTo=<>";
+        outMessage = "Unknown args";
         return -1;
     }
-    // we search the key value
-    for (int i = 0; i < static_cast<int>(args.size()); i++)
-    {
-        Strings keyValue = SplitStringOnDelimiter(args[i], split);
-        if (keyValue.size() != 2)
-        {
-            outMessage = "Invalid args,the correct usage is > ChessMove from=<> to=<> promoteTo=<>";
-            return -1;
-        }
-        if (Common::ToUpper(keyValue[0]) == Common::ToUpper(key))
-        {
-            pair.first  = Common::ToUpper(keyValue[0]);
-            pair.second = Common::ToUpper(keyValue[1]);
-            return i;
-        }
-    }
-    outMessage = "Unknown args";
-    return -1;
+    pair.first  = Common::ToUpper(std::string(key));
+    pair.second = Common::ToUpper(std::string(inArgs.Get(key)));
+    return index;
+}
+
+std::string ChessMatchCommon::GetCommandArgValue(EventArgs& inArgs, const std::string& key, const std::string& defaultValue, char split)
+{
+    CommandArgs commandArgs(inArgs, split);
+    return std::string(commandArgs.Get(key, defaultValue));
 }
 
 bool ChessMatchCommon::GetCommandHasValidSubArgs(EventArgs& inArgs, Strings& validSubArgs)
@@ -279,17 +273,19 @@ bool ChessMatchCommon::Command_RemoteCmd(EventArgs& args)
     std::regex  re("cmd=", std::regex_constants::icase);
     arg = std::regex_replace(arg, re, "");
 
-    if (g_theNetworkSubsystem->GetClientState() == ClientState::CONNECTED)
+    // Send through the dispatcher so the traffic shows up in ChessNetStats
+    NetworkDispatcher* dispatcher = g_theGame->m_dispatcher;
+    if (dispatcher->IsConnectedAsClient())
     {
-        g_theNetworkSubsystem->SendStringToServer(arg);
+        dispatcher->SendToRemote(arg);
         g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG,
                                  "Command sent to server: " + arg);
         return true;
     }
 
-    if (g_theNetworkSubsystem->GetServerState() == ServerState::LISTENING)
+    if (dispatcher->IsRunningAsServer())
     {
-        g_theNetworkSubsystem->BroadcastStringToClients(arg);
+        dispatcher->SendToRemote(arg);
         g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG,
                                  "Command broadcasted to clients: " + arg);
         return true;
@@ -561,10 +557,11 @@ bool ChessMatchCommon::Command_ChessMove(EventArgs& args)
         return false;
     }
 
-    std::string arg = args.GetValue("args", std::string(""));
+    /// Tokenize once, every key below is a lookup into the same pairs
+    CommandArgs commandArgs(args);
 
     /// Syntax Checking
-    if (arg == "")
+    if (commandArgs.IsEmpty())
     {
         g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, errorInvalidArgs);
         return true;
@@ -574,15 +571,15 @@ bool ChessMatchCommon::Command_ChessMove(EventArgs& args)
 
     /// Parse remote parameter to check if this is a remote command
     std::pair<std::string, std::string> remote;
-    bool                                isRemoteCommand = (GetCommandArgsWith(args, "remote", remote, outMessage) != -1) &&
+    bool                                isRemoteCommand = (GetCommandArgsWith(commandArgs, "remote", remote, outMessage) != -1) &&
         IsTrueString(remote.second);
 
     /// Parse movement parameters
     std::pair<std::string, std::string> fromPair;
     std::pair<std::string, std::string> toPair;
 
-    int fromResult = GetCommandArgsWith(args, "from", fromPair, outMessage);
-    int toResult   = GetCommandArgsWith(args, "to", toPair, outMessage);
+    int fromResult = GetCommandArgsWith(commandArgs, "from", fromPair, outMessage);
+    int toResult   = GetCommandArgsWith(commandArgs, "to", toPair, outMessage);
 
     if (fromResult == -1 || toResult == -1)
     {
@@ -592,12 +589,12 @@ bool ChessMatchCommon::Command_ChessMove(EventArgs& args)
 
     /// Parse teleport parameter
     std::pair<std::string, std::string> teleportPair;
-    bool                                isTeleportMove = (GetCommandArgsWith(args, "teleport", teleportPair, outMessage) != -1) &&
+    bool                                isTeleportMove = (GetCommandArgsWith(commandArgs, "teleport", teleportPair, outMessage) != -1) &&
         IsTrueString(teleportPair.second);
 
     /// Parse promotion parameter
     std::pair<std::string, std::string> promotionPair;
-    int                                 promotionResult = GetCommandArgsWith(args, "promoteTo", promotionPair, outMessage);
+    int                                 promotionResult = GetCommandArgsWith(commandArgs, "promoteTo", promotionPair, outMessage);
     bool                                hasPromotion    = (promotionResult != -1);
 
     if (hasPromotion)
@@ -1137,6 +1134,191 @@ bool ChessMatchCommon::Command_ChessDisconnect(EventArgs& args)
     return true;
 }
 
+/**
+ * Prints the metrics collected by the NetworkDispatcher: per-connection RTT from ChessPing / ChessPong, move delivery
+ * latency percentiles, bytes and messages per second, message parse time and the time spent in ExecuteRemoteCmd.
+ *
+ * @param args Optional "format=json" prints the machine-readable dump, "file=<path>" writes the dump to a file and
+ *             "reset=true" clears every collected value.
+ * @return Returns false if the dump could not be written, true otherwise.
+ */
+bool ChessMatchCommon::Command_ChessNetStats(EventArgs& args)
+{
+    std::string                         outMessage;
+    std::pair<std::string, std::string> format;
+    std::pair<std::string, std::string> reset;
+    GetCommandArgsWith(args, "format", format, outMessage);
+    GetCommandArgsWith(args, "reset", reset, outMessage);
+
+    NetworkMetrics& metrics = g_theGame->m_dispatcher->GetMetrics();
+
+    if (IsTrueString(reset.second))
+    {
+        metrics.Reset();
+        g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG, "Network metrics reset");
+        return true;
+    }
+
+    std::string filePath = GetCommandArgValue(args, "file");
+    if (!filePath.empty())
+    {
+        std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Fail to write network metrics to %s", filePath.c_str()));
+            return false;
+        }
+        file << metrics.ToJson() << "\n";
+        g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG, Stringf("Network metrics written to %s", filePath.c_str()));
+        return true;
+    }
+
+    if (format.second == "JSON")
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, metrics.ToJson());
+        return true;
+    }
+
+    g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, metrics.ToText());
+    return true;
+}
+
+/**
+ * Runs a scripted match between one server and several client NetworkDispatchers over an in-process loopback network.
+ * Every script line is sent in turn by the server and the clients, the receivers verify the framing and order of what
+ * they get while the link injects latency, jitter, loss, reordering and partial reads.
+ *
+ * @param args Optional keys: "script" path of the script (Data/Scripts/chess_example.js), "clients" client count,
+ *             "repeat" times the script is replayed, "rate" lines per sender per frame, "latency" and "jitter" in
+ *             milliseconds, "loss" and "reorder" chances in [0, 1], "chunk" max bytes per read (0 reads everything), "seed" and
+ *             "compress" to send every line through the payload codec.
+ * @return Returns false if the script could not be loaded or the framing was broken.
+ */
+bool ChessMatchCommon::Command_ChessNetSim(EventArgs& args)
+{
+    std::string              scriptPath = GetCommandArgValue(args, "script", "Data/Scripts/chess_example.js");
+    std::vector<std::string> scriptLines;
+    if (!LoadScriptLines(scriptPath, scriptLines) || scriptLines.empty())
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Fail to load network simulation script %s", scriptPath.c_str()));
+        return false;
+    }
+
+    NetworkSimulationConfig config;
+    config.m_clientCount           = atoi(GetCommandArgValue(args, "clients", "1").c_str());
+    config.m_repeat                = atoi(GetCommandArgValue(args, "repeat", "50").c_str());
+    config.m_messagesPerFrame      = atoi(GetCommandArgValue(args, "rate", "1").c_str());
+    config.m_link.m_latencySeconds = atof(GetCommandArgValue(args, "latency", "0").c_str()) / 1000.0;
+    config.m_link.m_jitterSeconds  = atof(GetCommandArgValue(args, "jitter", "0").c_str()) / 1000.0;
+    config.m_link.m_lossChance     = static_cast<float>(atof(GetCommandArgValue(args, "loss", "0").c_str()));
+    config.m_link.m_reorderChance  = static_cast<float>(atof(GetCommandArgValue(args, "reorder", "0").c_str()));
+    config.m_link.m_maxReadBytes   = static_cast<size_t>(atoi(GetCommandArgValue(args, "chunk", "0").c_str()));
+    config.m_link.m_seed           = static_cast<uint32_t>(atoi(GetCommandArgValue(args, "seed", "1").c_str()));
+    config.m_compress              = Common::ToUpper(GetCommandArgValue(args, "compress", "false")) == "TRUE";
+
+    NetworkSimulationResult result = NetworkSimulation::Run(config, scriptLines);
+    g_theDevConsole->AddLine(result.IsFramingIntact() ? DevConsole::COLOR_INFO_LOG : DevConsole::COLOR_ERROR,
+                             Stringf("Network simulation of %s, %d clients, %zu lines x %d", scriptPath.c_str(), config.m_clientCount, scriptLines.size(), config.m_repeat));
+    g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, result.ToText());
+    return result.IsFramingIntact();
+}
+
+/**
+ * Compiles chess command scripts into typed move operations and runs them. Headless runs replay every script against a
+ * snapshot of the configured starting position on worker threads, live runs feed the moves into the active match.
+ *
+ * @param args Optional keys: "script" comma separated script paths (Data/Scripts/chess_example.js), "mode" headless or
+ *             live, "threads" worker count for headless runs, "repeat" headless replays per script, "board" true to
+ *             print the final board of every script.
+ * @return Returns false if a script could not be loaded or live mode has no match to play in.
+ */
+bool ChessMatchCommon::Command_ChessScript(EventArgs& args)
+{
+    CommandArgs commandArgs(args);
+    Strings     scriptPaths = SplitStringOnDelimiter(std::string(commandArgs.Get("script", "Data/Scripts/chess_example.js")), ',');
+    bool        isLive      = CommandArgs::EqualsIgnoreCase(commandArgs.Get("mode", "headless"), "live");
+    int         repeat      = atoi(std::string(commandArgs.Get("repeat", "1")).c_str());
+    int         threadCount = atoi(std::string(commandArgs.Get("threads", "0")).c_str());
+    bool        printBoard  = commandArgs.GetBool("board", scriptPaths.size() == 1);
+    if (threadCount <= 0)
+    {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+
+    double                   compileStart = BenchmarkCommon::GetTimeSeconds();
+    std::vector<ChessScript> scripts(scriptPaths.size());
+    for (int i = 0; i < static_cast<int>(scriptPaths.size()); ++i)
+    {
+        if (!ChessScriptRunner::Compile(scriptPaths[i], scripts[i]))
+        {
+            g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Fail to load chess script %s", scriptPaths[i].c_str()));
+            return false;
+        }
+        for (const std::string& error : scripts[i].m_errors)
+        {
+            g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, Stringf("%s %s", scriptPaths[i].c_str(), error.c_str()));
+        }
+    }
+    double compileSeconds = BenchmarkCommon::GetTimeSeconds() - compileStart;
+
+    if (isLive)
+    {
+        if (g_theGame->gameState != EGameState::MATCH || !g_theGame->match)
+        {
+            g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, "ChessScript mode=live can only be used when in Match");
+            return false;
+        }
+        for (const ChessScript& script : scripts)
+        {
+            int applied = ChessScriptRunner::RunLive(script, g_theGame->match);
+            g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG, Stringf("%s applied %d / %zu moves", script.m_path.c_str(), applied, script.m_ops.size()));
+        }
+        return true;
+    }
+
+    XmlElement* root = g_theGame->m_chessMatchConfig.RootElement();
+    if (!root)
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "ChessScript needs Data/ChessMatchConfig.xml for the starting position");
+        return false;
+    }
+    ChessBoardState initialState = ChessBoardState::FromMatchConfig(*root);
+
+    double                         runStart = BenchmarkCommon::GetTimeSeconds();
+    std::vector<ChessScriptResult> results  = ChessScriptRunner::RunParallel(scripts, initialState, repeat, threadCount);
+    double                         runWall  = BenchmarkCommon::GetTimeSeconds() - runStart;
+
+    size_t totalOps = 0;
+    for (int i = 0; i < static_cast<int>(results.size()); ++i)
+    {
+        const ChessScriptResult& result = results[i];
+        totalOps += scripts[i].m_ops.size() * static_cast<size_t>(result.m_repeat);
+        g_theDevConsole->AddLine(result.m_opsRejected == 0 ? DevConsole::COLOR_INFO_LOG : DevConsole::COLOR_WARNING,
+                                 Stringf("%s ops %zu applied %d rejected %d x%d %.3f us/run final %s", result.m_path.c_str(), scripts[i].m_ops.size(),
+                                         result.m_opsApplied, result.m_opsRejected, result.m_repeat, result.GetSecondsPerRun() * 1e6, result.m_finalState.ToLine().c_str()));
+        for (const std::string& rejection : result.m_rejections)
+        {
+            g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, "    " + rejection);
+        }
+        if (result.m_steadyAllocations > 0)
+        {
+            g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, Stringf("%s allocated %llu times after the first run", result.m_path.c_str(),
+                                                                        static_cast<unsigned long long>(result.m_steadyAllocations)));
+        }
+        if (printBoard)
+        {
+            for (const std::string& line : SplitStringOnDelimiter(result.m_finalState.ToText(), '\n'))
+            {
+                g_theDevConsole->AddLine(Rgba8::ORANGE, line);
+            }
+        }
+    }
+    g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG,
+                             Stringf("%zu scripts on %d threads, compile %.3f ms, run %.3f ms, %.0f ops/s", scripts.size(), threadCount, compileSeconds * 1e3, runWall * 1e3,
+                                     runWall > 0.0 ? static_cast<double>(totalOps) / runWall : 0.0));
+    return true;
+}
+
 bool ChessMatchCommon::SendRemoteCommand(const std::string& command)
 {
     if (!g_theNetworkSubsystem)
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
@@ -12,6 +13,7 @@
 #include "Engine/Math/Vec3.hpp"
 
 class ChessPlayer;
+class CommandArgs;
 class ChessObject;
 class ChessPiece;
 enum class ECameraState;
@@ -121,11 +123,19 @@ namespace ChessMatchCommon
         float m_rayMaxLength = 1.f;
     };
 
+    /// Payload of EEventChannel::HIGHLIGHT_CHANGED, an INVALID square turns the highlight off
+    struct HighlightChangedEvent
+    {
+        IntVec2 m_square = IntVec2::INVALID;
+
+        bool operator==(const HighlightChangedEvent& other) const { return m_square == other.m_square; }
+    };
+
 
     [[nodiscard]] IntVec2  GetGridPosition(std::string strPos);
     [[nodiscard]] bool     GetStringPositionValidation(std::string strPos);
     [[nodiscard]] Faction* GetFaction(int fromID, ChessMatch* match);
-    Mat44                  GetCameraTransform(ECameraState state, Vec3& position, EulerAngles& rotation, ChessMatch* match, std::string configValue = "above");
+    Mat44                  GetCameraTransform(ECameraState state, Vec3& position, EulerAngles& rotation, ChessMatch* match, const std::string& configValue = "above");
     bool                   GetAllPieces(ChessGrid& grid, std::vector<ChessPiece*>& pieces);
     [[nodiscard]] bool     GetChessMoveValid(MoveResult result);
     void                   PrintChessGrid(ChessGrid& grid);
@@ -137,6 +147,10 @@ namespace ChessMatchCommon
     /// @param split the split Delimiter.
     /// @return -1 if not find the key in args, return the index valid kay value pairs in the Event args.
     int  GetCommandArgsWith(EventArgs& inArgs, std::string key, std::pair<std::string, std::string>& pair, std::string& outMessage, char split = '=');
+    /// Same as above over args that were already tokenized once, handlers reading several keys should parse a CommandArgs first.
+    int  GetCommandArgsWith(const CommandArgs& inArgs, std::string_view key, std::pair<std::string, std::string>& pair, std::string& outMessage);
+    /// Same lookup as GetCommandArgsWith but the value keeps its case, e.g. for file paths.
+    std::string GetCommandArgValue(EventArgs& inArgs, const std::string& key, const std::string& defaultValue = "", char split = '=');
     bool GetCommandHasValidSubArgs(EventArgs& inArgs, Strings& validSubArgs);
     int  GetCommandStringsWith(Strings& inStrings, std::string key, std::pair<std::string, std::string>& pair, std::string& outMessage, char split = '=');
     bool IsTrueString(std::string& inString);
@@ -150,6 +164,9 @@ namespace ChessMatchCommon
     bool Command_ChessListen(EventArgs& args);
     bool Command_ChessConnect(EventArgs& args);
     bool Command_ChessDisconnect(EventArgs& args);
+    bool Command_ChessNetStats(EventArgs& args);
+    bool Command_ChessNetSim(EventArgs& args);
+    bool Command_ChessScript(EventArgs& args);
 
     [[maybe_unused]] bool SendRemoteCommand(const std::string& command);
 
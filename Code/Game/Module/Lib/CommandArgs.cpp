@@ -0,0 +1,102 @@
+﻿#include "CommandArgs.hpp"
+
+CommandArgs::CommandArgs(EventArgs& args, char split)
+    : m_source(args.GetValue("args", std::string("")))
+{
+    Tokenize(split);
+}
+
+CommandArgs::CommandArgs(std::string_view args, char split)
+    : m_source(args)
+{
+    Tokenize(split);
+}
+
+int CommandArgs::IndexOf(std::string_view key) const
+{
+    for (int i = 0; i < m_count; ++i)
+    {
+        if (EqualsIgnoreCase(m_pairs[i].m_key, key))
+        {
+            return m_pairs[i].m_tokenIndex;
+        }
+    }
+    return -1;
+}
+
+std::string_view CommandArgs::Get(std::string_view key, std::string_view defaultValue) const
+{
+    for (int i = 0; i < m_count; ++i)
+    {
+        if (EqualsIgnoreCase(m_pairs[i].m_key, key))
+        {
+            return m_pairs[i].m_value;
+        }
+    }
+    return defaultValue;
+}
+
+bool CommandArgs::GetBool(std::string_view key, bool defaultValue) const
+{
+    int index = -1;
+    for (int i = 0; i < m_count; ++i)
+    {
+        if (EqualsIgnoreCase(m_pairs[i].m_key, key))
+        {
+            index = i;
+            break;
+        }
+    }
+    return index == -1 ? defaultValue : EqualsIgnoreCase(m_pairs[index].m_value, "true");
+}
+
+bool CommandArgs::EqualsIgnoreCase(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        char left  = a[i];
+        char right = b[i];
+        if (left >= 'a' && left <= 'z') left = static_cast<char>(left - 'a' + 'A');
+        if (right >= 'a' && right <= 'z') right = static_cast<char>(right - 'a' + 'A');
+        if (left != right) return false;
+    }
+    return true;
+}
+
+void CommandArgs::Tokenize(char split)
+{
+    if (m_source.empty())
+    {
+        return;
+    }
+
+    std::string_view source(m_source);
+    size_t           tokenStart = 0;
+    for (int tokenIndex = 0;; ++tokenIndex)
+    {
+        size_t           tokenEnd = source.find(' ', tokenStart);
+        std::string_view token    = source.substr(tokenStart, tokenEnd == std::string_view::npos ? std::string_view::npos : tokenEnd - tokenStart);
+
+        // Exactly one split char, anything else is what GetCommandArgsWith reports as malformed
+        size_t splitPos = token.find(split);
+        if (splitPos == std::string_view::npos || token.find(split, splitPos + 1) != std::string_view::npos)
+        {
+            if (m_firstInvalid == -1) m_firstInvalid = tokenIndex;
+        }
+        else if (m_count < MAX_PAIRS)
+        {
+            Pair& pair        = m_pairs[m_count++];
+            pair.m_key        = token.substr(0, splitPos);
+            pair.m_value      = token.substr(splitPos + 1);
+            pair.m_tokenIndex = tokenIndex;
+        }
+        else
+        {
+            m_overflow = true;
+        }
+
+        if (tokenEnd == std::string_view::npos) break;
+        tokenStart = tokenEnd + 1;
+    }
+}
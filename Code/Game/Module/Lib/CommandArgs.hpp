@@ -0,0 +1,53 @@
+﻿#pragma once
+#include <string>
+#include <string_view>
+
+#include "Engine/Core/EventSystem.hpp"
+
+/// CommandArgs ― One pass tokenizer of a DevConsole "args" string into a small flat map of key=value views.
+///
+/// Tokens are split on single spaces and the split char, exactly like GetCommandArgsWith, but only once per command;
+/// every handler lookup afterward is a case-insensitive scan over at most MAX_PAIRS views. Values keep their case.
+class CommandArgs
+{
+public:
+    static constexpr int MAX_PAIRS = 16;
+
+    explicit CommandArgs(EventArgs& args, char split = '=');
+    explicit CommandArgs(std::string_view args, char split = '=');
+
+    CommandArgs(const CommandArgs&)            = delete; // The views point into m_source
+    CommandArgs& operator=(const CommandArgs&) = delete;
+
+    bool IsEmpty() const { return m_count == 0 && m_firstInvalid == -1; }
+    bool IsValid() const { return m_firstInvalid == -1 && !m_overflow; } // Every token was a single key=value pair
+    int  GetFirstInvalidIndex() const { return m_firstInvalid; } // Token index of the first malformed token, -1 if none
+
+    /// Token index of the key, -1 if not found
+    int              IndexOf(std::string_view key) const;
+    bool             Has(std::string_view key) const { return IndexOf(key) != -1; }
+    std::string_view Get(std::string_view key, std::string_view defaultValue = std::string_view()) const;
+    bool             GetBool(std::string_view key, bool defaultValue = false) const; // "true" in any case
+
+    int              GetCount() const { return m_count; }
+    std::string_view GetKey(int pairIndex) const { return m_pairs[pairIndex].m_key; }
+    std::string_view GetValue(int pairIndex) const { return m_pairs[pairIndex].m_value; }
+
+    static bool EqualsIgnoreCase(std::string_view a, std::string_view b);
+
+private:
+    struct Pair
+    {
+        std::string_view m_key;
+        std::string_view m_value;
+        int              m_tokenIndex = 0;
+    };
+
+    std::string m_source;
+    Pair        m_pairs[MAX_PAIRS];
+    int         m_count        = 0;
+    int         m_firstInvalid = -1;
+    bool        m_overflow     = false;
+
+    void Tokenize(char split);
+};
@@ -1,10 +1,20 @@
 ﻿#include "DebugCommon.hpp"
 
+#include <fstream>
+
 #include "ChessMatchCommon.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/Core/AllocationTracker.hpp"
+#include "Game/Core/LogBinaryFile.hpp"
+#include "Game/Core/LoggerSubsystem.hpp"
+#include "Game/Core/ProfilerSubsystem.hpp"
+#include "Game/Core/WidgetSubsystem.hpp"
+#include "Game/Module/Debug/WidgetPerformanceHUD.hpp"
+#include "Game/Module/Gameplay/ChessMatch.hpp"
 
 bool DebugCommon::Command_Debug(EventArgs& args)
 {
@@ -59,3 +69,169 @@ bool DebugCommon::Command_Debug(EventArgs& args)
     g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, "Invalid Debug Subcommand");
     return false;
 }
+
+/**
+ * Decodes a binary log written with the "binaryLogPath" game config back into text or JSON lines.
+ *
+ * @param args "file=<path>" of the binary log, optional "format=json" renders one JSON object per record,
+ *             "out=<path>" writes the result to a file, otherwise the last "limit=" lines (default 200) are printed.
+ * @return Returns false if the log could not be decoded or written.
+ */
+bool DebugCommon::Command_LogDecode(EventArgs& args)
+{
+    std::string filePath = ChessMatchCommon::GetCommandArgValue(args, "file");
+    if (filePath.empty())
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, "Usage: LogDecode file=<path> format=text|json out=<path> limit=<lines>");
+        return false;
+    }
+    ELogDecodeFormat format = Common::ToUpper(ChessMatchCommon::GetCommandArgValue(args, "format", "text")) == "JSON" ? ELogDecodeFormat::JSON : ELogDecodeFormat::TEXT;
+
+    g_theLoggerSubsystem->Flush(); // The active log may still have records in flight
+    std::string decoded;
+    std::string error;
+    bool        success = DecodeLogBinary(filePath, format, decoded, error);
+    if (!success)
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("LogDecode: %s", error.c_str()));
+        if (decoded.empty()) return false;
+    }
+
+    std::string outPath = ChessMatchCommon::GetCommandArgValue(args, "out");
+    if (!outPath.empty())
+    {
+        std::ofstream file(outPath, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file.is_open())
+        {
+            g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Fail to write decoded log to %s", outPath.c_str()));
+            return false;
+        }
+        file << decoded;
+        g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG, Stringf("Decoded log written to %s", outPath.c_str()));
+        return success;
+    }
+
+    Strings lines = SplitStringOnDelimiter(decoded, '\n');
+    if (!lines.empty() && lines.back().empty()) lines.pop_back();
+    int limit = atoi(ChessMatchCommon::GetCommandArgValue(args, "limit", "200").c_str());
+    int first = limit > 0 && static_cast<int>(lines.size()) > limit ? static_cast<int>(lines.size()) - limit : 0;
+    for (int i = first; i < static_cast<int>(lines.size()); ++i)
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, lines[i]);
+    }
+    g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG, Stringf("LogDecode: %d records from %s", static_cast<int>(lines.size()), filePath.c_str()));
+    return success;
+}
+
+/**
+ * Records every PROFILE_SCOPE zone of the next frames and writes them as a Chrome trace_event JSON file,
+ * open it in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * @param args Optional "frames=<count>" (default 60) and "file=<path>" (default ProfileCapture.json).
+ * @return Returns false if a capture is already running or the arguments are invalid.
+ */
+bool DebugCommon::Command_ProfileCapture(EventArgs& args)
+{
+    int         frames   = atoi(ChessMatchCommon::GetCommandArgValue(args, "frames", "60").c_str());
+    std::string filePath = ChessMatchCommon::GetCommandArgValue(args, "file", "ProfileCapture.json");
+    if (g_theProfilerSubsystem->IsCaptureRequested())
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, "A profile capture is already running");
+        return false;
+    }
+    if (!g_theProfilerSubsystem->RequestCapture(frames, filePath))
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Usage: ProfileCapture frames=<count> file=<path.json>");
+        return false;
+    }
+    g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG, Stringf("Capturing %d frames to %s", frames, filePath.c_str()));
+    return true;
+}
+
+/**
+ * Shows or hides the performance HUD, the widget is created the first time it is shown.
+ *
+ * @param args Optional "visible=true|false", toggles when omitted.
+ * @return Returns true once the HUD visibility was changed.
+ */
+bool DebugCommon::Command_PerfHUD(EventArgs& args)
+{
+    std::vector<Widget*> widgets = g_theWidgetSubsystem->GetViewportWidgets("WidgetPerformanceHUD");
+    Widget*              hud     = widgets.empty() ? nullptr : widgets.front();
+    bool                 visible = hud == nullptr || !hud->GetIsVisible();
+    visible                      = ChessMatchCommon::GetCommandArgValue(args, "visible", visible ? "true" : "false") == "true";
+
+    if (hud == nullptr)
+    {
+        if (!visible)
+        {
+            return true;
+        }
+        hud = new WidgetPerformanceHUD();
+        g_theWidgetSubsystem->AddToViewport(hud, 100);
+    }
+    hud->SetVisibility(visible);
+    g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG, Stringf("Performance HUD %s", visible ? "shown" : "hidden"));
+    return true;
+}
+
+/**
+ * Switches the global allocation tracker and prints the allocations of the last frame, with the call stacks that
+ * allocated most when tracking call sites.
+ *
+ * @param args Optional "track=off|count|sites" to change the mode first and "top=<count>" call sites to print (default 10).
+ * @return Returns false if the track mode is unknown.
+ */
+bool DebugCommon::Command_AllocStats(EventArgs& args)
+{
+    std::string track = ChessMatchCommon::GetCommandArgValue(args, "track", "");
+    int         top   = atoi(ChessMatchCommon::GetCommandArgValue(args, "top", "10").c_str());
+    if (!track.empty())
+    {
+        if (track == "off") AllocationTracker::SetMode(EAllocationTrackMode::OFF);
+        else if (track == "count") AllocationTracker::SetMode(EAllocationTrackMode::COUNT);
+        else if (track == "sites") AllocationTracker::SetMode(EAllocationTrackMode::CALL_SITES);
+        else
+        {
+            g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Usage: AllocStats track=off|count|sites top=<count>");
+            return false;
+        }
+        g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG, Stringf("Allocation tracking %s, stats start with the next frame", track.c_str()));
+        return true;
+    }
+
+    if (AllocationTracker::GetMode() == EAllocationTrackMode::OFF)
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, "Allocation tracking is off, enable it with AllocStats track=count or track=sites");
+        return true;
+    }
+    const AllocationFrameStats& frame = AllocationTracker::GetLastFrameStats();
+    AllocationFrameStats        total = AllocationTracker::GetTotalStats();
+    g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG, Stringf("Last frame: %llu allocs, %llu frees, %llu bytes", static_cast<unsigned long long>(frame.m_allocs),
+                                                                 static_cast<unsigned long long>(frame.m_frees), static_cast<unsigned long long>(frame.m_bytes)));
+    g_theDevConsole->AddLine(DevConsole::COLOR_INFO_LOG, Stringf("Total: %llu allocs, %llu frees, %llu bytes", static_cast<unsigned long long>(total.m_allocs),
+                                                                 static_cast<unsigned long long>(total.m_frees), static_cast<unsigned long long>(total.m_bytes)));
+    if (g_theGame->match)
+    {
+        uint64_t updateAllocations = g_theGame->match->m_updateAllocations;
+        g_theDevConsole->AddLine(updateAllocations == 0 ? DevConsole::COLOR_INFO_LOG : DevConsole::COLOR_WARNING,
+                                 Stringf("ChessMatch::Update: %llu allocs", static_cast<unsigned long long>(updateAllocations)));
+    }
+
+    if (AllocationTracker::GetMode() != EAllocationTrackMode::CALL_SITES)
+    {
+        return true;
+    }
+    std::vector<AllocationSite> sites;
+    AllocationTracker::GetLastFrameTopSites(top, sites);
+    for (const AllocationSite& site : sites)
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf("%8llu allocs %10llu bytes  %s", static_cast<unsigned long long>(site.m_allocs),
+                                                                       static_cast<unsigned long long>(site.m_bytes), AllocationTracker::DescribeSite(site).c_str()));
+    }
+    if (AllocationTracker::GetDroppedSiteCount() > 0)
+    {
+        g_theDevConsole->AddLine(DevConsole::COLOR_WARNING, Stringf("%llu allocations found no call site slot", static_cast<unsigned long long>(AllocationTracker::GetDroppedSiteCount())));
+    }
+    return true;
+}
@@ -4,4 +4,8 @@
 namespace DebugCommon
 {
     bool Command_Debug(EventArgs& args);
+    bool Command_LogDecode(EventArgs& args);
+    bool Command_ProfileCapture(EventArgs& args);
+    bool Command_PerfHUD(EventArgs& args);
+    bool Command_AllocStats(EventArgs& args);
 }
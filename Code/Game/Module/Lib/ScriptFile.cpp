@@ -0,0 +1,25 @@
+﻿#include "ScriptFile.hpp"
+
+#include <fstream>
+
+bool LoadScriptLines(const std::string& path, std::vector<std::string>& outLines)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        size_t first = line.find_first_not_of(" \t\r");
+        size_t last  = line.find_last_not_of(" \t\r");
+        if (first == std::string::npos) continue;
+
+        line = line.substr(first, last - first + 1);
+        if (line.compare(0, 2, "//") == 0) continue;
+        outLines.push_back(line);
+    }
+    return true;
+}
@@ -0,0 +1,7 @@
+﻿#pragma once
+#include <string>
+#include <vector>
+
+/// Appends the lines of a text script to outLines, trimmed, without blank lines and // comments. False if the file
+/// cannot be opened. Shared by the ChessScriptRunner and the NetworkSimulation, which both read chess_example.js.
+bool LoadScriptLines(const std::string& path, std::vector<std::string>& outLines);
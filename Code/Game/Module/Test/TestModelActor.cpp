@@ -8,6 +8,11 @@
 #include "Game/Core/Component/MeshComponent.hpp"
 #include "Game/Core/Component/CollisionComponent.hpp"
 
+TestModelActor::TestModelActor()
+{
+    AddKind(KIND);
+}
+
 TestModelActor::~TestModelActor()
 {
 }
@@ -8,6 +8,9 @@ class MeshComponent;
 class TestModelActor : public Actor
 {
 public:
+    static constexpr EActorKind KIND = EActorKind::TEST_MODEL;
+
+    TestModelActor();
     ~TestModelActor() override;
     void        Initialize() override;
     void        OnTick(float deltaTime) override;